@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// fragmentShader.glsl
+// ============
+// color the scene mesh fragments with textures, materials and lights
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+// number of texture arrays - must match TexturePool::MAX_TEXTURE_ARRAYS
+#define MAX_TEXTURE_ARRAYS 16
+// number of materials - must match MaterialBuffer::MAX_MATERIALS
+#define MAX_MATERIALS 256
+
+struct Material
+{
+	vec3 ambientColor;
+	float ambientStrength;
+	vec3 diffuseColor;
+	vec3 specularColor;
+	float shininess;
+};
+
+// the members are ordered to pack into the std430 layout of
+// LightManager::GPU_LIGHT
+struct LightSource
+{
+	vec3 position;
+	float focalStrength;
+	vec3 ambientColor;
+	float specularIntensity;
+	vec3 diffuseColor;
+	vec3 specularColor;
+};
+
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+in vec2 fragmentTextureCoordinate;
+flat in vec4 fragmentObjectColor;
+// packed texture array and layer, or -1 for no texture
+flat in int fragmentTextureIndex;
+flat in int fragmentMaterialIndex;
+
+out vec4 outFragmentColor;
+
+uniform bool bUseLighting = false;
+uniform vec3 viewPosition;
+uniform vec2 UVscale = vec2(1.0f, 1.0f);
+
+// every scene texture is one layer of one of the texture arrays,
+// selected by the array index in the high 16 bits and the layer
+// in the low 16 bits
+uniform sampler2DArray textureArrays[MAX_TEXTURE_ARRAYS];
+
+// every scene material, uploaded once and selected for each
+// object by its material index
+layout(std140, binding = 0) uniform MaterialBlock
+{
+	Material materials[MAX_MATERIALS];
+};
+
+// every scene light, with the number of lights in use
+layout(std430, binding = 1) readonly buffer LightBlock
+{
+	int lightCount;
+	LightSource lightSources[];
+};
+
+vec3 CalculateLightSource(LightSource light, Material material, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection);
+vec4 SampleObjectTexture(vec2 textureCoordinate);
+
+void main()
+{
+	vec4 surfaceColor = fragmentObjectColor;
+
+	if (fragmentTextureIndex >= 0)
+	{
+		surfaceColor = SampleObjectTexture(fragmentTextureCoordinate * UVscale);
+	}
+
+	if (bUseLighting == true)
+	{
+		vec3 lightNormal = normalize(fragmentVertexNormal);
+		vec3 viewDirection = normalize(viewPosition - fragmentPosition);
+		vec3 phongResult = vec3(0.0f);
+		Material material = materials[fragmentMaterialIndex];
+
+		for (int i = 0; i < lightCount; i++)
+		{
+			phongResult += CalculateLightSource(lightSources[i], material, lightNormal, fragmentPosition, viewDirection);
+		}
+
+		outFragmentColor = vec4(phongResult * surfaceColor.xyz, surfaceColor.w);
+	}
+	else
+	{
+		outFragmentColor = surfaceColor;
+	}
+}
+
+vec4 SampleObjectTexture(vec2 textureCoordinate)
+{
+	int arrayIndex = (fragmentTextureIndex >> 16) & 0xFFFF;
+	int layer = fragmentTextureIndex & 0xFFFF;
+	vec3 arrayCoordinate = vec3(textureCoordinate, float(layer));
+	vec4 textureColor = vec4(1.0f);
+
+	// instances of one draw can use different arrays, so the array
+	// index is not dynamically uniform and cannot select a sampler -
+	// the loop index can, and the gradients are taken outside the
+	// branch so that mipmapping still works
+	vec2 gradientX = dFdx(textureCoordinate);
+	vec2 gradientY = dFdy(textureCoordinate);
+	for (int i = 0; i < MAX_TEXTURE_ARRAYS; i++)
+	{
+		if (i == arrayIndex)
+		{
+			textureColor = textureGrad(textureArrays[i], arrayCoordinate, gradientX, gradientY);
+		}
+	}
+
+	return textureColor;
+}
+
+vec3 CalculateLightSource(LightSource light, Material material, vec3 lightNormal, vec3 vertexPosition, vec3 viewDirection)
+{
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+
+	// ambient lighting
+	ambient = light.ambientColor * material.ambientColor * material.ambientStrength;
+
+	// diffuse lighting
+	vec3 lightDirection = normalize(light.position - vertexPosition);
+	float impact = max(dot(lightNormal, lightDirection), 0.0);
+	diffuse = impact * light.diffuseColor * material.diffuseColor;
+
+	// specular lighting
+	vec3 reflectDirection = reflect(-lightDirection, lightNormal);
+	float specularComponent = pow(max(dot(viewDirection, reflectDirection), 0.0), light.focalStrength);
+	specular = light.specularIntensity * specularComponent * light.specularColor * material.specularColor;
+
+	return ambient + diffuse + specular;
+}
@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+// vertexShader.glsl
+// ============
+// transform the scene mesh vertices into clip space
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+#version 440 core
+
+// gives multi-draw commands the index of the draw, which selects
+// the object values from the draw data buffer
+#extension GL_ARB_shader_draw_parameters : enable
+
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec3 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+
+// per-instance values of instanced draws, which every draw uses
+// unless it reads the draw data buffer - the model matrix takes
+// locations 3 to 6
+layout (location = 3) in mat4 instanceModel;
+layout (location = 7) in vec4 instanceColor;
+layout (location = 8) in int instanceTextureIndex;
+layout (location = 9) in int instanceMaterialIndex;
+
+// the object values of every draw of a multi-draw, laid out like
+// SceneMeshes::INSTANCE_DATA
+struct DrawData
+{
+	mat4 model;
+	vec4 color;
+	int textureIndex;
+	int materialIndex;
+};
+
+layout(std430, binding = 2) readonly buffer DrawDataBlock
+{
+	DrawData drawData[];
+};
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+flat out vec4 fragmentObjectColor;
+flat out int fragmentTextureIndex;
+flat out int fragmentMaterialIndex;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+// when set, the object values come from the draw data buffer at
+// the index of the draw instead of the instance attributes - only
+// set when the draw index is there
+uniform bool bUseDrawData = false;
+
+void main()
+{
+	mat4 objectModel;
+
+#ifdef GL_ARB_shader_draw_parameters
+	if (bUseDrawData == true)
+	{
+		DrawData objectData = drawData[gl_DrawIDARB];
+		objectModel = objectData.model;
+		fragmentObjectColor = objectData.color;
+		fragmentTextureIndex = objectData.textureIndex;
+		fragmentMaterialIndex = objectData.materialIndex;
+	}
+	else
+#endif
+	{
+		objectModel = instanceModel;
+		fragmentObjectColor = instanceColor;
+		fragmentTextureIndex = instanceTextureIndex;
+		fragmentMaterialIndex = instanceMaterialIndex;
+	}
+
+	// vertex position and normal in world space, for lighting
+	fragmentPosition = vec3(objectModel * vec4(inVertexPosition, 1.0));
+	fragmentVertexNormal = mat3(transpose(inverse(objectModel))) * inVertexNormal;
+	fragmentTextureCoordinate = inTextureCoordinate;
+
+	gl_Position = projection * view * objectModel * vec4(inVertexPosition, 1.0);
+}
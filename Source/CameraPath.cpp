@@ -0,0 +1,256 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerapath.cpp
+// ============
+// record the camera over time, and replay it for benchmarks
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "CameraPath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// declaration of global variables
+namespace
+{
+	/***********************************************************
+	 *  ReadVec3()
+	 *
+	 *  This function is used for reading three values from a
+	 *  line of a path file.
+	 ***********************************************************/
+	bool ReadVec3(std::istringstream& line, glm::vec3& value)
+	{
+		return((line >> value.x) && (line >> value.y) && (line >> value.z));
+	}
+
+	/***********************************************************
+	 *  BlendDirection()
+	 *
+	 *  This function is used for blending two directions, which
+	 *  keeps the result a unit vector.
+	 ***********************************************************/
+	glm::vec3 BlendDirection(const glm::vec3& first, const glm::vec3& second, float amount)
+	{
+		glm::vec3 direction = glm::mix(first, second, amount);
+		float length = glm::length(direction);
+
+		return((length > 0.0f) ? direction / length : first);
+	}
+}
+
+/***********************************************************
+ *  CameraPath()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+CameraPath::CameraPath()
+{
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method is used for loading a path from a file.  Every
+ *  line that is wrong is reported, and the path is left empty
+ *  when there are any.
+ ***********************************************************/
+bool CameraPath::Load(const std::string& path)
+{
+	m_samples.clear();
+
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cout << "ERROR: The camera path could not be opened: " << path << std::endl;
+		return(false);
+	}
+
+	bool bReturn = true;
+	std::string lineText;
+	int lineNumber = 0;
+
+	while (std::getline(file, lineText))
+	{
+		lineNumber++;
+
+		// drop the comment, if there is one
+		size_t comment = lineText.find('#');
+		if (comment != std::string::npos)
+		{
+			lineText.erase(comment);
+		}
+
+		std::istringstream line(lineText);
+		std::string keyword;
+		if (!(line >> keyword))
+		{
+			continue;
+		}
+
+		if (keyword != "sample")
+		{
+			std::cout << path << "(" << lineNumber << "): unknown entry:" << keyword << std::endl;
+			bReturn = false;
+			continue;
+		}
+
+		CAMERA_SAMPLE sample;
+		std::string extra;
+		bool bValid = (line >> sample.time) &&
+			ReadVec3(line, sample.position) &&
+			ReadVec3(line, sample.front) &&
+			ReadVec3(line, sample.up) &&
+			(line >> sample.zoom) &&
+			(line >> sample.keys) &&
+			(line >> sample.mouseOffset.x) &&
+			(line >> sample.mouseOffset.y);
+		if ((bValid == false) || (line >> extra))
+		{
+			std::cout << path << "(" << lineNumber << "): wrong number of values for " << keyword << std::endl;
+			bReturn = false;
+			continue;
+		}
+		if (!m_samples.empty() && (sample.time < m_samples.back().time))
+		{
+			std::cout << path << "(" << lineNumber << "): sample time goes back" << std::endl;
+			bReturn = false;
+			continue;
+		}
+
+		m_samples.push_back(sample);
+	}
+
+	if (m_samples.empty())
+	{
+		std::cout << "ERROR: The camera path has no samples: " << path << std::endl;
+		bReturn = false;
+	}
+	if (bReturn == false)
+	{
+		m_samples.clear();
+	}
+
+	return(bReturn);
+}
+
+/***********************************************************
+ *  Save()
+ *
+ *  This method is used for saving the path to a file, in the
+ *  format that Load() reads.
+ ***********************************************************/
+bool CameraPath::Save(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (!file)
+	{
+		std::cout << "ERROR: The camera path could not be written: " << path << std::endl;
+		return(false);
+	}
+
+	file << "# camera path\n"
+		<< "#   sample <time> <position x y z> <front x y z> <up x y z> <zoom> <keys> <mouse x y>\n";
+	file << std::fixed;
+	for (size_t i = 0; i < m_samples.size(); i++)
+	{
+		const CAMERA_SAMPLE& sample = m_samples[i];
+
+		file << std::setprecision(4) << "sample " << sample.time
+			<< std::setprecision(5)
+			<< "  " << sample.position.x << " " << sample.position.y << " " << sample.position.z
+			<< "  " << sample.front.x << " " << sample.front.y << " " << sample.front.z
+			<< "  " << sample.up.x << " " << sample.up.y << " " << sample.up.z
+			<< std::setprecision(3)
+			<< "  " << sample.zoom
+			<< "  " << sample.keys
+			<< "  " << sample.mouseOffset.x << " " << sample.mouseOffset.y << "\n";
+	}
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  GetFrameCount()
+ *
+ *  This method is used for getting the number of frames that
+ *  replaying the path takes at a fixed time step, from the
+ *  first sample to the last one.
+ ***********************************************************/
+int CameraPath::GetFrameCount(float timestep) const
+{
+	if (m_samples.empty() || (timestep <= 0.0f))
+	{
+		return(0);
+	}
+
+	return((int)std::floor(GetDuration() / timestep) + 1);
+}
+
+/***********************************************************
+ *  GetCamera()
+ *
+ *  This method is used for getting the camera at a time.  The
+ *  position, directions and zoom are blended between the
+ *  samples on either side, while the keys and mouse movement
+ *  are those of the sample before.  Times outside of the
+ *  path get its first or last sample.
+ ***********************************************************/
+CameraPath::CAMERA_SAMPLE CameraPath::GetCamera(float time) const
+{
+	CAMERA_SAMPLE camera = {};
+
+	if (m_samples.empty())
+	{
+		return(camera);
+	}
+
+	// the first sample that is later than the time
+	std::vector<CAMERA_SAMPLE>::const_iterator next = std::upper_bound(
+		m_samples.begin(), m_samples.end(), time,
+		[](float value, const CAMERA_SAMPLE& sample) { return value < sample.time; });
+
+	if (next == m_samples.begin())
+	{
+		return(m_samples.front());
+	}
+	if (next == m_samples.end())
+	{
+		return(m_samples.back());
+	}
+
+	const CAMERA_SAMPLE& first = *(next - 1);
+	const CAMERA_SAMPLE& second = *next;
+	float span = second.time - first.time;
+	float amount = (span > 0.0f) ? (time - first.time) / span : 0.0f;
+
+	camera = BlendCamera(first, second, amount);
+	camera.time = time;
+
+	return(camera);
+}
+
+/***********************************************************
+ *  BlendCamera()
+ *
+ *  This method is used for blending the position, directions
+ *  and zoom of one camera into those of another, by an
+ *  amount from zero to one.  The time, keys and mouse
+ *  movement are those of the first camera.
+ ***********************************************************/
+CameraPath::CAMERA_SAMPLE CameraPath::BlendCamera(const CAMERA_SAMPLE& first, const CAMERA_SAMPLE& second, float amount)
+{
+	CAMERA_SAMPLE camera = first;
+
+	camera.position = glm::mix(first.position, second.position, amount);
+	camera.front = BlendDirection(first.front, second.front, amount);
+	camera.up = BlendDirection(first.up, second.up, amount);
+	camera.zoom = first.zoom + (second.zoom - first.zoom) * amount;
+
+	return(camera);
+}
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// camerapath.h
+// ============
+// record the camera over time, and replay it for benchmarks
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  CameraPath
+ *
+ *  This class holds the camera samples of a flight through
+ *  the scene, each with the time it was taken, the camera's
+ *  position, direction and zoom, and the keys and mouse
+ *  movement that moved the camera there.  Paths are saved as
+ *  text files, one sample per line, and the camera at any
+ *  time is found by blending the samples on either side of
+ *  it, so that a path can be replayed at any frame rate.
+ *
+ *  A path file has one entry per line, and # starts a
+ *  comment:
+ *
+ *    sample <time> <position x y z> <front x y z> <up x y z>
+ *           <zoom> <keys> <mouse x y>
+ *
+ *  The times are in seconds and must not go down, and the
+ *  keys are the KEY_FLAGS that were held down.
+ ***********************************************************/
+class CameraPath
+{
+public:
+	// constructor
+	CameraPath();
+
+	// the camera keys held down during a sample
+	enum KEY_FLAGS
+	{
+		KEY_FORWARD = 1 << 0,
+		KEY_BACKWARD = 1 << 1,
+		KEY_LEFT = 1 << 2,
+		KEY_RIGHT = 1 << 3,
+		KEY_UP = 1 << 4,
+		KEY_DOWN = 1 << 5
+	};
+
+	struct CAMERA_SAMPLE
+	{
+		float time;
+		glm::vec3 position;
+		glm::vec3 front;
+		glm::vec3 up;
+		float zoom;
+		uint32_t keys;
+		glm::vec2 mouseOffset;
+	};
+
+	// load the path from a file, replacing its samples
+	bool Load(const std::string& path);
+	// save the path to a file
+	bool Save(const std::string& path) const;
+
+	// remove all of the samples
+	void Clear() { m_samples.clear(); }
+	// add a sample, after the ones already in the path
+	void AddSample(const CAMERA_SAMPLE& sample) { m_samples.push_back(sample); }
+
+	// get the samples
+	const std::vector<CAMERA_SAMPLE>& GetSamples() const { return m_samples; }
+	// get the time of the last sample
+	float GetDuration() const { return m_samples.empty() ? 0.0f : m_samples.back().time; }
+	// get the number of frames that replaying the path takes
+	int GetFrameCount(float timestep) const;
+
+	// get the camera at a time, blended from the samples around it
+	CAMERA_SAMPLE GetCamera(float time) const;
+	// blend the pose of one camera into the pose of another
+	static CAMERA_SAMPLE BlendCamera(const CAMERA_SAMPLE& first, const CAMERA_SAMPLE& second, float amount);
+
+private:
+	std::vector<CAMERA_SAMPLE> m_samples;
+};
@@ -0,0 +1,357 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.cpp
+// ============
+// pace the frames of the display window and measure their jitter
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FramePacer.h"
+
+#include "Profiler.h"
+
+#include "GLFW/glfw3.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+// declaration of global variables
+namespace
+{
+	// names of the pacing modes on the command line
+	const char* const MODE_NAMES[FramePacer::PACING_MODE_COUNT] = { "off", "vsync", "adaptive", "limit" };
+
+	// the spin before each limited frame starts at this, and never
+	// gets shorter than the shortest or longer than the longest
+	const std::chrono::microseconds INITIAL_SPIN_TIME(1000);
+	const std::chrono::microseconds MINIMUM_SPIN_TIME(200);
+	const std::chrono::microseconds MAXIMUM_SPIN_TIME(4000);
+
+	// a frame is late when it takes this many target frame times
+	const double LATE_FRAME_RATIO = 1.5;
+}
+
+/***********************************************************
+ *  FramePacer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FramePacer::FramePacer()
+{
+	m_mode = VSYNC_OFF;
+	m_targetFrameTime = CLOCK::duration::zero();
+	m_refreshMilliseconds = 0.0;
+	m_spinTime = INITIAL_SPIN_TIME;
+	m_bHasLastFrame = false;
+	m_bFineTimer = false;
+	m_bKeepStatistics = false;
+}
+
+/***********************************************************
+ *  ~FramePacer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FramePacer::~FramePacer()
+{
+	SetFineTimer(false);
+}
+
+/***********************************************************
+ *  ParseMode()
+ *
+ *  This method is used for getting a pacing mode from its
+ *  name.  It returns false when there is no such mode.
+ ***********************************************************/
+bool FramePacer::ParseMode(const char* name, PACING_MODE& mode)
+{
+	for (int i = 0; i < PACING_MODE_COUNT; i++)
+	{
+		if (strcmp(name, MODE_NAMES[i]) == 0)
+		{
+			mode = (PACING_MODE)i;
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  GetModeName()
+ *
+ *  This method is used for getting the name of a pacing
+ *  mode, as it is passed in on the command line.
+ ***********************************************************/
+const char* FramePacer::GetModeName(PACING_MODE mode)
+{
+	if ((mode < 0) || (mode >= PACING_MODE_COUNT))
+	{
+		return("unknown");
+	}
+
+	return(MODE_NAMES[mode]);
+}
+
+/***********************************************************
+ *  SetMode()
+ *
+ *  This method is used for setting the swap interval of the
+ *  current context for a pacing mode.  Adaptive vsync is a
+ *  negative interval, which only the swap control tear
+ *  extensions allow, so without them vsync is used.  The
+ *  frame times kept so far are removed.
+ ***********************************************************/
+void FramePacer::SetMode(PACING_MODE mode, int targetFramesPerSecond)
+{
+	if ((ADAPTIVE_VSYNC == mode) &&
+		!glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+		!glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+	{
+		std::cout << "INFO: Adaptive vsync is not supported, vsync is used instead" << std::endl;
+		mode = VSYNC_ON;
+	}
+
+	switch (mode)
+	{
+	case VSYNC_ON:
+		glfwSwapInterval(1);
+		break;
+	case ADAPTIVE_VSYNC:
+		glfwSwapInterval(-1);
+		break;
+	default:
+		glfwSwapInterval(0);
+		break;
+	}
+	m_mode = mode;
+
+	m_targetFrameTime = std::chrono::duration_cast<CLOCK::duration>(
+		std::chrono::duration<double>(1.0 / (double)std::max(targetFramesPerSecond, 1)));
+
+	// vsync paces to the refresh rate of the display, which is
+	// taken from the main monitor, where the window opens
+	m_refreshMilliseconds = 0.0;
+	GLFWmonitor* pMonitor = glfwGetPrimaryMonitor();
+	if (NULL != pMonitor)
+	{
+		const GLFWvidmode* pVideoMode = glfwGetVideoMode(pMonitor);
+		if ((NULL != pVideoMode) && (pVideoMode->refreshRate > 0))
+		{
+			m_refreshMilliseconds = 1000.0 / (double)pVideoMode->refreshRate;
+		}
+	}
+
+	SetFineTimer(FRAME_LIMITER == mode);
+
+	m_nextFrameTime = CLOCK::time_point();
+	m_spinTime = INITIAL_SPIN_TIME;
+	m_bHasLastFrame = false;
+	ResetStatistics();
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for ending a frame after its swap.
+ *  The limiter waits here for the next frame, so the time
+ *  between the ends of two frames is how long one was shown.
+ ***********************************************************/
+void FramePacer::EndFrame()
+{
+	if (FRAME_LIMITER == m_mode)
+	{
+		PROFILE_SCOPE("FrameLimiter");
+		WaitForNextFrame();
+	}
+
+	CLOCK::time_point frameEnd = CLOCK::now();
+	if (m_bHasLastFrame && m_bKeepStatistics)
+	{
+		m_frameIntervals.AddFrame(std::chrono::duration<double, std::milli>(frameEnd - m_lastFrameEnd).count());
+	}
+	m_lastFrameEnd = frameEnd;
+	m_bHasLastFrame = true;
+}
+
+/***********************************************************
+ *  WaitForNextFrame()
+ *
+ *  This method is used for waiting until the next frame of
+ *  the limiter.  The frames are one target frame time apart,
+ *  so a frame that wakes up a little late does not move the
+ *  ones after it, but after a frame that ran over by more
+ *  than that the frames are paced from it, instead of being
+ *  hurried to catch up.
+ *
+ *  Most of the wait is a sleep, which frees the core, and
+ *  the rest is a spin, which ends on time.  The spin gets
+ *  longer whenever a sleep wakes up late, and shorter again
+ *  slowly while they do not.
+ ***********************************************************/
+void FramePacer::WaitForNextFrame()
+{
+	CLOCK::time_point now = CLOCK::now();
+	m_nextFrameTime += m_targetFrameTime;
+
+	if (now >= m_nextFrameTime)
+	{
+		if (now - m_nextFrameTime > m_targetFrameTime)
+		{
+			m_nextFrameTime = now;
+		}
+		return;
+	}
+
+	CLOCK::time_point sleepEnd = m_nextFrameTime - m_spinTime;
+	if (now < sleepEnd)
+	{
+		std::this_thread::sleep_until(sleepEnd);
+
+		CLOCK::duration lateWakeUp = CLOCK::now() - sleepEnd;
+		if (lateWakeUp * 2 > m_spinTime)
+		{
+			m_spinTime = std::min<CLOCK::duration>(lateWakeUp * 2, MAXIMUM_SPIN_TIME);
+		}
+		else
+		{
+			m_spinTime = std::max<CLOCK::duration>(m_spinTime - m_spinTime / 100, MINIMUM_SPIN_TIME);
+		}
+	}
+
+	while (CLOCK::now() < m_nextFrameTime)
+	{
+		std::this_thread::yield();
+	}
+}
+
+/***********************************************************
+ *  SetFineTimer()
+ *
+ *  This method is used for asking Windows to wake sleeping
+ *  threads every millisecond, instead of every 15.6, while
+ *  the limiter runs.  Other systems already do.
+ ***********************************************************/
+void FramePacer::SetFineTimer(bool bFine)
+{
+	if (bFine == m_bFineTimer)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	if (bFine)
+	{
+		timeBeginPeriod(1);
+	}
+	else
+	{
+		timeEndPeriod(1);
+	}
+#endif
+	m_bFineTimer = bFine;
+}
+
+/***********************************************************
+ *  Summarize()
+ *
+ *  This method is used for summarizing the times between the
+ *  ends of the frames kept since the last reset, along with
+ *  their spread and the frames that were late.
+ ***********************************************************/
+FramePacer::JITTER_SUMMARY FramePacer::Summarize() const
+{
+	JITTER_SUMMARY summary;
+	summary.intervals = m_frameIntervals.Summarize();
+	summary.standardDeviationMilliseconds = 0.0;
+	summary.lateFrameCount = 0;
+
+	summary.targetMilliseconds = 0.0;
+	if (FRAME_LIMITER == m_mode)
+	{
+		summary.targetMilliseconds = std::chrono::duration<double, std::milli>(m_targetFrameTime).count();
+	}
+	else if (VSYNC_OFF != m_mode)
+	{
+		summary.targetMilliseconds = m_refreshMilliseconds;
+	}
+
+	const std::vector<double>& intervals = m_frameIntervals.GetFrames();
+	if (intervals.empty())
+	{
+		return(summary);
+	}
+
+	double squaredDeviations = 0.0;
+	for (size_t i = 0; i < intervals.size(); i++)
+	{
+		double deviation = intervals[i] - summary.intervals.meanMilliseconds;
+		squaredDeviations += deviation * deviation;
+
+		if ((summary.targetMilliseconds > 0.0) && (intervals[i] > summary.targetMilliseconds * LATE_FRAME_RATIO))
+		{
+			summary.lateFrameCount++;
+		}
+	}
+	summary.standardDeviationMilliseconds = std::sqrt(squaredDeviations / (double)intervals.size());
+
+	return(summary);
+}
+
+/***********************************************************
+ *  ResetStatistics()
+ *
+ *  This method is used for removing the kept frame times, so
+ *  the next summary only covers the frames after this.
+ ***********************************************************/
+void FramePacer::ResetStatistics()
+{
+	m_frameIntervals.Clear();
+}
+
+/***********************************************************
+ *  WriteLine()
+ *
+ *  This method is used for writing a summary of the frame
+ *  pacing as one line of text, with the times in
+ *  milliseconds.
+ ***********************************************************/
+void FramePacer::WriteLine(std::ostream& output) const
+{
+	JITTER_SUMMARY summary = Summarize();
+
+	std::ios::fmtflags flags = output.flags();
+	std::streamsize precision = output.precision();
+
+	output << std::fixed << std::setprecision(3)
+		<< "Pacing: " << GetModeName(m_mode)
+		<< ", frames: " << summary.intervals.frameCount
+		<< ", mean: " << summary.intervals.meanMilliseconds
+		<< ", jitter: " << summary.standardDeviationMilliseconds
+		<< ", p99: " << summary.intervals.percentile99Milliseconds
+		<< ", max: " << summary.intervals.maximumMilliseconds;
+	if (summary.targetMilliseconds > 0.0)
+	{
+		output << ", target: " << summary.targetMilliseconds
+			<< ", late: " << summary.lateFrameCount;
+	}
+	output << std::endl;
+
+	output.flags(flags);
+	output.precision(precision);
+}
@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.h
+// ============
+// pace the frames of the display window and measure their jitter
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameTimings.h"
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+/***********************************************************
+ *  FramePacer
+ *
+ *  This class decides when each frame of the display window
+ *  is shown.  With vsync the swap waits for the vertical
+ *  blank, adaptive vsync waits only for frames that are on
+ *  time and tears the late ones instead of halving the rate,
+ *  and with vsync off frames are shown as fast as they are
+ *  drawn.  The frame limiter turns vsync off and waits after
+ *  each swap until a target frame time has passed, sleeping
+ *  for most of the wait and spinning for the rest, since a
+ *  sleep alone wakes up too late.
+ *
+ *  The time between the ends of the frames can be kept, so
+ *  the jitter of the pacing can be reported.
+ ***********************************************************/
+class FramePacer
+{
+public:
+	// constructor
+	FramePacer();
+	// destructor
+	~FramePacer();
+
+	enum PACING_MODE
+	{
+		// show each frame as soon as it is drawn
+		VSYNC_OFF = 0,
+		// wait for the vertical blank before each swap
+		VSYNC_ON,
+		// wait for the vertical blank unless the frame is late
+		ADAPTIVE_VSYNC,
+		// show each frame at once, then wait for the target frame time
+		FRAME_LIMITER,
+		PACING_MODE_COUNT
+	};
+
+	struct JITTER_SUMMARY
+	{
+		// the times between the ends of the frames
+		FrameTimings::SUMMARY intervals;
+		// how far the times are spread around their mean
+		double standardDeviationMilliseconds;
+		// the frame time being paced to, or zero when unknown
+		double targetMilliseconds;
+		// frames that took over one and a half target frame times
+		size_t lateFrameCount;
+	};
+
+	// get the mode from its name on the command line, which fails
+	// for an unknown name
+	static bool ParseMode(const char* name, PACING_MODE& mode);
+	// get the name of a mode
+	static const char* GetModeName(PACING_MODE mode);
+
+	// set the mode and the frames per second the limiter keeps to,
+	// on the thread that has the window's context current
+	void SetMode(PACING_MODE mode, int targetFramesPerSecond);
+	// get the mode, which is vsync when adaptive vsync is missing
+	PACING_MODE GetMode() const { return m_mode; }
+
+	// called after each swap, to wait for the next frame when
+	// limiting and to keep the time of the frame
+	void EndFrame();
+
+	// keep the time of each frame, for the jitter summaries
+	void SetStatisticsEnabled(bool bEnabled) { m_bKeepStatistics = bEnabled; }
+	// summarize the frame times kept since the last reset
+	JITTER_SUMMARY Summarize() const;
+	// remove the kept frame times
+	void ResetStatistics();
+	// write a summary as one line of text
+	void WriteLine(std::ostream& output) const;
+
+private:
+	typedef std::chrono::steady_clock CLOCK;
+
+	PACING_MODE m_mode;
+	// the frame time the limiter keeps to
+	CLOCK::duration m_targetFrameTime;
+	// the frame time of the display, when vsync is on
+	double m_refreshMilliseconds;
+	// when the limiter shows the next frame
+	CLOCK::time_point m_nextFrameTime;
+	// how long before that the sleep ends and the spin starts,
+	// which grows when a sleep wakes up later than that
+	CLOCK::duration m_spinTime;
+	// when the last frame ended, if there has been one
+	CLOCK::time_point m_lastFrameEnd;
+	bool m_bHasLastFrame;
+	// true while the system timer runs at its finest resolution
+	bool m_bFineTimer;
+	// the times between the ends of the frames, when they are kept
+	bool m_bKeepStatistics;
+	FrameTimings m_frameIntervals;
+
+	// wait until the limiter shows the next frame
+	void WaitForNextFrame();
+	// ask for the finest resolution of the system timer, or
+	// give it back
+	void SetFineTimer(bool bFine);
+};
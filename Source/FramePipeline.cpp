@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepipeline.cpp
+// ============
+// build the next frame on a worker thread while this one is drawn
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FramePipeline.h"
+
+#include "Profiler.h"
+
+/***********************************************************
+ *  FramePipeline()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FramePipeline::FramePipeline()
+{
+	for (int i = 0; i < PACKET_COUNT; i++)
+	{
+		m_bPacketBuilt[i] = false;
+	}
+	m_nextSubmitFrame = 0;
+	m_bStopRequested = false;
+}
+
+/***********************************************************
+ *  ~FramePipeline()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FramePipeline::~FramePipeline()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for starting the worker thread, which
+ *  calls the build function for each frame, from frame zero
+ *  on.  Anything the build function reads or changes must
+ *  not be used by other threads while the pipeline runs.
+ ***********************************************************/
+void FramePipeline::Start(const BUILD_FUNCTION& buildFrame)
+{
+	Stop();
+
+	for (int i = 0; i < PACKET_COUNT; i++)
+	{
+		m_bPacketBuilt[i] = false;
+	}
+	m_nextSubmitFrame = 0;
+	m_bStopRequested = false;
+	m_buildFrame = buildFrame;
+
+	m_worker = std::thread(&FramePipeline::BuildWorker, this);
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping the worker thread.  A
+ *  frame that is being built is finished first, and the
+ *  frames that were built but not taken are dropped.
+ ***********************************************************/
+void FramePipeline::Stop()
+{
+	if (!m_worker.joinable())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopRequested = true;
+	}
+	m_packetReleased.notify_one();
+
+	m_worker.join();
+}
+
+/***********************************************************
+ *  AcquirePacket()
+ *
+ *  This method is used for taking the packet of the next
+ *  frame, waiting for the worker to finish building it.  It
+ *  returns NULL when the pipeline is not running.
+ ***********************************************************/
+FramePipeline::FRAME_PACKET* FramePipeline::AcquirePacket()
+{
+	if (!IsRunning())
+	{
+		return(NULL);
+	}
+
+	PROFILE_SCOPE("WaitForFramePacket");
+
+	int slot = (int)(m_nextSubmitFrame % PACKET_COUNT);
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_packetBuilt.wait(lock, [this, slot]() { return m_bPacketBuilt[slot]; });
+
+	return(&m_packets[slot]);
+}
+
+/***********************************************************
+ *  ReleasePacket()
+ *
+ *  This method is used for giving the taken packet back to
+ *  the worker, to build a later frame into.
+ ***********************************************************/
+void FramePipeline::ReleasePacket()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bPacketBuilt[m_nextSubmitFrame % PACKET_COUNT] = false;
+		m_nextSubmitFrame++;
+	}
+	m_packetReleased.notify_one();
+}
+
+/***********************************************************
+ *  BuildWorker()
+ *
+ *  This method runs on the worker thread.  It builds each
+ *  frame into the packet after the one built before, as soon
+ *  as that packet has been released, until it is stopped.
+ ***********************************************************/
+void FramePipeline::BuildWorker()
+{
+	Profiler::SetThreadName("Frame Builder");
+
+	uint64_t frameNumber = 0;
+	while (true)
+	{
+		int slot = (int)(frameNumber % PACKET_COUNT);
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_packetReleased.wait(lock, [this, slot]() { return m_bStopRequested || !m_bPacketBuilt[slot]; });
+			if (m_bStopRequested)
+			{
+				return;
+			}
+		}
+
+		FRAME_PACKET& packet = m_packets[slot];
+		packet.frameNumber = frameNumber;
+		{
+			PROFILE_SCOPE("BuildFrame");
+			m_buildFrame(packet);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_bPacketBuilt[slot] = true;
+		}
+		m_packetBuilt.notify_one();
+
+		frameNumber++;
+	}
+}
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepipeline.h
+// ============
+// build the next frame on a worker thread while this one is drawn
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneMeshes.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  FramePipeline
+ *
+ *  This class splits each frame into the work that needs no
+ *  OpenGL context, which runs on a worker thread, and the
+ *  OpenGL calls, which stay on the thread that owns the
+ *  context.  The worker moves the camera and the objects,
+ *  culls and sorts them, and gathers everything the frame
+ *  draws into a frame packet.  The OpenGL thread only takes
+ *  the built packets, in order, and submits them.
+ *
+ *  There are two packets, so the worker builds frame N+1
+ *  while frame N is submitted, and waits when it gets two
+ *  frames ahead.  A packet belongs to the worker until it
+ *  is built, and to the OpenGL thread from AcquirePacket()
+ *  until ReleasePacket(), so neither needs to lock it.
+ ***********************************************************/
+class FramePipeline
+{
+public:
+	// constructor
+	FramePipeline();
+	// destructor
+	~FramePipeline();
+
+	// one instanced draw of a run of instances that share a mesh
+	// and level of detail
+	struct DRAW_BATCH
+	{
+		SceneFile::MESH_TYPE mesh;
+		int level;
+		GLuint firstInstance;
+		GLsizei instanceCount;
+	};
+
+	// everything that one frame draws
+	struct FRAME_PACKET
+	{
+		// number of the frame, counted from zero at Start()
+		uint64_t frameNumber;
+		// camera the frame is drawn from
+		glm::mat4 viewMatrix;
+		glm::mat4 projectionMatrix;
+		glm::vec3 viewPosition;
+		// true once a replayed camera path has shown its last frame
+		bool bReplayFinished;
+		// instance data of the drawn objects, in sorted order, which
+		// holds texture handles until the packet is submitted, since
+		// where a streamed texture lives changes on the OpenGL thread
+		std::vector<SceneMeshes::INSTANCE_DATA> instances;
+		// true when the frame is drawn with one multi-draw indirect
+		// call, from the commands, instead of from the batches
+		bool bIndirectDrawing;
+		std::vector<DRAW_BATCH> drawBatches;
+		std::vector<SceneMeshes::DRAW_COMMAND> drawCommands;
+		// objects culled and drawn, and the triangles drawn
+		size_t culledCount;
+		size_t drawnCount;
+		size_t drawnTriangleCount;
+		// state changes of the sorted draws, and those sorting avoided
+		unsigned int stateChanges;
+		unsigned int avoidedStateChanges;
+	};
+
+	// fills in a packet on the worker thread
+	typedef std::function<void(FRAME_PACKET& packet)> BUILD_FUNCTION;
+
+	// start building frames on the worker thread
+	void Start(const BUILD_FUNCTION& buildFrame);
+	// stop the worker thread, dropping any frame built ahead
+	void Stop();
+	// check whether the worker thread is building frames
+	bool IsRunning() const { return m_worker.joinable(); }
+
+	// wait for the next frame to be built and take its packet
+	FRAME_PACKET* AcquirePacket();
+	// give the taken packet back, once it has been submitted
+	void ReleasePacket();
+
+private:
+	// number of packets that are built and submitted in turn
+	static const int PACKET_COUNT = 2;
+
+	FRAME_PACKET m_packets[PACKET_COUNT];
+	// true for the packets that are built and not yet released
+	bool m_bPacketBuilt[PACKET_COUNT];
+	// number of the next frame the OpenGL thread takes
+	uint64_t m_nextSubmitFrame;
+	// protects the built flags and the stop request
+	std::mutex m_mutex;
+	// signaled when a packet is built, and when one is released
+	std::condition_variable m_packetBuilt;
+	std::condition_variable m_packetReleased;
+	// set to stop the worker thread
+	bool m_bStopRequested;
+	// fills in the packets
+	BUILD_FUNCTION m_buildFrame;
+	// worker thread that builds the frames
+	std::thread m_worker;
+
+	// worker thread that builds each frame into the next free packet
+	void BuildWorker();
+};
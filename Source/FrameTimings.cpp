@@ -0,0 +1,158 @@
+///////////////////////////////////////////////////////////////////////////////
+// frametimings.cpp
+// ============
+// collect frame times and summarize them for benchmarks
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameTimings.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+// declaration of global variables
+namespace
+{
+	/***********************************************************
+	 *  GetSortedPercentile()
+	 *
+	 *  This function is used for getting the nearest-rank
+	 *  percentile of frame times that are already sorted.
+	 ***********************************************************/
+	double GetSortedPercentile(const std::vector<double>& sortedFrames, double percent)
+	{
+		if (sortedFrames.empty())
+		{
+			return(0.0);
+		}
+
+		double rank = std::ceil(percent / 100.0 * (double)sortedFrames.size());
+		size_t index = (size_t)std::max(rank, 1.0) - 1;
+
+		return(sortedFrames[std::min(index, sortedFrames.size() - 1)]);
+	}
+}
+
+/***********************************************************
+ *  FrameTimings()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameTimings::FrameTimings()
+{
+}
+
+/***********************************************************
+ *  Summarize()
+ *
+ *  This method is used for summarizing the frame times.  The
+ *  times are sorted in a copy, so they stay in the order
+ *  they were added.
+ ***********************************************************/
+FrameTimings::SUMMARY FrameTimings::Summarize() const
+{
+	SUMMARY summary;
+	summary.frameCount = m_frameMilliseconds.size();
+	summary.minimumMilliseconds = 0.0;
+	summary.meanMilliseconds = 0.0;
+	summary.medianMilliseconds = 0.0;
+	summary.percentile99Milliseconds = 0.0;
+	summary.maximumMilliseconds = 0.0;
+
+	if (m_frameMilliseconds.empty())
+	{
+		return(summary);
+	}
+
+	std::vector<double> sortedFrames(m_frameMilliseconds);
+	std::sort(sortedFrames.begin(), sortedFrames.end());
+
+	double totalMilliseconds = 0.0;
+	for (size_t i = 0; i < sortedFrames.size(); i++)
+	{
+		totalMilliseconds += sortedFrames[i];
+	}
+
+	summary.minimumMilliseconds = sortedFrames.front();
+	summary.meanMilliseconds = totalMilliseconds / (double)sortedFrames.size();
+	summary.medianMilliseconds = GetSortedPercentile(sortedFrames, 50.0);
+	summary.percentile99Milliseconds = GetSortedPercentile(sortedFrames, 99.0);
+	summary.maximumMilliseconds = sortedFrames.back();
+
+	return(summary);
+}
+
+/***********************************************************
+ *  GetPercentile()
+ *
+ *  This method is used for getting the frame time that the
+ *  passed in percentage of the frames are at or below.
+ ***********************************************************/
+double FrameTimings::GetPercentile(double percent) const
+{
+	std::vector<double> sortedFrames(m_frameMilliseconds);
+	std::sort(sortedFrames.begin(), sortedFrames.end());
+
+	return(GetSortedPercentile(sortedFrames, percent));
+}
+
+/***********************************************************
+ *  WriteSummary()
+ *
+ *  This method is used for writing a summary as one line of
+ *  JSON, with the times in milliseconds.
+ ***********************************************************/
+void FrameTimings::WriteSummary(std::ostream& output, const char* name, const SUMMARY& summary)
+{
+	std::ios::fmtflags flags = output.flags();
+	std::streamsize precision = output.precision();
+
+	output << std::fixed << std::setprecision(4)
+		<< "{\"name\": \"";
+	// the name is often a file path, whose separators and quotes
+	// have to be escaped
+	for (const char* character = name; *character != '\0'; character++)
+	{
+		if ((*character == '\\') || (*character == '"'))
+		{
+			output << '\\';
+		}
+		output << *character;
+	}
+	output << "\""
+		<< ", \"frames\": " << summary.frameCount
+		<< ", \"min_ms\": " << summary.minimumMilliseconds
+		<< ", \"mean_ms\": " << summary.meanMilliseconds
+		<< ", \"p50_ms\": " << summary.medianMilliseconds
+		<< ", \"p99_ms\": " << summary.percentile99Milliseconds
+		<< ", \"max_ms\": " << summary.maximumMilliseconds
+		<< "}" << std::endl;
+
+	output.flags(flags);
+	output.precision(precision);
+}
+
+/***********************************************************
+ *  WriteFrames()
+ *
+ *  This method is used for writing the time of every frame
+ *  in milliseconds, as comma separated values with a header
+ *  line.
+ ***********************************************************/
+void FrameTimings::WriteFrames(std::ostream& output) const
+{
+	std::ios::fmtflags flags = output.flags();
+	std::streamsize precision = output.precision();
+
+	output << "frame,milliseconds\n" << std::fixed << std::setprecision(4);
+	for (size_t i = 0; i < m_frameMilliseconds.size(); i++)
+	{
+		output << i << "," << m_frameMilliseconds[i] << "\n";
+	}
+	output.flush();
+
+	output.flags(flags);
+	output.precision(precision);
+}
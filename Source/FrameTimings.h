@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// frametimings.h
+// ============
+// collect frame times and summarize them for benchmarks
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+/***********************************************************
+ *  FrameTimings
+ *
+ *  This class collects the time of each frame of a run, in
+ *  milliseconds, and summarizes them as the minimum, mean,
+ *  median, 99th percentile and maximum.  The summary can be
+ *  written as a single line of JSON, so that scripts can
+ *  read the results of a benchmark run.
+ ***********************************************************/
+class FrameTimings
+{
+public:
+	// constructor
+	FrameTimings();
+
+	struct SUMMARY
+	{
+		size_t frameCount;
+		double minimumMilliseconds;
+		double meanMilliseconds;
+		double medianMilliseconds;
+		double percentile99Milliseconds;
+		double maximumMilliseconds;
+	};
+
+	// reserve room for a number of frames
+	void Reserve(size_t frameCount) { m_frameMilliseconds.reserve(frameCount); }
+	// remove all of the frame times
+	void Clear() { m_frameMilliseconds.clear(); }
+	// add the time of one frame
+	void AddFrame(double milliseconds) { m_frameMilliseconds.push_back(milliseconds); }
+
+	// get the frame times, in the order they were added
+	const std::vector<double>& GetFrames() const { return m_frameMilliseconds; }
+	// get the number of frame times
+	size_t GetFrameCount() const { return m_frameMilliseconds.size(); }
+
+	// summarize the frame times
+	SUMMARY Summarize() const;
+	// get the frame time that a percentage of the frames are at or below
+	double GetPercentile(double percent) const;
+
+	// write a summary as one line of JSON, starting with a name
+	// for the run
+	static void WriteSummary(std::ostream& output, const char* name, const SUMMARY& summary);
+	// write the time of every frame, one per line, so that the
+	// times of two runs can be compared frame by frame
+	void WriteFrames(std::ostream& output) const;
+
+private:
+	// the time of each frame, in milliseconds
+	std::vector<double> m_frameMilliseconds;
+};
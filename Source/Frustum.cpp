@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustum.cpp
+// ============
+// test bounding volumes against the view frustum of the camera
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Frustum.h"
+
+#include <cmath>
+
+/***********************************************************
+ *  Frustum()
+ *
+ *  The constructor for the class.  Until the planes are set,
+ *  every volume is visible.
+ ***********************************************************/
+Frustum::Frustum()
+{
+	for (int i = 0; i < 6; i++)
+	{
+		m_planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+/***********************************************************
+ *  SetViewProjection()
+ *
+ *  This method is used for taking the frustum planes from a
+ *  combined view and projection matrix.  Each plane is a sum
+ *  or difference of the last row of the matrix and one of
+ *  the other rows, and is normalized so that the sphere test
+ *  can compare distances with the radius.
+ ***********************************************************/
+void Frustum::SetViewProjection(const glm::mat4& viewProjection)
+{
+	glm::vec4 rows[4];
+	for (int row = 0; row < 4; row++)
+	{
+		rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+	}
+
+	m_planes[0] = rows[3] + rows[0];
+	m_planes[1] = rows[3] - rows[0];
+	m_planes[2] = rows[3] + rows[1];
+	m_planes[3] = rows[3] - rows[1];
+	m_planes[4] = rows[3] + rows[2];
+	m_planes[5] = rows[3] - rows[2];
+
+	for (int i = 0; i < 6; i++)
+	{
+		float length = std::sqrt(
+			m_planes[i].x * m_planes[i].x +
+			m_planes[i].y * m_planes[i].y +
+			m_planes[i].z * m_planes[i].z);
+		if (length > 0.0f)
+		{
+			m_planes[i] = m_planes[i] * (1.0f / length);
+		}
+	}
+}
+
+/***********************************************************
+ *  IsSphereVisible()
+ *
+ *  This method is used for checking whether a sphere may be
+ *  inside the frustum.  It is hidden when its center is
+ *  further than its radius behind any plane.
+ ***********************************************************/
+bool Frustum::IsSphereVisible(const glm::vec3& center, float radius) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		const glm::vec4& plane = m_planes[i];
+		if ((plane.x * center.x) + (plane.y * center.y) + (plane.z * center.z) + plane.w < -radius)
+		{
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsBoxVisible()
+ *
+ *  This method is used for checking whether an axis aligned
+ *  box may be inside the frustum.  For each plane, only the
+ *  corner that is furthest along the plane normal is tested,
+ *  and the box is hidden when that corner is behind it.
+ ***********************************************************/
+bool Frustum::IsBoxVisible(const glm::vec3& minimum, const glm::vec3& maximum) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		const glm::vec4& plane = m_planes[i];
+		float x = (plane.x >= 0.0f) ? maximum.x : minimum.x;
+		float y = (plane.y >= 0.0f) ? maximum.y : minimum.y;
+		float z = (plane.z >= 0.0f) ? maximum.z : minimum.z;
+
+		if ((plane.x * x) + (plane.y * y) + (plane.z * z) + plane.w < 0.0f)
+		{
+			return(false);
+		}
+	}
+
+	return(true);
+}
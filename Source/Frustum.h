@@ -0,0 +1,41 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustum.h
+// ============
+// test bounding volumes against the view frustum of the camera
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  Frustum
+ *
+ *  This class holds the six planes of the camera's view
+ *  frustum, taken from the combined view and projection
+ *  matrix, and tests world space bounding spheres and boxes
+ *  against them.  A volume is only reported as hidden when
+ *  it is completely outside of one of the planes, so the
+ *  tests never hide anything that can be seen.
+ ***********************************************************/
+class Frustum
+{
+public:
+	// constructor
+	Frustum();
+
+	// take the frustum planes from a view and projection matrix
+	void SetViewProjection(const glm::mat4& viewProjection);
+
+	// check whether any part of a sphere may be inside the frustum
+	bool IsSphereVisible(const glm::vec3& center, float radius) const;
+	// check whether any part of a box may be inside the frustum
+	bool IsBoxVisible(const glm::vec3& minimum, const glm::vec3& maximum) const;
+
+private:
+	// left, right, bottom, top, near and far planes, with the
+	// normals pointing into the frustum
+	glm::vec4 m_planes[6];
+};
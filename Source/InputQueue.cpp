@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputqueue.cpp
+// ============
+// pass the input events of the display window to the camera update
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InputQueue.h"
+
+static_assert((InputQueue::CAPACITY & (InputQueue::CAPACITY - 1)) == 0, "the input queue capacity must be a power of two");
+
+/***********************************************************
+ *  InputQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InputQueue::InputQueue()
+	: m_readIndex(0), m_writeIndex(0)
+{
+}
+
+/***********************************************************
+ *  Push()
+ *
+ *  This method is used for adding an event at the end of the
+ *  queue.  The event is copied in before the write index
+ *  moves past it, with release ordering, so the reading
+ *  thread never sees the index before the event.  One event
+ *  is always left free, so a full queue can be told from an
+ *  empty one.
+ ***********************************************************/
+bool InputQueue::Push(const INPUT_EVENT& event)
+{
+	size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+	size_t nextIndex = (writeIndex + 1) & (CAPACITY - 1);
+
+	if (nextIndex == m_readIndex.load(std::memory_order_acquire))
+	{
+		return(false);
+	}
+
+	m_events[writeIndex] = event;
+	m_writeIndex.store(nextIndex, std::memory_order_release);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Peek()
+ *
+ *  This method is used for copying the oldest event out of
+ *  the queue, while leaving it there.
+ ***********************************************************/
+bool InputQueue::Peek(INPUT_EVENT& event) const
+{
+	size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+
+	if (readIndex == m_writeIndex.load(std::memory_order_acquire))
+	{
+		return(false);
+	}
+
+	event = m_events[readIndex];
+
+	return(true);
+}
+
+/***********************************************************
+ *  Pop()
+ *
+ *  This method is used for taking the oldest event out of
+ *  the queue.  The read index moves past it with release
+ *  ordering, so the writing thread only reuses the event
+ *  once it has been copied out.
+ ***********************************************************/
+void InputQueue::Pop()
+{
+	size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+
+	if (readIndex == m_writeIndex.load(std::memory_order_acquire))
+	{
+		return;
+	}
+
+	m_readIndex.store((readIndex + 1) & (CAPACITY - 1), std::memory_order_release);
+}
@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputqueue.h
+// ============
+// pass the input events of the display window to the camera update
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************
+ *  InputQueue
+ *
+ *  This class is a fixed size ring of input events, written
+ *  by the GLFW callbacks on the thread that polls the window
+ *  and read by the camera update, which may run on another
+ *  thread.  It takes no locks: with one thread pushing and
+ *  one thread taking events, each end only writes its own
+ *  index, and reads the other one's with acquire ordering,
+ *  so an event is always written before it can be read.
+ *
+ *  Each event holds the time it happened, so the update can
+ *  apply it in the fixed time step it belongs to.
+ ***********************************************************/
+class InputQueue
+{
+public:
+	// constructor
+	InputQueue();
+
+	enum EVENT_TYPE
+	{
+		// a camera key went down or up
+		KEY_CHANGED = 0,
+		// the mouse moved by an offset
+		MOUSE_MOVED,
+		// the view was reset to its perspective or orthographic start
+		PERSPECTIVE_VIEW,
+		ORTHOGRAPHIC_VIEW
+	};
+
+	struct INPUT_EVENT
+	{
+		EVENT_TYPE type;
+		// glfwGetTime() when the event happened
+		double time;
+		// the camera key, as CameraPath::KEY_FLAGS, and whether it
+		// went down
+		uint32_t key;
+		bool bPressed;
+		// the mouse movement
+		glm::vec2 mouseOffset;
+	};
+
+	// number of events the queue holds, a power of two
+	static const size_t CAPACITY = 1024;
+
+	// add an event, from the one thread that writes events, which
+	// fails when the queue is full
+	bool Push(const INPUT_EVENT& event);
+	// look at the oldest event without taking it, from the one
+	// thread that reads events, which fails when the queue is empty
+	bool Peek(INPUT_EVENT& event) const;
+	// take the oldest event, after looking at it
+	void Pop();
+
+private:
+	INPUT_EVENT m_events[CAPACITY];
+	// index of the oldest event, written only by the reading thread,
+	// and of the next free event, written only by the writing thread,
+	// on cache lines of their own so the threads do not share them
+	alignas(64) std::atomic<size_t> m_readIndex;
+	alignas(64) std::atomic<size_t> m_writeIndex;
+};
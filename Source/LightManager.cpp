@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightmanager.cpp
+// ============
+// keep any number of scene lights in a storage buffer for the shaders
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightManager.h"
+#include "RenderStats.h"
+
+static_assert(sizeof(glm::vec3) == 12, "glm::vec3 must be tightly packed");
+
+/***********************************************************
+ *  LightManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightManager::LightManager()
+{
+	m_bCountDirty = true;
+	m_bufferID = 0;
+	m_capacity = 0;
+}
+
+/***********************************************************
+ *  ~LightManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LightManager::~LightManager()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  AddLight()
+ *
+ *  This method is used for adding a light to the scene.  The
+ *  returned handle is the light's index in the light list.
+ ***********************************************************/
+int LightManager::AddLight(const LIGHT_SOURCE& light)
+{
+	m_lights.push_back(light);
+	m_dirtyLights.push_back(true);
+	m_bCountDirty = true;
+
+	return((int)m_lights.size() - 1);
+}
+
+/***********************************************************
+ *  SetLight()
+ *
+ *  This method is used for changing the values of a light.
+ *  The light is only marked dirty when a value changes.
+ ***********************************************************/
+bool LightManager::SetLight(int lightHandle, const LIGHT_SOURCE& light)
+{
+	if ((lightHandle < 0) || (lightHandle >= (int)m_lights.size()))
+	{
+		return(false);
+	}
+
+	LIGHT_SOURCE& current = m_lights[lightHandle];
+	if ((current.position != light.position) ||
+		(current.ambientColor != light.ambientColor) ||
+		(current.diffuseColor != light.diffuseColor) ||
+		(current.specularColor != light.specularColor) ||
+		(current.focalStrength != light.focalStrength) ||
+		(current.specularIntensity != light.specularIntensity))
+	{
+		current = light;
+		m_dirtyLights[lightHandle] = true;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all of the lights.
+ ***********************************************************/
+void LightManager::Clear()
+{
+	m_lights.clear();
+	m_dirtyLights.clear();
+	m_bCountDirty = true;
+}
+
+/***********************************************************
+ *  MergeRedundantLights()
+ *
+ *  This method is used for merging lights that have the same
+ *  position, focal strength and specular intensity.  The
+ *  lighting in the shader adds up linearly in the light
+ *  colors, so such lights light the scene exactly like one
+ *  light with the sum of their colors.  It is meant to be
+ *  called when the scene is built, since the handles of the
+ *  lights after a merged light change.  The number of lights
+ *  that were merged away is returned.
+ ***********************************************************/
+int LightManager::MergeRedundantLights()
+{
+	std::vector<LIGHT_SOURCE> mergedLights;
+
+	for (size_t i = 0; i < m_lights.size(); i++)
+	{
+		const LIGHT_SOURCE& light = m_lights[i];
+		bool bMerged = false;
+
+		for (size_t j = 0; (j < mergedLights.size()) && (bMerged == false); j++)
+		{
+			LIGHT_SOURCE& mergedLight = mergedLights[j];
+			if ((mergedLight.position == light.position) &&
+				(mergedLight.focalStrength == light.focalStrength) &&
+				(mergedLight.specularIntensity == light.specularIntensity))
+			{
+				mergedLight.ambientColor += light.ambientColor;
+				mergedLight.diffuseColor += light.diffuseColor;
+				mergedLight.specularColor += light.specularColor;
+				bMerged = true;
+			}
+		}
+
+		if (bMerged == false)
+		{
+			mergedLights.push_back(light);
+		}
+	}
+
+	int mergedCount = (int)(m_lights.size() - mergedLights.size());
+	if (mergedCount > 0)
+	{
+		m_lights = mergedLights;
+		m_dirtyLights.assign(m_lights.size(), true);
+		m_bCountDirty = true;
+	}
+
+	return(mergedCount);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for uploading the lights that changed
+ *  since the last update.  Each run of neighboring dirty
+ *  lights is uploaded with one write.  When the storage
+ *  buffer is too small for the lights, it is created again
+ *  with room to grow and every light is uploaded.
+ ***********************************************************/
+int LightManager::Update()
+{
+	int lightCount = (int)m_lights.size();
+	int uploadedCount = 0;
+
+	if ((0 == m_bufferID) || (lightCount > m_capacity))
+	{
+		Destroy();
+
+		m_capacity = 16;
+		while (m_capacity < lightCount)
+		{
+			m_capacity *= 2;
+		}
+
+		glGenBuffers(1, &m_bufferID);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferID);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, LIGHTS_OFFSET + m_capacity * sizeof(GPU_LIGHT), NULL, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_BINDING, m_bufferID);
+
+		m_dirtyLights.assign(m_lights.size(), true);
+		m_bCountDirty = true;
+	}
+	else
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_bufferID);
+	}
+
+	if (m_bCountDirty)
+	{
+		GLint count = lightCount;
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(count), &count);
+		RenderStats::Add(RenderStats::BUFFER_UPLOADS);
+		m_bCountDirty = false;
+	}
+
+	std::vector<GPU_LIGHT> dirtyRun;
+	int i = 0;
+	while (i < lightCount)
+	{
+		if (m_dirtyLights[i] == false)
+		{
+			i++;
+			continue;
+		}
+
+		int firstLight = i;
+		dirtyRun.clear();
+		while ((i < lightCount) && m_dirtyLights[i])
+		{
+			dirtyRun.push_back(ConvertLight(m_lights[i]));
+			m_dirtyLights[i] = false;
+			i++;
+		}
+
+		glBufferSubData(
+			GL_SHADER_STORAGE_BUFFER,
+			LIGHTS_OFFSET + firstLight * sizeof(GPU_LIGHT),
+			dirtyRun.size() * sizeof(GPU_LIGHT),
+			dirtyRun.data());
+		RenderStats::Add(RenderStats::BUFFER_UPLOADS);
+		uploadedCount += (int)dirtyRun.size();
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	return(uploadedCount);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the storage buffer.  The
+ *  lights are kept, and are all uploaded on the next update.
+ ***********************************************************/
+void LightManager::Destroy()
+{
+	if (0 != m_bufferID)
+	{
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+	m_capacity = 0;
+}
+
+/***********************************************************
+ *  ConvertLight()
+ *
+ *  This method is used for converting a light to the layout
+ *  the storage buffer stores it in.
+ ***********************************************************/
+LightManager::GPU_LIGHT LightManager::ConvertLight(const LIGHT_SOURCE& light)
+{
+	GPU_LIGHT gpuLight;
+
+	gpuLight.position = light.position;
+	gpuLight.focalStrength = light.focalStrength;
+	gpuLight.ambientColor = light.ambientColor;
+	gpuLight.specularIntensity = light.specularIntensity;
+	gpuLight.diffuseColor = light.diffuseColor;
+	gpuLight.padding0 = 0.0f;
+	gpuLight.specularColor = light.specularColor;
+	gpuLight.padding1 = 0.0f;
+
+	return(gpuLight);
+}
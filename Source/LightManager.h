@@ -0,0 +1,98 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightmanager.h
+// ============
+// keep any number of scene lights in a storage buffer for the shaders
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  LightManager
+ *
+ *  This class stores the scene lights in one shader storage
+ *  buffer, together with the number of lights, so the shader
+ *  can light with any number of them.  Every light that is
+ *  added or changed is marked dirty, and only the dirty
+ *  lights are uploaded again on the next update.  Lights that
+ *  would light the scene the same way as another light can
+ *  be merged into it when the scene is built.
+ ***********************************************************/
+class LightManager
+{
+public:
+	// constructor
+	LightManager();
+	// destructor
+	~LightManager();
+
+	// storage buffer binding point of the light block
+	static const GLuint LIGHT_BINDING = 1;
+
+	struct LIGHT_SOURCE
+	{
+		glm::vec3 position;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float focalStrength;
+		float specularIntensity;
+	};
+
+	// add a light and get its handle
+	int AddLight(const LIGHT_SOURCE& light);
+	// change a light, which is uploaded on the next update
+	bool SetLight(int lightHandle, const LIGHT_SOURCE& light);
+	// get the values of a light
+	const LIGHT_SOURCE& GetLight(int lightHandle) const { return m_lights[lightHandle]; }
+	// get the number of lights
+	int GetLightCount() const { return (int)m_lights.size(); }
+	// remove all of the lights
+	void Clear();
+
+	// merge lights that only add to the lighting of another light
+	int MergeRedundantLights();
+
+	// upload the dirty lights, and get the number uploaded
+	int Update();
+	// free the storage buffer
+	void Destroy();
+
+private:
+	// std430 layout of the LightSource struct in the fragment shader
+	struct GPU_LIGHT
+	{
+		glm::vec3 position;
+		float focalStrength;
+		glm::vec3 ambientColor;
+		float specularIntensity;
+		glm::vec3 diffuseColor;
+		float padding0;
+		glm::vec3 specularColor;
+		float padding1;
+	};
+
+	// byte offset of the first light after the light count
+	static const size_t LIGHTS_OFFSET = 16;
+
+	// the scene lights
+	std::vector<LIGHT_SOURCE> m_lights;
+	// true for each light that has to be uploaded
+	std::vector<bool> m_dirtyLights;
+	// true when the light count has to be uploaded
+	bool m_bCountDirty;
+
+	// OpenGL shader storage buffer object
+	GLuint m_bufferID;
+	// number of lights the storage buffer has room for
+	int m_capacity;
+
+	// convert a light to the storage buffer layout
+	static GPU_LIGHT ConvertLight(const LIGHT_SOURCE& light);
+};
@@ -1,177 +1,825 @@
-#include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
-
-#include <GL/glew.h>        // GLEW library
-#include "GLFW/glfw3.h"     // GLFW library
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "SceneManager.h"
-#include "ViewManager.h"
-#include "ShapeMeshes.h"
-#include "ShaderManager.h"
-
-// Namespace for declaring global variables
-namespace
-{
-	// Macro for window title
-	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
-
-	// Main GLFW window
-	GLFWwindow* g_Window = nullptr;
-
-	// scene manager object for managing the 3D scene prepare and render
-	SceneManager* g_SceneManager = nullptr;
-	// shader manager object for dynamic interaction with the shader code
-	ShaderManager* g_ShaderManager = nullptr;
-	// view manager object for managing the 3D view setup and projection to 2D
-	ViewManager* g_ViewManager = nullptr;
-}
-
-// Function declarations - all functions that are called manually
-// need to be pre-declared at the beginning of the source code.
-bool InitializeGLFW();
-bool InitializeGLEW();
-
-
-/***********************************************************
- *  main(int, char*)
- *
- *  This function gets called after the application has been
- *  launched.
- ***********************************************************/
-int main(int argc, char* argv[])
-{
-	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// try to create a new shader manager object
-	g_ShaderManager = new ShaderManager();
-	// try to create a new view manager object
-	g_ViewManager = new ViewManager(
-		g_ShaderManager);
-
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
-
-	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
-
-	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
-
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
-	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
-
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
-
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
-
-
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
-
-		// query the latest GLFW events
-		glfwPollEvents();
-	}
-
-	// clear the allocated manager objects from memory
-	if (NULL != g_SceneManager)
-	{
-		delete g_SceneManager;
-		g_SceneManager = NULL;
-	}
-	if (NULL != g_ViewManager)
-	{
-		delete g_ViewManager;
-		g_ViewManager = NULL;
-	}
-	if (NULL != g_ShaderManager)
-	{
-		delete g_ShaderManager;
-		g_ShaderManager = NULL;
-	}
-
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
-}
-
-/***********************************************************
- *	InitializeGLFW()
- * 
- *  This function is used to initialize the GLFW library.   
- ***********************************************************/
-bool InitializeGLFW()
-{
-	// GLFW: initialize and configure library
-	// --------------------------------------
-	glfwInit();
-
-#ifdef __APPLE__
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#else
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
-	// GLFW: end -------------------------------
-
-	return(true);
-}
-
-/***********************************************************
- *	InitializeGLEW()
- *
- *  This function is used to initialize the GLEW library.
- ***********************************************************/
-bool InitializeGLEW()
-{
-	// GLEW: initialize
-	// -----------------------------------------
-	GLenum GLEWInitResult = GLEW_OK;
-
-	// try to initialize the GLEW library
-	GLEWInitResult = glewInit();
-	if (GLEW_OK != GLEWInitResult)
-	{
-		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
-		return false;
-	}
-	// GLEW: end -------------------------------
-
-	// Displays a successful OpenGL initialization message
-	std::cout << "INFO: OpenGL Successfully Initialized\n";
-	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
-
-	return(true);
-}
\ No newline at end of file
+#include <iostream>         // error handling and output
+#include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // strcmp
+#include <algorithm>        // std::max
+#include <chrono>           // frame timing
+#include <fstream>          // benchmark results
+#include <sstream>          // window title
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ShapeMeshes.h"
+#include "ShaderManager.h"
+#include "UniformCache.h"
+#include "OffscreenContext.h"
+#include "FrameTimings.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "CameraPath.h"
+#include "FramePipeline.h"
+#include "FramePacer.h"
+
+// Namespace for declaring global variables
+namespace
+{
+	// Macro for window title
+	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
+
+	// Main GLFW window
+	GLFWwindow* g_Window = nullptr;
+
+	// scene manager object for managing the 3D scene prepare and render
+	SceneManager* g_SceneManager = nullptr;
+	// shader manager object for dynamic interaction with the shader code
+	ShaderManager* g_ShaderManager = nullptr;
+	// uniform cache object for setting the shader values
+	UniformCache* g_UniformCache = nullptr;
+	// view manager object for managing the 3D view setup and projection to 2D
+	ViewManager* g_ViewManager = nullptr;
+	// offscreen context that replaces the window in headless mode
+	OffscreenContext* g_OffscreenContext = nullptr;
+	// builds each frame on a worker thread while the one before is
+	// drawn, unless that is turned off
+	FramePipeline* g_FramePipeline = nullptr;
+	// decides when each frame of the window is shown
+	FramePacer* g_FramePacer = nullptr;
+
+	// size of the offscreen framebuffer, unless one is passed in
+	const int DEFAULT_HEADLESS_WIDTH = 1000;
+	const int DEFAULT_HEADLESS_HEIGHT = 800;
+	// number of frames timed in headless mode, and of frames
+	// rendered before them to warm up, unless passed in
+	const int DEFAULT_BENCHMARK_FRAMES = 300;
+	const int DEFAULT_WARMUP_FRAMES = 10;
+	// file the profiler trace is written to, unless one is passed in
+	const char* const DEFAULT_PROFILE_OUTPUT = "profile_trace.json";
+	// frames per second of replayed camera paths, unless one is
+	// passed in
+	const int DEFAULT_REPLAY_FPS = 60;
+	// frames per second the frame limiter keeps to, unless one is
+	// passed in
+	const int DEFAULT_TARGET_FPS = 60;
+}
+
+// Function declarations - all functions that are called manually
+// need to be pre-declared at the beginning of the source code.
+bool InitializeGLFW();
+bool InitializeGLEW(bool bHeadless);
+void RenderFrame();
+void BuildFrame(FramePipeline::FRAME_PACKET& packet);
+void SubmitFrame(FramePipeline::FRAME_PACKET& packet);
+void RunHeadlessBenchmark(int frameCount, int warmupFrames, const CameraPath* pReplayPath, float replayTimestep, const char* profileOutput, FrameTimings& frameTimings);
+int WriteBenchmarkResults(const char* name, const FrameTimings& frameTimings, const char* outputPath, const char* timingsPath);
+bool HasCommandLineOption(int argc, char* argv[], const char* option);
+const char* GetCommandLineValue(int argc, char* argv[], const char* option);
+int GetCommandLineInt(int argc, char* argv[], const char* option, int defaultValue);
+
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the application has been
+ *  launched.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	// with --headless the scene is rendered into an offscreen
+	// framebuffer and timed for a number of frames, which needs no
+	// display, so it can run on build servers
+	bool bHeadless = HasCommandLineOption(argc, argv, "--headless");
+	int exitCode = EXIT_SUCCESS;
+
+	// the phases of each frame are timed with --profile, and the
+	// trace is written when F12 is pressed, when the process gets
+	// SIGUSR1 and when the program closes
+	const char* profileOutput = GetCommandLineValue(argc, argv, "--profile-output");
+	if (NULL == profileOutput)
+	{
+		profileOutput = DEFAULT_PROFILE_OUTPUT;
+	}
+	Profiler::SetEnabled(HasCommandLineOption(argc, argv, "--profile"));
+	Profiler::SetThreadName("Main");
+	Profiler::InstallSignalHandler();
+
+	if (bHeadless)
+	{
+		// the offscreen context takes the place of GLFW
+		g_OffscreenContext = new OffscreenContext();
+		if (g_OffscreenContext->CreateContext() == false)
+		{
+			return(EXIT_FAILURE);
+		}
+	}
+	// if GLFW fails initialization, then terminate the application
+	else if (InitializeGLFW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// try to create a new shader manager object
+	g_ShaderManager = new ShaderManager();
+	// try to create a new uniform cache object
+	g_UniformCache = new UniformCache();
+	// try to create a new view manager object
+	g_ViewManager = new ViewManager(
+		g_ShaderManager,
+		g_UniformCache);
+
+	// try to create the main display window
+	if (!bHeadless)
+	{
+		g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+	}
+
+	// if GLEW fails initialization, then terminate the application
+	if (InitializeGLEW(bHeadless) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	int targetFramesPerSecond = GetCommandLineInt(argc, argv, "--target-fps", DEFAULT_TARGET_FPS);
+	if (bHeadless)
+	{
+		int width = GetCommandLineInt(argc, argv, "--width", DEFAULT_HEADLESS_WIDTH);
+		int height = GetCommandLineInt(argc, argv, "--height", DEFAULT_HEADLESS_HEIGHT);
+		if (g_OffscreenContext->CreateFramebuffer(width, height) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+		g_ViewManager->SetViewportSize(width, height);
+
+		// the same blending the display window turns on
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+	else
+	{
+		// the window waits for the vertical blank unless another
+		// pacing mode is passed in: off, adaptive, or limit, which
+		// keeps to the target frames per second without vsync
+		FramePacer::PACING_MODE pacingMode = FramePacer::VSYNC_ON;
+		const char* pacingName = GetCommandLineValue(argc, argv, "--pacing");
+		if ((NULL != pacingName) && (FramePacer::ParseMode(pacingName, pacingMode) == false))
+		{
+			std::cout << "ERROR: Unknown pacing mode " << pacingName
+				<< ", use off, vsync, adaptive or limit" << std::endl;
+			return(EXIT_FAILURE);
+		}
+		g_FramePacer = new FramePacer();
+		g_FramePacer->SetMode(pacingMode, targetFramesPerSecond);
+	}
+
+	// render state that never changes is set once, before the
+	// first frame
+	glEnable(GL_DEPTH_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+	// load the shader code from the external GLSL files - the
+	// project keeps its own shaders, since the scene textures are
+	// sampled from texture arrays
+	g_ShaderManager->LoadShaders(
+		"Shaders/vertexShader.glsl",
+		"Shaders/fragmentShader.glsl");
+	g_ShaderManager->use();
+
+	// all uniform values are set through the uniform cache
+	GLint programID = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+	g_UniformCache->SetProgram(programID);
+
+	// try to create a new scene manager object and prepare the 3D scene
+	g_SceneManager = new SceneManager(g_ShaderManager, g_UniformCache);
+	// decoded textures are kept in an on-disk cache unless it is
+	// turned off, and can be block compressed to save memory
+	g_SceneManager->SetTextureCacheOptions(
+		!HasCommandLineOption(argc, argv, "--no-texture-cache"),
+		HasCommandLineOption(argc, argv, "--compress-textures"));
+	// textures can be streamed in after the first frame is shown
+	g_SceneManager->SetTextureStreaming(
+		HasCommandLineOption(argc, argv, "--stream-textures"));
+	// a different scene file can be passed in on the command line
+	const char* scenePath = GetCommandLineValue(argc, argv, "--scene");
+	if (NULL != scenePath)
+	{
+		g_SceneManager->SetSceneFile(scenePath);
+	}
+	// objects outside of the view are culled unless turned off
+	g_SceneManager->SetFrustumCulling(!HasCommandLineOption(argc, argv, "--no-culling"));
+	// and small objects are drawn with coarser meshes unless turned off
+	g_SceneManager->SetLevelOfDetail(!HasCommandLineOption(argc, argv, "--no-lod"));
+	// the scene can be drawn with one multi-draw indirect call
+	// instead of one instanced draw for each mesh
+	g_SceneManager->SetIndirectDrawing(HasCommandLineOption(argc, argv, "--indirect"));
+	g_SceneManager->PrepareScene();
+
+	// the camera, culling and draw lists of each frame are built on
+	// a worker thread while the frame before is drawn, so that this
+	// thread only makes the OpenGL calls, unless that is turned off
+	if (!HasCommandLineOption(argc, argv, "--no-frame-thread"))
+	{
+		g_FramePipeline = new FramePipeline();
+	}
+
+	// the camera can be recorded into a path file while the window
+	// is open, or replayed from one at a fixed frame rate, in which
+	// case every frame is timed
+	const char* recordFile = GetCommandLineValue(argc, argv, "--record-path");
+	const char* replayFile = GetCommandLineValue(argc, argv, "--replay-path");
+	CameraPath replayPath;
+	float replayTimestep = 1.0f / (float)std::max(GetCommandLineInt(argc, argv, "--replay-fps", DEFAULT_REPLAY_FPS), 1);
+	FrameTimings frameTimings;
+	if (NULL != replayFile)
+	{
+		if (replayPath.Load(replayFile) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+		g_ViewManager->StartReplay(&replayPath, replayTimestep);
+	}
+	else if ((NULL != recordFile) && !bHeadless)
+	{
+		g_ViewManager->StartRecording();
+	}
+
+	// the uniform write counts can be reported once per second
+	bool bReportUniforms = HasCommandLineOption(argc, argv, "--uniform-stats");
+	// and so can the state changes the render queue avoids
+	bool bReportQueue = HasCommandLineOption(argc, argv, "--queue-stats");
+	// and so can the objects culled and drawn in each frame
+	bool bReportCulling = HasCommandLineOption(argc, argv, "--cull-stats");
+	// and so can every render count of a frame, which are shown in
+	// the window title as well
+	bool bReportRender = HasCommandLineOption(argc, argv, "--render-stats");
+	// and so can the jitter of the frame pacing
+	bool bReportPacing = HasCommandLineOption(argc, argv, "--pacing-stats");
+	if (NULL != g_FramePacer)
+	{
+		g_FramePacer->SetStatisticsEnabled(bReportPacing);
+	}
+	// timed with the steady clock, since GLFW is not initialized in
+	// headless mode
+	std::chrono::steady_clock::time_point lastStatsReport = std::chrono::steady_clock::now();
+	// the I key switches between the two ways of drawing the scene
+	bool bIndirectKeyDown = false;
+	// the V key switches to the next pacing mode
+	bool bPacingKeyDown = false;
+	// and the F12 key writes the profiler trace
+	bool bProfileKeyDown = false;
+	// a replayed path closes the window once it has been shown
+	bool bReplayFinished = false;
+
+	// in headless mode the frames are timed instead of shown
+	if (bHeadless)
+	{
+		// a replayed path sets the number of frames
+		RunHeadlessBenchmark(
+			(NULL != replayFile) ? replayPath.GetFrameCount(replayTimestep) : GetCommandLineInt(argc, argv, "--frames", DEFAULT_BENCHMARK_FRAMES),
+			GetCommandLineInt(argc, argv, "--warmup", DEFAULT_WARMUP_FRAMES),
+			(NULL != replayFile) ? &replayPath : NULL,
+			replayTimestep,
+			profileOutput,
+			frameTimings);
+		exitCode = WriteBenchmarkResults(
+			(NULL != replayFile) ? replayFile : "headless",
+			frameTimings,
+			GetCommandLineValue(argc, argv, "--benchmark-output"),
+			GetCommandLineValue(argc, argv, "--timings-output"));
+
+		// the counts of the last frame are closed before they are shown
+		if (bReportRender)
+		{
+			RenderStats::BeginFrame();
+			RenderStats::WriteLine(std::cout);
+		}
+	}
+
+	if (!bHeadless && (NULL != g_FramePipeline))
+	{
+		g_FramePipeline->Start(BuildFrame);
+	}
+
+	// loop will keep running until the application is closed 
+	// or until an error has occurred
+	while (!bHeadless && !glfwWindowShouldClose(g_Window) && !bReplayFinished)
+	{
+		PROFILE_SCOPE("Frame");
+		std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+
+		// start counting the uniform writes and timing the phases
+		// of this frame
+		g_UniformCache->BeginFrame();
+		RenderStats::BeginFrame();
+		Profiler::BeginFrame();
+		if ((bReportUniforms || bReportQueue || bReportCulling || bReportRender || bReportPacing) && (std::chrono::steady_clock::now() - lastStatsReport >= std::chrono::seconds(1)))
+		{
+			if (bReportUniforms)
+			{
+				std::cout << "Uniforms set: " << g_UniformCache->GetUniformsSet()
+					<< ", skipped: " << g_UniformCache->GetUniformsSkipped() << std::endl;
+			}
+			if (bReportQueue)
+			{
+				std::cout << "Draws: " << g_SceneManager->GetDrawnCount()
+					<< ", state changes: " << g_SceneManager->GetStateChanges()
+					<< ", avoided: " << g_SceneManager->GetAvoidedStateChanges() << std::endl;
+			}
+			if (bReportCulling)
+			{
+				std::cout << "Objects drawn: " << g_SceneManager->GetDrawnCount()
+					<< ", culled: " << g_SceneManager->GetCulledCount()
+					<< ", triangles: " << g_SceneManager->GetDrawnTriangleCount() << std::endl;
+			}
+			if (bReportRender)
+			{
+				RenderStats::WriteLine(std::cout);
+
+				std::ostringstream title;
+				title << WINDOW_TITLE << " - "
+					<< RenderStats::Get(RenderStats::DRAW_CALLS) << " draws, "
+					<< RenderStats::Get(RenderStats::TRIANGLES) << " triangles, "
+					<< RenderStats::Get(RenderStats::UNIFORM_UPLOADS) << " uniforms, "
+					<< RenderStats::Get(RenderStats::STATE_CHANGES) << " state changes";
+				glfwSetWindowTitle(g_Window, title.str().c_str());
+			}
+			if (bReportPacing)
+			{
+				g_FramePacer->WriteLine(std::cout);
+				g_FramePacer->ResetStatistics();
+			}
+			lastStatsReport = std::chrono::steady_clock::now();
+		}
+
+		bool bIndirectKeyPressed = (glfwGetKey(g_Window, GLFW_KEY_I) == GLFW_PRESS);
+		if (bIndirectKeyPressed && !bIndirectKeyDown)
+		{
+			g_SceneManager->SetIndirectDrawing(!g_SceneManager->IsIndirectDrawing());
+			std::cout << "Drawing with "
+				<< (g_SceneManager->IsIndirectDrawing() ? "one multi-draw indirect call" : "one instanced draw per mesh")
+				<< std::endl;
+		}
+		bIndirectKeyDown = bIndirectKeyPressed;
+
+		bool bPacingKeyPressed = (glfwGetKey(g_Window, GLFW_KEY_V) == GLFW_PRESS);
+		if (bPacingKeyPressed && !bPacingKeyDown)
+		{
+			// a mode the driver lacks falls back to the current one,
+			// and is passed over
+			FramePacer::PACING_MODE currentMode = g_FramePacer->GetMode();
+			FramePacer::PACING_MODE nextMode = currentMode;
+			do
+			{
+				nextMode = (FramePacer::PACING_MODE)((nextMode + 1) % FramePacer::PACING_MODE_COUNT);
+				g_FramePacer->SetMode(nextMode, targetFramesPerSecond);
+			} while (g_FramePacer->GetMode() == currentMode);
+			std::cout << "Frame pacing: " << FramePacer::GetModeName(g_FramePacer->GetMode()) << std::endl;
+		}
+		bPacingKeyDown = bPacingKeyPressed;
+
+		// the first F12 press starts the profiler if it is off, and
+		// the next ones write out what it has recorded
+		bool bProfileKeyPressed = (glfwGetKey(g_Window, GLFW_KEY_F12) == GLFW_PRESS);
+		if (bProfileKeyPressed && !bProfileKeyDown)
+		{
+			if (Profiler::IsEnabled())
+			{
+				Profiler::RequestDump();
+			}
+			else
+			{
+				Profiler::SetEnabled(true);
+				std::cout << "Profiler started, press F12 again to write the trace" << std::endl;
+			}
+		}
+		bProfileKeyDown = bProfileKeyPressed;
+		if (Profiler::IsDumpRequested())
+		{
+			Profiler::WriteChromeTrace(profileOutput);
+		}
+
+		// with the frame thread, this frame was built while the one
+		// before was drawn, and only its packet is submitted here
+		if (NULL != g_FramePipeline)
+		{
+			FramePipeline::FRAME_PACKET* pPacket = g_FramePipeline->AcquirePacket();
+			SubmitFrame(*pPacket);
+			bReplayFinished = pPacket->bReplayFinished;
+			g_FramePipeline->ReleasePacket();
+		}
+		else
+		{
+			RenderFrame();
+			bReplayFinished = g_ViewManager->IsReplayFinished();
+		}
+
+		// Flips the the back buffer with the front buffer every frame.
+		{
+			PROFILE_SCOPE("SwapBuffers");
+			glfwSwapBuffers(g_Window);
+		}
+
+		// the frame limiter waits here for the next frame, before
+		// the input it is drawn from is read
+		g_FramePacer->EndFrame();
+
+		// query the latest GLFW events
+		{
+			PROFILE_SCOPE("PollEvents");
+			glfwPollEvents();
+		}
+
+		if (g_ViewManager->IsReplaying())
+		{
+			frameTimings.AddFrame(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+		}
+	}
+
+	// the frame thread is stopped before anything it builds is used
+	if (NULL != g_FramePipeline)
+	{
+		delete g_FramePipeline;
+		g_FramePipeline = NULL;
+	}
+
+	// a replay in the window is timed the same way as a headless one,
+	// including the swaps, and a recorded path is saved on closing
+	if (!bHeadless && (NULL != replayFile))
+	{
+		exitCode = WriteBenchmarkResults(
+			replayFile,
+			frameTimings,
+			GetCommandLineValue(argc, argv, "--benchmark-output"),
+			GetCommandLineValue(argc, argv, "--timings-output"));
+	}
+	else if (!bHeadless && (NULL != recordFile))
+	{
+		exitCode = g_ViewManager->SaveRecording(recordFile) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (Profiler::IsEnabled())
+	{
+		Profiler::WriteChromeTrace(profileOutput);
+	}
+
+	// clear the allocated manager objects from memory
+	if (NULL != g_SceneManager)
+	{
+		delete g_SceneManager;
+		g_SceneManager = NULL;
+	}
+	if (NULL != g_FramePacer)
+	{
+		delete g_FramePacer;
+		g_FramePacer = NULL;
+	}
+	if (NULL != g_ViewManager)
+	{
+		delete g_ViewManager;
+		g_ViewManager = NULL;
+	}
+	if (NULL != g_UniformCache)
+	{
+		delete g_UniformCache;
+		g_UniformCache = NULL;
+	}
+	if (NULL != g_ShaderManager)
+	{
+		delete g_ShaderManager;
+		g_ShaderManager = NULL;
+	}
+	if (NULL != g_OffscreenContext)
+	{
+		delete g_OffscreenContext;
+		g_OffscreenContext = NULL;
+	}
+
+	// Terminates the program
+	exit(exitCode); 
+}
+
+/***********************************************************
+ *	RenderFrame()
+ *
+ *  This function is used to render one frame of the scene
+ *  into the window, or into the offscreen framebuffer.
+ ***********************************************************/
+void RenderFrame()
+{
+	PROFILE_GPU_SCOPE("Frame");
+
+	// Clear the frame and z buffers
+	{
+		PROFILE_SCOPE("Clear");
+		PROFILE_GPU_SCOPE("Clear");
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+
+	// convert from 3D object space to 2D view
+	{
+		PROFILE_SCOPE("PrepareSceneView");
+		g_ViewManager->PrepareSceneView();
+	}
+
+	// refresh the 3D scene, culling it against the view and
+	// sorting the draws from the camera
+	g_SceneManager->SetViewPosition(g_ViewManager->GetViewPosition());
+	g_SceneManager->SetViewProjection(g_ViewManager->GetProjectionMatrix() * g_ViewManager->GetViewMatrix());
+	g_SceneManager->RenderScene();
+}
+
+/***********************************************************
+ *	BuildFrame()
+ *
+ *  This function runs on the frame thread, to build the next
+ *  frame into a packet: it moves the camera, and culls,
+ *  sorts and gathers the scene from it.  Only the frame
+ *  thread moves the camera and the scene objects while it
+ *  runs.
+ ***********************************************************/
+void BuildFrame(FramePipeline::FRAME_PACKET& packet)
+{
+	{
+		PROFILE_SCOPE("UpdateCamera");
+		g_ViewManager->UpdateCamera();
+	}
+	packet.viewMatrix = g_ViewManager->GetViewMatrix();
+	packet.projectionMatrix = g_ViewManager->GetProjectionMatrix();
+	packet.viewPosition = g_ViewManager->GetViewPosition();
+	packet.bReplayFinished = g_ViewManager->IsReplayFinished();
+
+	g_SceneManager->SetViewPosition(packet.viewPosition);
+	g_SceneManager->SetViewProjection(packet.projectionMatrix * packet.viewMatrix);
+	g_SceneManager->BuildFramePacket(packet);
+}
+
+/***********************************************************
+ *	SubmitFrame()
+ *
+ *  This function is used to draw a frame built on the frame
+ *  thread into the window, or into the offscreen framebuffer.
+ ***********************************************************/
+void SubmitFrame(FramePipeline::FRAME_PACKET& packet)
+{
+	PROFILE_GPU_SCOPE("Frame");
+
+	// Clear the frame and z buffers
+	{
+		PROFILE_SCOPE("Clear");
+		PROFILE_GPU_SCOPE("Clear");
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	}
+
+	g_ViewManager->SetViewUniforms(packet.viewMatrix, packet.projectionMatrix, packet.viewPosition);
+	g_SceneManager->SubmitFramePacket(packet);
+}
+
+/***********************************************************
+ *	RunHeadlessBenchmark()
+ *
+ *  This function is used to render a number of frames into
+ *  the offscreen framebuffer and time each of them.  Since
+ *  there is no swap to wait on, each frame waits for OpenGL
+ *  to finish it, so the times include the rendering.  When a
+ *  camera path is passed in, the warmup frames replay its
+ *  start and the timed frames replay all of it.  A profiler
+ *  trace requested with SIGUSR1 is written between frames.
+ *  With the frame thread, each frame's time includes waiting
+ *  for its packet, when building it takes longer than
+ *  drawing the frame before.
+ ***********************************************************/
+void RunHeadlessBenchmark(int frameCount, int warmupFrames, const CameraPath* pReplayPath, float replayTimestep, const char* profileOutput, FrameTimings& frameTimings)
+{
+	frameTimings.Clear();
+	frameTimings.Reserve(frameCount);
+
+	// the frame thread moves the camera, so it restarts the replay
+	if (NULL != g_FramePipeline)
+	{
+		g_FramePipeline->Start([pReplayPath, replayTimestep, warmupFrames](FramePipeline::FRAME_PACKET& packet)
+		{
+			if ((NULL != pReplayPath) && ((packet.frameNumber == 0) || (packet.frameNumber == (uint64_t)warmupFrames)))
+			{
+				g_ViewManager->StartReplay(pReplayPath, replayTimestep);
+			}
+			BuildFrame(packet);
+		});
+	}
+
+	for (int frame = 0; frame < warmupFrames + frameCount; frame++)
+	{
+		if ((NULL == g_FramePipeline) && (NULL != pReplayPath) && ((frame == 0) || (frame == warmupFrames)))
+		{
+			g_ViewManager->StartReplay(pReplayPath, replayTimestep);
+		}
+
+		std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+
+		{
+			PROFILE_SCOPE("Frame");
+
+			g_UniformCache->BeginFrame();
+			RenderStats::BeginFrame();
+			Profiler::BeginFrame();
+			if (NULL != g_FramePipeline)
+			{
+				SubmitFrame(*g_FramePipeline->AcquirePacket());
+				g_FramePipeline->ReleasePacket();
+			}
+			else
+			{
+				RenderFrame();
+			}
+			{
+				PROFILE_SCOPE("Finish");
+				glFinish();
+			}
+		}
+		if (Profiler::IsDumpRequested())
+		{
+			Profiler::WriteChromeTrace(profileOutput);
+		}
+
+		if (frame >= warmupFrames)
+		{
+			frameTimings.AddFrame(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+		}
+	}
+
+	if (NULL != g_FramePipeline)
+	{
+		g_FramePipeline->Stop();
+	}
+}
+
+/***********************************************************
+ *	WriteBenchmarkResults()
+ *
+ *  This function is used to print the summary of a timed run
+ *  as one line of JSON, and to write it to a file as well
+ *  when one is passed in, along with the time of every frame
+ *  when a file for those is passed in.
+ ***********************************************************/
+int WriteBenchmarkResults(const char* name, const FrameTimings& frameTimings, const char* outputPath, const char* timingsPath)
+{
+	FrameTimings::SUMMARY summary = frameTimings.Summarize();
+	FrameTimings::WriteSummary(std::cout, name, summary);
+
+	if (NULL != outputPath)
+	{
+		std::ofstream outputFile(outputPath);
+		if (!outputFile)
+		{
+			std::cout << "ERROR: The benchmark results could not be written to " << outputPath << std::endl;
+			return(EXIT_FAILURE);
+		}
+		FrameTimings::WriteSummary(outputFile, name, summary);
+	}
+
+	if (NULL != timingsPath)
+	{
+		std::ofstream timingsFile(timingsPath);
+		if (!timingsFile)
+		{
+			std::cout << "ERROR: The frame timings could not be written to " << timingsPath << std::endl;
+			return(EXIT_FAILURE);
+		}
+		frameTimings.WriteFrames(timingsFile);
+	}
+
+	return(EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	InitializeGLFW()
+ * 
+ *  This function is used to initialize the GLFW library.   
+ ***********************************************************/
+bool InitializeGLFW()
+{
+	// GLFW: initialize and configure library
+	// --------------------------------------
+	glfwInit();
+
+#ifdef __APPLE__
+	// the shaders and the texture arrays need OpenGL 4.4, and macOS
+	// stops at 4.1
+	std::cout << "ERROR: OpenGL 4.4 is required, which macOS does not support" << std::endl;
+	glfwTerminate();
+	return(false);
+#else
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
+	// GLFW: end -------------------------------
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLEW()
+ *
+ *  This function is used to initialize the GLEW library.
+ ***********************************************************/
+bool InitializeGLEW(bool bHeadless)
+{
+	// GLEW: initialize
+	// -----------------------------------------
+	GLenum GLEWInitResult = GLEW_OK;
+
+	// try to initialize the GLEW library - glewInit() looks for
+	// the window system display, which the offscreen EGL context
+	// does not have, so headless only loads the OpenGL functions
+	if (bHeadless)
+	{
+		glewExperimental = GL_TRUE;
+		GLEWInitResult = glewContextInit();
+	}
+	else
+	{
+		GLEWInitResult = glewInit();
+	}
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return false;
+	}
+	// GLEW: end -------------------------------
+
+	// the shaders are written for GLSL 4.40
+	if (!GLEW_VERSION_4_4)
+	{
+		std::cout << "ERROR: OpenGL 4.4 is required, the driver provides " << glGetString(GL_VERSION) << std::endl;
+		return(false);
+	}
+
+	// Displays a successful OpenGL initialization message
+	std::cout << "INFO: OpenGL Successfully Initialized\n";
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *	HasCommandLineOption()
+ *
+ *  This function is used to check whether an option was
+ *  passed in on the command line.
+ ***********************************************************/
+bool HasCommandLineOption(int argc, char* argv[], const char* option)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], option) == 0)
+		{
+			return(true);
+		}
+	}
+
+	return(false);
+}
+/***********************************************************
+ *	GetCommandLineValue()
+ *
+ *  This function is used to get the value passed in on the
+ *  command line after an option, or NULL when the option was
+ *  not passed in.
+ ***********************************************************/
+const char* GetCommandLineValue(int argc, char* argv[], const char* option)
+{
+	for (int i = 1; i < argc - 1; i++)
+	{
+		if (strcmp(argv[i], option) == 0)
+		{
+			return(argv[i + 1]);
+		}
+	}
+
+	return(NULL);
+}
+/***********************************************************
+ *	GetCommandLineInt()
+ *
+ *  This function is used to get the number passed in on the
+ *  command line after an option, or the default value when
+ *  the option was not passed in or is negative.
+ ***********************************************************/
+int GetCommandLineInt(int argc, char* argv[], const char* option, int defaultValue)
+{
+	const char* value = GetCommandLineValue(argc, argv, option);
+
+	if ((NULL == value) || (atoi(value) < 0))
+	{
+		return(defaultValue);
+	}
+
+	return(atoi(value));
+}
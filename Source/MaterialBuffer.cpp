@@ -0,0 +1,106 @@
+///////////////////////////////////////////////////////////////////////////////
+// materialbuffer.cpp
+// ============
+// keep the scene materials in a uniform buffer indexed by each draw
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MaterialBuffer.h"
+#include "RenderStats.h"
+
+#include <iostream>
+
+static_assert(sizeof(MaterialBuffer::GPU_MATERIAL) == 48, "GPU_MATERIAL must match the std140 Material layout");
+
+/***********************************************************
+ *  MaterialBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MaterialBuffer::MaterialBuffer()
+{
+	m_bufferID = 0;
+	m_materialCount = 0;
+}
+
+/***********************************************************
+ *  ~MaterialBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MaterialBuffer::~MaterialBuffer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the uniform buffer with
+ *  room for the most materials the shader allows, uploading
+ *  the passed in materials into it, and binding it to the
+ *  material binding point.
+ ***********************************************************/
+bool MaterialBuffer::Create(const std::vector<GPU_MATERIAL>& materials)
+{
+	Destroy();
+
+	if (materials.size() > MAX_MATERIALS)
+	{
+		std::cout << "Too many materials for the material buffer:" << materials.size() << std::endl;
+		return(false);
+	}
+
+	m_materialCount = (int)materials.size();
+
+	glGenBuffers(1, &m_bufferID);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferData(GL_UNIFORM_BUFFER, MAX_MATERIALS * sizeof(GPU_MATERIAL), NULL, GL_DYNAMIC_DRAW);
+	if (m_materialCount > 0)
+	{
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, m_materialCount * sizeof(GPU_MATERIAL), materials.data());
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	// the buffer stays bound to its binding point for all draws
+	glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BINDING, m_bufferID);
+
+	return(true);
+}
+
+/***********************************************************
+ *  UpdateMaterial()
+ *
+ *  This method is used for rewriting the slot of the material
+ *  with the passed in index.  No other material is uploaded.
+ ***********************************************************/
+bool MaterialBuffer::UpdateMaterial(int index, const GPU_MATERIAL& material)
+{
+	if ((0 == m_bufferID) || (index < 0) || (index >= m_materialCount))
+	{
+		return(false);
+	}
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_bufferID);
+	glBufferSubData(GL_UNIFORM_BUFFER, index * sizeof(GPU_MATERIAL), sizeof(GPU_MATERIAL), &material);
+	RenderStats::Add(RenderStats::BUFFER_UPLOADS);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the uniform buffer.
+ ***********************************************************/
+void MaterialBuffer::Destroy()
+{
+	if (0 != m_bufferID)
+	{
+		glDeleteBuffers(1, &m_bufferID);
+		m_bufferID = 0;
+	}
+	m_materialCount = 0;
+}
@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+// materialbuffer.h
+// ============
+// keep the scene materials in a uniform buffer indexed by each draw
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  MaterialBuffer
+ *
+ *  This class stores every scene material in one std140
+ *  uniform buffer, which is uploaded once when the scene is
+ *  prepared.  A draw only passes the index of its material
+ *  to the shader, and changing a material later rewrites
+ *  just that material's slot in the buffer.
+ ***********************************************************/
+class MaterialBuffer
+{
+public:
+	// constructor
+	MaterialBuffer();
+	// destructor
+	~MaterialBuffer();
+
+	// most materials the buffer holds - this must match the
+	// size of the material array in the fragment shader
+	static const int MAX_MATERIALS = 256;
+	// uniform buffer binding point of the material block
+	static const GLuint MATERIAL_BINDING = 0;
+
+	// std140 layout of the Material struct in the fragment shader
+	struct GPU_MATERIAL
+	{
+		glm::vec3 ambientColor;
+		float ambientStrength;
+		glm::vec3 diffuseColor;
+		float padding;
+		glm::vec3 specularColor;
+		float shininess;
+	};
+
+	// create the uniform buffer and upload all of the materials
+	bool Create(const std::vector<GPU_MATERIAL>& materials);
+	// rewrite the slot of one material in the uniform buffer
+	bool UpdateMaterial(int index, const GPU_MATERIAL& material);
+	// free the uniform buffer
+	void Destroy();
+
+	// get the number of materials in the buffer
+	int GetMaterialCount() const { return m_materialCount; }
+
+private:
+	// OpenGL uniform buffer object
+	GLuint m_bufferID;
+	// number of materials in the buffer
+	int m_materialCount;
+};
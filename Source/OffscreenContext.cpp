@@ -0,0 +1,263 @@
+///////////////////////////////////////////////////////////////////////////////
+// offscreencontext.cpp
+// ============
+// render without a display window, into an offscreen framebuffer
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OffscreenContext.h"
+
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// OpenGL versions to ask for, from the newest down to the
+	// oldest one the shaders can run on
+	const int g_ContextVersions[][2] = { { 4, 6 }, { 4, 5 }, { 4, 4 } };
+}
+
+/***********************************************************
+ *  OffscreenContext()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+OffscreenContext::OffscreenContext()
+{
+	m_display = NULL;
+	m_context = NULL;
+	m_framebuffer = 0;
+	m_colorBuffer = 0;
+	m_depthBuffer = 0;
+	m_width = 0;
+	m_height = 0;
+}
+
+/***********************************************************
+ *  ~OffscreenContext()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+OffscreenContext::~OffscreenContext()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  CreateContext()
+ *
+ *  This method is used for creating an OpenGL core profile
+ *  context with no window and making it current.  The Mesa
+ *  surfaceless platform is used when EGL offers it, since it
+ *  needs no display server at all, and the default display
+ *  otherwise.  The context renders into the framebuffer made
+ *  by CreateFramebuffer(), so it needs no surface.
+ ***********************************************************/
+bool OffscreenContext::CreateContext()
+{
+#ifdef __linux__
+	EGLDisplay display = EGL_NO_DISPLAY;
+	EGLint majorVersion = 0;
+	EGLint minorVersion = 0;
+
+	const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if ((NULL != clientExtensions) && (NULL != getPlatformDisplay) &&
+		(NULL != strstr(clientExtensions, "EGL_MESA_platform_surfaceless")))
+	{
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	}
+	if (EGL_NO_DISPLAY == display)
+	{
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	}
+	if ((EGL_NO_DISPLAY == display) || (eglInitialize(display, &majorVersion, &minorVersion) == EGL_FALSE))
+	{
+		std::cout << "ERROR: EGL could not be initialized" << std::endl;
+		return(false);
+	}
+	m_display = display;
+
+	if (eglBindAPI(EGL_OPENGL_API) == EGL_FALSE)
+	{
+		std::cout << "ERROR: EGL does not support OpenGL" << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	const EGLint configAttributes[] =
+	{
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_NONE
+	};
+	EGLConfig config = NULL;
+	EGLint configCount = 0;
+	if ((eglChooseConfig(display, configAttributes, &config, 1, &configCount) == EGL_FALSE) || (configCount < 1))
+	{
+		// a context that never has a surface does not need a config
+		config = (EGLConfig)0;
+	}
+
+	EGLContext context = EGL_NO_CONTEXT;
+	for (size_t i = 0; (i < sizeof(g_ContextVersions) / sizeof(g_ContextVersions[0])) && (EGL_NO_CONTEXT == context); i++)
+	{
+		const EGLint contextAttributes[] =
+		{
+			EGL_CONTEXT_MAJOR_VERSION, g_ContextVersions[i][0],
+			EGL_CONTEXT_MINOR_VERSION, g_ContextVersions[i][1],
+			EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+			EGL_NONE
+		};
+		context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	}
+	if (EGL_NO_CONTEXT == context)
+	{
+		std::cout << "ERROR: An OpenGL 4.4 or newer context could not be created, EGL error 0x"
+			<< std::hex << eglGetError() << std::dec << std::endl;
+		Destroy();
+		return(false);
+	}
+	m_context = context;
+
+	if (eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context) == EGL_FALSE)
+	{
+		std::cout << "ERROR: The offscreen OpenGL context could not be made current" << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	return(true);
+#else
+	std::cout << "ERROR: Offscreen rendering is only supported on Linux" << std::endl;
+	return(false);
+#endif
+}
+
+/***********************************************************
+ *  CreateFramebuffer()
+ *
+ *  This method is used for creating the framebuffer that
+ *  the scene is rendered into, with a color and a depth
+ *  buffer of the passed in size, and binding it in place of
+ *  the window that the context does not have.
+ ***********************************************************/
+bool OffscreenContext::CreateFramebuffer(int width, int height)
+{
+	if ((NULL == m_context) || (width <= 0) || (height <= 0))
+	{
+		std::cout << "ERROR: The offscreen framebuffer needs a context and a size" << std::endl;
+		return(false);
+	}
+
+	m_width = width;
+	m_height = height;
+
+	glGenRenderbuffers(1, &m_colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "ERROR: The offscreen framebuffer is not complete" << std::endl;
+		return(false);
+	}
+
+	Bind();
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the framebuffer and the
+ *  context.
+ ***********************************************************/
+void OffscreenContext::Destroy()
+{
+	if ((NULL != m_context) && (0 != m_framebuffer))
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glDeleteFramebuffers(1, &m_framebuffer);
+		glDeleteRenderbuffers(1, &m_colorBuffer);
+		glDeleteRenderbuffers(1, &m_depthBuffer);
+	}
+	m_framebuffer = 0;
+	m_colorBuffer = 0;
+	m_depthBuffer = 0;
+
+#ifdef __linux__
+	if (NULL != m_display)
+	{
+		eglMakeCurrent((EGLDisplay)m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (NULL != m_context)
+		{
+			eglDestroyContext((EGLDisplay)m_display, (EGLContext)m_context);
+		}
+		eglTerminate((EGLDisplay)m_display);
+	}
+#endif
+	m_display = NULL;
+	m_context = NULL;
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the framebuffer, so the
+ *  scene is rendered into it, with the viewport covering it.
+ ***********************************************************/
+void OffscreenContext::Bind() const
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, m_width, m_height);
+}
+
+/***********************************************************
+ *  ReadPixels()
+ *
+ *  This method is used for reading back the rendered image.
+ *  OpenGL returns the rows from the bottom up, so they are
+ *  flipped to run from the top down like an image file.
+ ***********************************************************/
+bool OffscreenContext::ReadPixels(std::vector<unsigned char>& pixels) const
+{
+	if (0 == m_framebuffer)
+	{
+		return(false);
+	}
+
+	size_t rowBytes = (size_t)m_width * 4;
+	std::vector<unsigned char> bottomUp(rowBytes * m_height);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, bottomUp.data());
+
+	pixels.resize(bottomUp.size());
+	for (int row = 0; row < m_height; row++)
+	{
+		memcpy(&pixels[row * rowBytes], &bottomUp[(m_height - 1 - row) * rowBytes], rowBytes);
+	}
+
+	return(true);
+}
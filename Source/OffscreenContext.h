@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+// offscreencontext.h
+// ============
+// render without a display window, into an offscreen framebuffer
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <vector>
+
+/***********************************************************
+ *  OffscreenContext
+ *
+ *  This class creates an OpenGL context that has no window,
+ *  through EGL, so the scene can be rendered on machines that
+ *  have no display, such as build servers using the Mesa
+ *  llvmpipe software renderer.  The context is created before
+ *  GLEW is initialized, and the framebuffer that the scene is
+ *  rendered into is created after, since it needs the OpenGL
+ *  functions that GLEW loads.  EGL is only used on Linux, and
+ *  creating the context fails on other platforms.
+ ***********************************************************/
+class OffscreenContext
+{
+public:
+	// constructor
+	OffscreenContext();
+	// destructor
+	~OffscreenContext();
+
+	// create the context and make it current
+	bool CreateContext();
+	// create the framebuffer the scene is rendered into, and bind it
+	bool CreateFramebuffer(int width, int height);
+	// free the framebuffer and the context
+	void Destroy();
+
+	// bind the framebuffer and set the viewport to its size
+	void Bind() const;
+	// read the rendered pixels, as rows of RGBA bytes from the top
+	bool ReadPixels(std::vector<unsigned char>& pixels) const;
+
+	// get the size of the framebuffer
+	int GetWidth() const { return m_width; }
+	int GetHeight() const { return m_height; }
+
+private:
+	// EGL display and context, kept untyped so that this header
+	// does not need the EGL headers
+	void* m_display;
+	void* m_context;
+	// framebuffer and its color and depth render buffers
+	GLuint m_framebuffer;
+	GLuint m_colorBuffer;
+	GLuint m_depthBuffer;
+	// size of the framebuffer
+	int m_width;
+	int m_height;
+};
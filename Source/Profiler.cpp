@@ -0,0 +1,415 @@
+///////////////////////////////////////////////////////////////////////////////
+// profiler.cpp
+// ============
+// time the phases of each frame on the CPU and the GPU
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// number of events the ring buffer holds, a power of two so
+	// that an event's slot is its number masked
+	const uint64_t EVENT_CAPACITY = 1 << 16;
+	// number of threads that can be named in the trace
+	const int MAX_TRACKS = 32;
+	// the trace track that the GPU events are shown on
+	const int GPU_TRACK = 1000;
+	// number of frames that GPU times are kept for before they
+	// are read back, and GPU scopes timed in each frame
+	const int GPU_FRAME_LATENCY = 4;
+	const int MAX_GPU_SCOPES = 64;
+
+	// one timed event.  The sequence is the event's number plus
+	// one once it is written, and zero while it is being written,
+	// so that a reader can tell whether the event it copied was
+	// overwritten at the same time
+	struct EVENT
+	{
+		std::atomic<uint64_t> sequence;
+		const char* name;
+		int64_t startNanoseconds;
+		int64_t durationNanoseconds;
+		int track;
+	};
+
+	// the GPU scopes of one frame, with a start and an end
+	// timestamp query for each
+	struct GPU_FRAME
+	{
+		GLuint queries[MAX_GPU_SCOPES * 2];
+		const char* names[MAX_GPU_SCOPES];
+		int scopeCount;
+		// the CPU time minus the GPU time when the frame started
+		int64_t offsetNanoseconds;
+	};
+
+	EVENT g_Events[EVENT_CAPACITY];
+	std::atomic<uint64_t> g_NextEvent(0);
+
+	std::atomic<int> g_NextTrack(0);
+	std::atomic<const char*> g_TrackNames[MAX_TRACKS];
+	thread_local int t_Track = -1;
+
+	const std::chrono::steady_clock::time_point g_StartTime = std::chrono::steady_clock::now();
+
+	volatile std::sig_atomic_t g_bDumpRequested = 0;
+
+	// the GPU state is only used on the thread that owns the
+	// OpenGL context
+	GPU_FRAME g_GpuFrames[GPU_FRAME_LATENCY];
+	int g_GpuFrame = 0;
+	bool g_bGpuFrameActive = false;
+	bool g_bGpuQueriesCreated = false;
+
+	/***********************************************************
+	 *  GetTrack()
+	 *
+	 *  This function is used for getting the trace track of the
+	 *  calling thread, giving it the next one the first time.
+	 ***********************************************************/
+	int GetTrack()
+	{
+		if (t_Track < 0)
+		{
+			t_Track = g_NextTrack.fetch_add(1, std::memory_order_relaxed);
+		}
+		return(t_Track);
+	}
+
+	/***********************************************************
+	 *  WriteEvent()
+	 *
+	 *  This function is used for writing an event into the next
+	 *  slot of the ring buffer, over the oldest event.
+	 ***********************************************************/
+	void WriteEvent(const char* name, int64_t startNanoseconds, int64_t durationNanoseconds, int track)
+	{
+		uint64_t number = g_NextEvent.fetch_add(1, std::memory_order_relaxed);
+		EVENT& event = g_Events[number & (EVENT_CAPACITY - 1)];
+
+		event.sequence.store(0, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		event.name = name;
+		event.startNanoseconds = startNanoseconds;
+		event.durationNanoseconds = durationNanoseconds;
+		event.track = track;
+		event.sequence.store(number + 1, std::memory_order_release);
+	}
+
+	/***********************************************************
+	 *  IsTimerQuerySupported()
+	 *
+	 *  This function is used for checking whether OpenGL can
+	 *  record timestamps.
+	 ***********************************************************/
+	bool IsTimerQuerySupported()
+	{
+		return(GLEW_VERSION_3_3 || GLEW_ARB_timer_query);
+	}
+
+	/***********************************************************
+	 *  ReadGpuFrame()
+	 *
+	 *  This function is used for adding the GPU scopes of a
+	 *  frame as events, if the GPU has finished all of them,
+	 *  and dropping them otherwise.  Nested scopes end in a
+	 *  different order than they start, so every end query is
+	 *  checked.
+	 ***********************************************************/
+	void ReadGpuFrame(GPU_FRAME& frame)
+	{
+		GLint bAvailable = GL_TRUE;
+		for (int i = 0; (bAvailable == GL_TRUE) && (i < frame.scopeCount); i++)
+		{
+			glGetQueryObjectiv(frame.queries[i * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+		}
+
+		if (bAvailable == GL_TRUE)
+		{
+			for (int i = 0; i < frame.scopeCount; i++)
+			{
+				GLuint64 start = 0;
+				GLuint64 end = 0;
+				glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &start);
+				glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+
+				WriteEvent(frame.names[i], (int64_t)start + frame.offsetNanoseconds, (int64_t)(end - start), GPU_TRACK);
+			}
+		}
+		frame.scopeCount = 0;
+	}
+
+	/***********************************************************
+	 *  WriteTrackName()
+	 *
+	 *  This function is used for writing the trace record that
+	 *  names a track.
+	 ***********************************************************/
+	void WriteTrackName(std::ostream& output, int track, const char* name, bool bFirst)
+	{
+		output << (bFirst ? "\n" : ",\n")
+			<< "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << track
+			<< ", \"args\": {\"name\": \"" << name << "\"}}";
+	}
+
+#ifdef SIGUSR1
+	/***********************************************************
+	 *  HandleDumpSignal()
+	 *
+	 *  This function is used for requesting a dump when the
+	 *  process gets the dump signal.
+	 ***********************************************************/
+	void HandleDumpSignal(int)
+	{
+		g_bDumpRequested = 1;
+	}
+#endif
+}
+
+std::atomic<bool> Profiler::s_bEnabled(false);
+
+/***********************************************************
+ *  SetEnabled()
+ *
+ *  This method is used for turning recording on or off.
+ ***********************************************************/
+void Profiler::SetEnabled(bool bEnabled)
+{
+	s_bEnabled.store(bEnabled, std::memory_order_relaxed);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting a frame.  The GPU scopes
+ *  of the frame that used the next set of queries, a few
+ *  frames ago, are read back first, and the difference
+ *  between the CPU and GPU clocks is taken so that the GPU
+ *  events line up with the CPU ones in the trace.
+ ***********************************************************/
+void Profiler::BeginFrame()
+{
+	g_bGpuFrameActive = false;
+	if ((IsEnabled() == false) || (IsTimerQuerySupported() == false))
+	{
+		return;
+	}
+
+	if (g_bGpuQueriesCreated == false)
+	{
+		for (int i = 0; i < GPU_FRAME_LATENCY; i++)
+		{
+			glGenQueries(MAX_GPU_SCOPES * 2, g_GpuFrames[i].queries);
+			g_GpuFrames[i].scopeCount = 0;
+		}
+		g_bGpuQueriesCreated = true;
+	}
+
+	g_GpuFrame = (g_GpuFrame + 1) % GPU_FRAME_LATENCY;
+	GPU_FRAME& frame = g_GpuFrames[g_GpuFrame];
+	ReadGpuFrame(frame);
+
+	GLint64 gpuTime = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+	frame.offsetNanoseconds = GetTime() - (int64_t)gpuTime;
+	g_bGpuFrameActive = true;
+}
+
+/***********************************************************
+ *  SetThreadName()
+ *
+ *  This method is used for naming the calling thread in the
+ *  trace.  The name must outlive the profiler.
+ ***********************************************************/
+void Profiler::SetThreadName(const char* name)
+{
+	int track = GetTrack();
+	if (track < MAX_TRACKS)
+	{
+		g_TrackNames[track].store(name, std::memory_order_relaxed);
+	}
+}
+
+/***********************************************************
+ *  AddEvent()
+ *
+ *  This method is used for adding a CPU event of the calling
+ *  thread.
+ ***********************************************************/
+void Profiler::AddEvent(const char* name, int64_t startNanoseconds, int64_t durationNanoseconds)
+{
+	WriteEvent(name, startNanoseconds, durationNanoseconds, GetTrack());
+}
+
+/***********************************************************
+ *  GetTime()
+ *
+ *  This method is used for getting the time since the
+ *  profiler started, in nanoseconds.
+ ***********************************************************/
+int64_t Profiler::GetTime()
+{
+	return(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_StartTime).count());
+}
+
+/***********************************************************
+ *  BeginGpuScope()
+ *
+ *  This method is used for recording the GPU time before the
+ *  commands of a scope.  Scopes are not recorded before the
+ *  first frame starts or past the most a frame can hold.
+ ***********************************************************/
+int Profiler::BeginGpuScope(const char* name)
+{
+	GPU_FRAME& frame = g_GpuFrames[g_GpuFrame];
+	if ((g_bGpuFrameActive == false) || (frame.scopeCount >= MAX_GPU_SCOPES))
+	{
+		return(-1);
+	}
+
+	int scope = frame.scopeCount++;
+	frame.names[scope] = name;
+	glQueryCounter(frame.queries[scope * 2], GL_TIMESTAMP);
+
+	return(scope);
+}
+
+/***********************************************************
+ *  EndGpuScope()
+ *
+ *  This method is used for recording the GPU time after the
+ *  commands of a scope.
+ ***********************************************************/
+void Profiler::EndGpuScope(int scope)
+{
+	glQueryCounter(g_GpuFrames[g_GpuFrame].queries[scope * 2 + 1], GL_TIMESTAMP);
+}
+
+/***********************************************************
+ *  WriteChromeTrace()
+ *
+ *  This method is used for writing the events in the ring
+ *  buffer in the Chrome trace format, with times in
+ *  microseconds.  Events that are overwritten while they are
+ *  being copied are left out.
+ ***********************************************************/
+void Profiler::WriteChromeTrace(std::ostream& output)
+{
+	uint64_t lastEvent = g_NextEvent.load(std::memory_order_acquire);
+	uint64_t firstEvent = (lastEvent > EVENT_CAPACITY) ? lastEvent - EVENT_CAPACITY : 0;
+
+	std::ios::fmtflags flags = output.flags();
+	std::streamsize precision = output.precision();
+
+	output << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+	int trackCount = std::min(g_NextTrack.load(std::memory_order_relaxed), MAX_TRACKS);
+	for (int track = 0; track < trackCount; track++)
+	{
+		const char* name = g_TrackNames[track].load(std::memory_order_relaxed);
+		WriteTrackName(output, track, (NULL != name) ? name : "Thread", track == 0);
+	}
+	WriteTrackName(output, GPU_TRACK, "GPU", trackCount == 0);
+
+	output << std::fixed << std::setprecision(3);
+	for (uint64_t number = firstEvent; number < lastEvent; number++)
+	{
+		EVENT& event = g_Events[number & (EVENT_CAPACITY - 1)];
+
+		uint64_t sequence = event.sequence.load(std::memory_order_acquire);
+		const char* name = event.name;
+		int64_t startNanoseconds = event.startNanoseconds;
+		int64_t durationNanoseconds = event.durationNanoseconds;
+		int track = event.track;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if ((sequence != number + 1) || (event.sequence.load(std::memory_order_relaxed) != sequence))
+		{
+			continue;
+		}
+
+		output << ",\n{\"name\": \"" << name << "\""
+			<< ", \"cat\": \"" << ((GPU_TRACK == track) ? "gpu" : "cpu") << "\""
+			<< ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << track
+			<< ", \"ts\": " << (double)startNanoseconds / 1000.0
+			<< ", \"dur\": " << (double)durationNanoseconds / 1000.0 << "}";
+	}
+	output << "\n]}" << std::endl;
+
+	output.flags(flags);
+	output.precision(precision);
+}
+
+/***********************************************************
+ *  WriteChromeTrace()
+ *
+ *  This method is used for writing the events in the ring
+ *  buffer to a Chrome trace file.
+ ***********************************************************/
+bool Profiler::WriteChromeTrace(const char* path)
+{
+	std::ofstream outputFile(path);
+	if (!outputFile)
+	{
+		std::cout << "ERROR: The profiler trace could not be written to " << path << std::endl;
+		return(false);
+	}
+
+	WriteChromeTrace(outputFile);
+	std::cout << "Profiler trace written to " << path << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  RequestDump()
+ *
+ *  This method is used for asking for the events to be
+ *  written out.  It only sets a flag, so that it can be
+ *  called from a signal handler.
+ ***********************************************************/
+void Profiler::RequestDump()
+{
+	g_bDumpRequested = 1;
+}
+
+/***********************************************************
+ *  IsDumpRequested()
+ *
+ *  This method is used for checking whether the events were
+ *  asked for, clearing the request.
+ ***********************************************************/
+bool Profiler::IsDumpRequested()
+{
+	if (g_bDumpRequested == 0)
+	{
+		return(false);
+	}
+
+	g_bDumpRequested = 0;
+	return(true);
+}
+
+/***********************************************************
+ *  InstallSignalHandler()
+ *
+ *  This method is used for requesting a dump whenever the
+ *  process gets SIGUSR1.  Windows has no such signal, so
+ *  there the dump can only be requested with the key.
+ ***********************************************************/
+void Profiler::InstallSignalHandler()
+{
+#ifdef SIGUSR1
+	signal(SIGUSR1, HandleDumpSignal);
+#endif
+}
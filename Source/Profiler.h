@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// profiler.h
+// ============
+// time the phases of each frame on the CPU and the GPU
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+/***********************************************************
+ *  Profiler
+ *
+ *  This class records how long the phases of each frame take,
+ *  on the CPU with scoped timers and on the GPU with OpenGL
+ *  timestamp queries.  Every phase is written as an event
+ *  into a ring buffer that threads add to without locking, so
+ *  it always holds the most recent events, and the events can
+ *  be written out as a Chrome trace, to be opened in
+ *  chrome://tracing or Perfetto.
+ *
+ *  The profiler is compiled in but turned off until it is
+ *  enabled, and while it is off each timed scope only checks
+ *  one flag.  GPU times are read back a few frames after they
+ *  are recorded, so that the CPU never waits on the GPU, and
+ *  are dropped if the GPU has not finished them by then.
+ ***********************************************************/
+class Profiler
+{
+public:
+	// turn recording on or off
+	static void SetEnabled(bool bEnabled);
+	// check whether events are recorded
+	static bool IsEnabled() { return s_bEnabled.load(std::memory_order_relaxed); }
+
+	// start a frame, reading back the GPU times of an earlier
+	// frame, which must be called on the thread that owns the
+	// OpenGL context
+	static void BeginFrame();
+
+	// name the calling thread in the trace
+	static void SetThreadName(const char* name);
+
+	// add a CPU event, with times from GetTime()
+	static void AddEvent(const char* name, int64_t startNanoseconds, int64_t durationNanoseconds);
+	// get the time since the profiler started, in nanoseconds
+	static int64_t GetTime();
+
+	// start and end a GPU timed scope, which returns -1 when the
+	// scope is not recorded
+	static int BeginGpuScope(const char* name);
+	static void EndGpuScope(int scope);
+
+	// write the recorded events as a Chrome trace
+	static void WriteChromeTrace(std::ostream& output);
+	static bool WriteChromeTrace(const char* path);
+
+	// ask for the events to be written, which is safe to call
+	// from a signal handler, and check for the request
+	static void RequestDump();
+	static bool IsDumpRequested();
+	// request a dump when the process gets SIGUSR1, where the
+	// platform has it
+	static void InstallSignalHandler();
+
+private:
+	static std::atomic<bool> s_bEnabled;
+};
+
+/***********************************************************
+ *  ProfileScope
+ *
+ *  This class times the CPU work of the scope that it is
+ *  declared in.  The name must be a string that outlives the
+ *  profiler, such as a string literal.
+ ***********************************************************/
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* name)
+	{
+		m_name = Profiler::IsEnabled() ? name : NULL;
+		m_start = (NULL != m_name) ? Profiler::GetTime() : 0;
+	}
+	~ProfileScope()
+	{
+		if (NULL != m_name)
+		{
+			Profiler::AddEvent(m_name, m_start, Profiler::GetTime() - m_start);
+		}
+	}
+
+private:
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+	const char* m_name;
+	int64_t m_start;
+};
+
+/***********************************************************
+ *  GpuProfileScope
+ *
+ *  This class times the GPU work of the OpenGL commands that
+ *  are issued in the scope that it is declared in.
+ ***********************************************************/
+class GpuProfileScope
+{
+public:
+	explicit GpuProfileScope(const char* name)
+	{
+		m_scope = Profiler::IsEnabled() ? Profiler::BeginGpuScope(name) : -1;
+	}
+	~GpuProfileScope()
+	{
+		if (m_scope >= 0)
+		{
+			Profiler::EndGpuScope(m_scope);
+		}
+	}
+
+private:
+	GpuProfileScope(const GpuProfileScope&) = delete;
+	GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+	int m_scope;
+};
+
+// time the rest of the enclosing scope, on the CPU or on the
+// GPU, unless the profiler is compiled out with PROFILER_DISABLED
+#define PROFILER_JOIN_NAME(name, line) name##line
+#define PROFILER_SCOPE_NAME(name, line) PROFILER_JOIN_NAME(name, line)
+#ifndef PROFILER_DISABLED
+#define PROFILE_SCOPE(name) ProfileScope PROFILER_SCOPE_NAME(profileScope, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) GpuProfileScope PROFILER_SCOPE_NAME(gpuProfileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_GPU_SCOPE(name)
+#endif
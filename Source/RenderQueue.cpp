@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.cpp
+// ============
+// sort the draws of a frame so that state only changes when it must
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+/***********************************************************
+ *  RenderQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderQueue::RenderQueue()
+{
+	m_unsortedStateChanges = 0;
+	m_sortedStateChanges = 0;
+}
+
+/***********************************************************
+ *  MakeSortKey()
+ *
+ *  This method is used for packing the mesh, texture and
+ *  material of a draw, and its depth from 0 (near) to 1
+ *  (far), into a sort key.  Fields that are too large for
+ *  their bits are clamped.
+ ***********************************************************/
+uint64_t RenderQueue::MakeSortKey(
+	uint32_t mesh,
+	uint32_t texture,
+	uint32_t material,
+	float depth)
+{
+	const uint32_t depthMax = (1u << DEPTH_BITS) - 1;
+
+	mesh = std::min<uint32_t>(mesh, (1u << MESH_BITS) - 1);
+	texture = std::min<uint32_t>(texture, (1u << TEXTURE_BITS) - 1);
+	material = std::min<uint32_t>(material, (1u << MATERIAL_BITS) - 1);
+	depth = std::min(std::max(depth, 0.0f), 1.0f);
+
+	uint64_t sortKey = mesh;
+	sortKey = (sortKey << TEXTURE_BITS) | texture;
+	sortKey = (sortKey << MATERIAL_BITS) | material;
+	sortKey = (sortKey << DEPTH_BITS) | (uint32_t)(depth * depthMax);
+
+	return(sortKey);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all of the draw items.
+ *  The memory of the queue is kept for the next frame.
+ ***********************************************************/
+void RenderQueue::Clear()
+{
+	m_items.clear();
+}
+
+/***********************************************************
+ *  AddItem()
+ *
+ *  This method is used for adding a draw item to the queue.
+ ***********************************************************/
+void RenderQueue::AddItem(uint64_t sortKey, uint32_t objectIndex)
+{
+	DRAW_ITEM item;
+	item.sortKey = sortKey;
+	item.objectIndex = objectIndex;
+	m_items.push_back(item);
+}
+
+/***********************************************************
+ *  Sort()
+ *
+ *  This method is used for sorting the draw items by their
+ *  sort keys with a least significant digit radix sort, one
+ *  byte at a time.  The sort is stable, so items with equal
+ *  keys stay in submission order.  A byte that is the same
+ *  in every key does not change the order, so its pass is
+ *  skipped.
+ ***********************************************************/
+void RenderQueue::Sort()
+{
+	m_unsortedStateChanges = CountStateChanges();
+
+	size_t itemCount = m_items.size();
+	m_sortBuffer.resize(itemCount);
+
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		size_t counts[256] = { 0 };
+
+		for (size_t i = 0; i < itemCount; i++)
+		{
+			counts[(m_items[i].sortKey >> shift) & 0xFF]++;
+		}
+		if ((itemCount == 0) || (counts[(m_items[0].sortKey >> shift) & 0xFF] == itemCount))
+		{
+			continue;
+		}
+
+		size_t offset = 0;
+		for (int digit = 0; digit < 256; digit++)
+		{
+			size_t count = counts[digit];
+			counts[digit] = offset;
+			offset += count;
+		}
+
+		for (size_t i = 0; i < itemCount; i++)
+		{
+			m_sortBuffer[counts[(m_items[i].sortKey >> shift) & 0xFF]++] = m_items[i];
+		}
+		m_items.swap(m_sortBuffer);
+	}
+
+	m_sortedStateChanges = CountStateChanges();
+}
+
+/***********************************************************
+ *  CountStateChanges()
+ *
+ *  This method is used for counting how many times the mesh,
+ *  texture and material change from one draw item to the next,
+ *  in the current order of the items.  The first item sets
+ *  all three.
+ ***********************************************************/
+unsigned int RenderQueue::CountStateChanges() const
+{
+	unsigned int stateChanges = 0;
+
+	for (size_t i = 0; i < m_items.size(); i++)
+	{
+		uint64_t sortKey = m_items[i].sortKey;
+
+		if ((i == 0) || (GetMesh(sortKey) != GetMesh(m_items[i - 1].sortKey)))
+		{
+			stateChanges++;
+		}
+		if ((i == 0) || (GetTexture(sortKey) != GetTexture(m_items[i - 1].sortKey)))
+		{
+			stateChanges++;
+		}
+		if ((i == 0) || (GetMaterial(sortKey) != GetMaterial(m_items[i - 1].sortKey)))
+		{
+			stateChanges++;
+		}
+	}
+
+	return(stateChanges);
+}
@@ -0,0 +1,82 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.h
+// ============
+// sort the draws of a frame so that state only changes when it must
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  RenderQueue
+ *
+ *  This class collects the draw items of a frame, each with a
+ *  packed 64 bit sort key, and radix sorts them by key.  The
+ *  key holds, from the most to the least significant bits,
+ *  the mesh, the texture, the material and the depth, so the
+ *  sorted draws are grouped by mesh, then by texture and then
+ *  by material, and are drawn front to back within a group.
+ *  The queue counts the mesh, texture and material changes of
+ *  the frame in both submission and sorted order, to report
+ *  how many state changes the sort avoided.
+ ***********************************************************/
+class RenderQueue
+{
+public:
+	// constructor
+	RenderQueue();
+
+	struct DRAW_ITEM
+	{
+		uint64_t sortKey;
+		uint32_t objectIndex;
+	};
+
+	// bits of each field of the sort key
+	static const int MESH_BITS = 8;
+	static const int TEXTURE_BITS = 16;
+	static const int MATERIAL_BITS = 16;
+	static const int DEPTH_BITS = 24;
+
+	// pack the state and depth of a draw into a sort key
+	static uint64_t MakeSortKey(
+		uint32_t mesh,
+		uint32_t texture,
+		uint32_t material,
+		float depth);
+	// get the fields of a sort key
+	static uint32_t GetMesh(uint64_t sortKey) { return (uint32_t)(sortKey >> (TEXTURE_BITS + MATERIAL_BITS + DEPTH_BITS)); }
+	static uint32_t GetTexture(uint64_t sortKey) { return (uint32_t)(sortKey >> (MATERIAL_BITS + DEPTH_BITS)) & ((1u << TEXTURE_BITS) - 1); }
+	static uint32_t GetMaterial(uint64_t sortKey) { return (uint32_t)(sortKey >> DEPTH_BITS) & ((1u << MATERIAL_BITS) - 1); }
+
+	// remove all of the draw items, to start a new frame
+	void Clear();
+	// add a draw item to the queue
+	void AddItem(uint64_t sortKey, uint32_t objectIndex);
+	// sort the draw items by their sort keys
+	void Sort();
+
+	// get the draw items, in sorted order after Sort()
+	const std::vector<DRAW_ITEM>& GetItems() const { return m_items; }
+
+	// get the state changes of the last sorted frame
+	unsigned int GetStateChanges() const { return m_sortedStateChanges; }
+	unsigned int GetUnsortedStateChanges() const { return m_unsortedStateChanges; }
+	unsigned int GetAvoidedStateChanges() const { return m_unsortedStateChanges - m_sortedStateChanges; }
+
+private:
+	// the draw items of the frame
+	std::vector<DRAW_ITEM> m_items;
+	// scratch space for the radix sort
+	std::vector<DRAW_ITEM> m_sortBuffer;
+	// state changes in submission and in sorted order
+	unsigned int m_unsortedStateChanges;
+	unsigned int m_sortedStateChanges;
+
+	// count the mesh, texture and material changes of the items
+	unsigned int CountStateChanges() const;
+};
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderstats.cpp
+// ============
+// count the draw calls, uploads and state changes of each frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderStats.h"
+
+// declaration of global variables
+namespace
+{
+	// counter names, in the order of the counters
+	const char* const g_CounterNames[RenderStats::COUNTER_COUNT] =
+	{
+		"draw calls",
+		"objects",
+		"culled",
+		"triangles",
+		"uniforms",
+		"uniforms skipped",
+		"texture binds",
+		"buffer uploads",
+		"state changes"
+	};
+}
+
+uint64_t RenderStats::s_frameCounts[RenderStats::COUNTER_COUNT] = {};
+uint64_t RenderStats::s_lastFrameCounts[RenderStats::COUNTER_COUNT] = {};
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for keeping the counts of the frame
+ *  that just finished and clearing them for the next one.
+ ***********************************************************/
+void RenderStats::BeginFrame()
+{
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		s_lastFrameCounts[i] = s_frameCounts[i];
+		s_frameCounts[i] = 0;
+	}
+}
+
+/***********************************************************
+ *  GetCounterName()
+ *
+ *  This method is used for getting the name of a counter.
+ ***********************************************************/
+const char* RenderStats::GetCounterName(COUNTER counter)
+{
+	if ((counter < 0) || (counter >= COUNTER_COUNT))
+	{
+		return("unknown");
+	}
+
+	return(g_CounterNames[counter]);
+}
+
+/***********************************************************
+ *  WriteLine()
+ *
+ *  This method is used for writing every count of the last
+ *  finished frame on one line.
+ ***********************************************************/
+void RenderStats::WriteLine(std::ostream& output)
+{
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		output << ((i == 0) ? "" : ", ") << g_CounterNames[i] << ": " << s_lastFrameCounts[i];
+	}
+	output << std::endl;
+}
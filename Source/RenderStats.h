@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderstats.h
+// ============
+// count the draw calls, uploads and state changes of each frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+/***********************************************************
+ *  RenderStats
+ *
+ *  This class counts the OpenGL work of each frame: the draw
+ *  calls, the objects and triangles they draw, the uniform
+ *  writes, texture binds and buffer uploads, and the other
+ *  state changes.  The classes that make the OpenGL calls add
+ *  to the counters, BeginFrame() closes the counts of the
+ *  frame before, and those counts can be read by name, so
+ *  that tests can check them, or written as one line.
+ *
+ *  The counters are only added to on the thread that owns the
+ *  OpenGL context, and are not synchronized.
+ ***********************************************************/
+class RenderStats
+{
+public:
+	enum COUNTER
+	{
+		// draw calls made, counting a multi-draw as one call
+		DRAW_CALLS = 0,
+		// objects drawn and culled
+		DRAWN_OBJECTS,
+		CULLED_OBJECTS,
+		// triangles drawn, over every instance
+		TRIANGLES,
+		// uniform values written, and writes skipped by the cache
+		UNIFORM_UPLOADS,
+		UNIFORMS_SKIPPED,
+		// textures bound
+		TEXTURE_BINDS,
+		// buffer uploads
+		BUFFER_UPLOADS,
+		// vertex array and buffer bindings that the draws need
+		STATE_CHANGES,
+		COUNTER_COUNT
+	};
+
+	// add to a counter of the current frame
+	static void Add(COUNTER counter, uint64_t amount = 1) { s_frameCounts[counter] += amount; }
+
+	// close the counts of the current frame and start a new one
+	static void BeginFrame();
+	// get a count of the last finished frame
+	static uint64_t Get(COUNTER counter) { return s_lastFrameCounts[counter]; }
+	// get the name of a counter
+	static const char* GetCounterName(COUNTER counter);
+
+	// write the counts of the last finished frame as one line
+	static void WriteLine(std::ostream& output);
+
+private:
+	static uint64_t s_frameCounts[COUNTER_COUNT];
+	static uint64_t s_lastFrameCounts[COUNTER_COUNT];
+};
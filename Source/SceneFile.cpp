@@ -0,0 +1,689 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.cpp
+// ============
+// load text scene descriptions through a compiled, memory-mapped snapshot
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+#include "TextureCache.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	const char g_SceneFileMagic[4] = { 'S', 'C', 'N', '1' };
+	const uint32_t g_SceneFileVersion = 2;
+
+	const char* g_MeshNames[SceneFile::MESH_TYPE_COUNT] = { "plane", "cylinder", "torus" };
+
+	// tags named by an object line, resolved after the whole file is read
+	struct OBJECT_REFERENCES
+	{
+		int lineNumber;
+		std::string textureTag;
+		std::string materialTag;
+	};
+
+	/***********************************************************
+	 *  ReadFloats()
+	 *
+	 *  This function is used for reading a number of float
+	 *  values from a line of a scene file.
+	 ***********************************************************/
+	bool ReadFloats(std::istringstream& line, float* values, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (!(line >> values[i]))
+			{
+				return(false);
+			}
+		}
+		return(true);
+	}
+
+	/***********************************************************
+	 *  AddString()
+	 *
+	 *  This function is used for adding a string to the string
+	 *  table of a snapshot, and getting its offset.
+	 ***********************************************************/
+	uint32_t AddString(std::vector<char>& stringTable, const std::string& text)
+	{
+		uint32_t offset = (uint32_t)stringTable.size();
+		stringTable.insert(stringTable.end(), text.begin(), text.end());
+		stringTable.push_back('\0');
+		return(offset);
+	}
+}
+
+/***********************************************************
+ *  SceneFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneFile::SceneFile()
+{
+	m_pData = NULL;
+	m_dataSize = 0;
+	m_fileHandle = NULL;
+	m_mappingHandle = NULL;
+}
+
+/***********************************************************
+ *  ~SceneFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneFile::~SceneFile()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method is used for loading a text scene file.  The
+ *  snapshot compiled from it is mapped when it is fresh, and
+ *  otherwise the text is compiled into a new snapshot first.
+ *  When only the snapshot exists, it is mapped as it is.
+ ***********************************************************/
+bool SceneFile::Load(const std::string& scenePath)
+{
+	std::string binaryPath = GetBinaryPath(scenePath);
+	std::string source;
+
+	Close();
+
+	if (ReadSource(scenePath, source) == false)
+	{
+		if (Map(binaryPath, false, 0))
+		{
+			return(true);
+		}
+		std::cout << "Could not load scene file:" << scenePath << std::endl;
+		return(false);
+	}
+
+	uint64_t sourceHash = TextureCache::HashBytes(
+		reinterpret_cast<const unsigned char*>(source.data()), source.size());
+
+	if (Map(binaryPath, true, sourceHash))
+	{
+		return(true);
+	}
+
+	std::cout << "Compiling scene file:" << scenePath << std::endl;
+	if (CompileSource(scenePath, source, sourceHash, binaryPath) == false)
+	{
+		return(false);
+	}
+
+	return(Map(binaryPath, true, sourceHash));
+}
+
+/***********************************************************
+ *  Compile()
+ *
+ *  This method is used for compiling a text scene file into
+ *  a binary snapshot at the passed in path.
+ ***********************************************************/
+bool SceneFile::Compile(
+	const std::string& scenePath,
+	const std::string& binaryPath)
+{
+	std::string source;
+
+	if (ReadSource(scenePath, source) == false)
+	{
+		std::cout << "Could not read scene file:" << scenePath << std::endl;
+		return(false);
+	}
+
+	uint64_t sourceHash = TextureCache::HashBytes(
+		reinterpret_cast<const unsigned char*>(source.data()), source.size());
+
+	return(CompileSource(scenePath, source, sourceHash, binaryPath));
+}
+
+/***********************************************************
+ *  CompileSource()
+ *
+ *  This method is used for compiling the text of a scene
+ *  file into a binary snapshot.  The texture and material
+ *  tags of the objects are resolved to record indexes here,
+ *  and any error is reported with its line number.  The
+ *  snapshot is written under a temporary name first and then
+ *  renamed, so a partly written snapshot is never mapped.
+ ***********************************************************/
+bool SceneFile::CompileSource(
+	const std::string& scenePath,
+	const std::string& source,
+	uint64_t sourceHash,
+	const std::string& binaryPath)
+{
+	std::vector<TEXTURE_RECORD> textures;
+	std::vector<MATERIAL_RECORD> materials;
+	std::vector<LIGHT_RECORD> lights;
+	std::vector<OBJECT_RECORD> objects;
+	std::vector<OBJECT_REFERENCES> references;
+	std::vector<char> stringTable;
+	std::unordered_map<std::string, int32_t> textureIndexes;
+	std::unordered_map<std::string, int32_t> materialIndexes;
+	std::unordered_map<std::string, int32_t> objectIndexes;
+	bool bReturn = true;
+
+	std::istringstream text(source);
+	std::string lineText;
+	int lineNumber = 0;
+
+	while (std::getline(text, lineText))
+	{
+		lineNumber++;
+
+		// drop the comment, if there is one
+		size_t comment = lineText.find('#');
+		if (comment != std::string::npos)
+		{
+			lineText.erase(comment);
+		}
+
+		std::istringstream line(lineText);
+		std::string keyword;
+		if (!(line >> keyword))
+		{
+			continue;
+		}
+
+		bool bValid = true;
+		if (keyword == "texture")
+		{
+			std::string tag;
+			std::string path;
+			bValid = (line >> tag) && (line >> path);
+			if (bValid)
+			{
+				if (textureIndexes.count(tag) != 0)
+				{
+					std::cout << scenePath << "(" << lineNumber << "): texture tag is already in use:" << tag << std::endl;
+					bReturn = false;
+				}
+				textureIndexes[tag] = (int32_t)textures.size();
+
+				TEXTURE_RECORD record;
+				record.tagOffset = AddString(stringTable, tag);
+				record.pathOffset = AddString(stringTable, path);
+				textures.push_back(record);
+			}
+		}
+		else if (keyword == "material")
+		{
+			std::string tag;
+			MATERIAL_RECORD record;
+			bValid = (line >> tag) &&
+				ReadFloats(line, record.ambientColor, 3) &&
+				ReadFloats(line, &record.ambientStrength, 1) &&
+				ReadFloats(line, record.diffuseColor, 3) &&
+				ReadFloats(line, record.specularColor, 3) &&
+				ReadFloats(line, &record.shininess, 1);
+			if (bValid)
+			{
+				if (materialIndexes.count(tag) != 0)
+				{
+					std::cout << scenePath << "(" << lineNumber << "): material tag is already in use:" << tag << std::endl;
+					bReturn = false;
+				}
+				materialIndexes[tag] = (int32_t)materials.size();
+
+				record.tagOffset = AddString(stringTable, tag);
+				materials.push_back(record);
+			}
+		}
+		else if (keyword == "light")
+		{
+			LIGHT_RECORD record;
+			bValid = ReadFloats(line, record.position, 3) &&
+				ReadFloats(line, record.ambientColor, 3) &&
+				ReadFloats(line, record.diffuseColor, 3) &&
+				ReadFloats(line, record.specularColor, 3) &&
+				ReadFloats(line, &record.focalStrength, 1) &&
+				ReadFloats(line, &record.specularIntensity, 1);
+			if (bValid)
+			{
+				lights.push_back(record);
+			}
+		}
+		else if (keyword == "object")
+		{
+			std::string meshName;
+			OBJECT_REFERENCES objectReferences;
+			OBJECT_RECORD record;
+			bValid = (line >> meshName) &&
+				ReadFloats(line, record.scale, 3) &&
+				ReadFloats(line, record.rotationDegrees, 3) &&
+				ReadFloats(line, record.position, 3) &&
+				ReadFloats(line, record.color, 4) &&
+				(line >> objectReferences.textureTag) &&
+				(line >> objectReferences.materialTag);
+			if (bValid)
+			{
+				record.mesh = MESH_TYPE_COUNT;
+				for (uint32_t i = 0; i < MESH_TYPE_COUNT; i++)
+				{
+					if (meshName == g_MeshNames[i])
+					{
+						record.mesh = i;
+					}
+				}
+				if (record.mesh == MESH_TYPE_COUNT)
+				{
+					std::cout << scenePath << "(" << lineNumber << "): unknown mesh:" << meshName << std::endl;
+					bReturn = false;
+				}
+
+				// the optional name and parent name come last, and a
+				// parent has to be listed before its children
+				std::string name;
+				std::string parentName;
+				record.parentIndex = NO_INDEX;
+				if ((line >> name) && (line >> parentName))
+				{
+					std::unordered_map<std::string, int32_t>::const_iterator found = objectIndexes.find(parentName);
+					if (found == objectIndexes.end())
+					{
+						std::cout << scenePath << "(" << lineNumber << "): unknown parent object:" << parentName << std::endl;
+						bReturn = false;
+					}
+					else
+					{
+						record.parentIndex = found->second;
+					}
+				}
+				if (name == "-")
+				{
+					name.clear();
+				}
+				if (!name.empty())
+				{
+					if (objectIndexes.count(name) != 0)
+					{
+						std::cout << scenePath << "(" << lineNumber << "): object name is already in use:" << name << std::endl;
+						bReturn = false;
+					}
+					objectIndexes[name] = (int32_t)objects.size();
+				}
+
+				record.nameOffset = AddString(stringTable, name);
+				record.textureIndex = NO_INDEX;
+				record.materialIndex = NO_INDEX;
+				objectReferences.lineNumber = lineNumber;
+				objects.push_back(record);
+				references.push_back(objectReferences);
+			}
+		}
+		else
+		{
+			std::cout << scenePath << "(" << lineNumber << "): unknown entry:" << keyword << std::endl;
+			bReturn = false;
+			continue;
+		}
+
+		std::string extra;
+		if ((bValid == false) || (line >> extra))
+		{
+			std::cout << scenePath << "(" << lineNumber << "): wrong number of values for " << keyword << std::endl;
+			bReturn = false;
+		}
+	}
+
+	// a missing texture or material is an error when the scene
+	// is loaded, rather than a silent state leak when it draws
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		const OBJECT_REFERENCES& objectReferences = references[i];
+
+		if (objectReferences.textureTag != "-")
+		{
+			std::unordered_map<std::string, int32_t>::const_iterator found = textureIndexes.find(objectReferences.textureTag);
+			if (found == textureIndexes.end())
+			{
+				std::cout << scenePath << "(" << objectReferences.lineNumber << "): unknown texture:" << objectReferences.textureTag << std::endl;
+				bReturn = false;
+			}
+			else
+			{
+				objects[i].textureIndex = found->second;
+			}
+		}
+		if (objectReferences.materialTag != "-")
+		{
+			std::unordered_map<std::string, int32_t>::const_iterator found = materialIndexes.find(objectReferences.materialTag);
+			if (found == materialIndexes.end())
+			{
+				std::cout << scenePath << "(" << objectReferences.lineNumber << "): unknown material:" << objectReferences.materialTag << std::endl;
+				bReturn = false;
+			}
+			else
+			{
+				objects[i].materialIndex = found->second;
+			}
+		}
+	}
+
+	if (bReturn == false)
+	{
+		return(false);
+	}
+
+	FILE_HEADER header;
+	memcpy(header.magic, g_SceneFileMagic, sizeof(header.magic));
+	header.version = g_SceneFileVersion;
+	header.sourceHash = sourceHash;
+	header.textureCount = (uint32_t)textures.size();
+	header.materialCount = (uint32_t)materials.size();
+	header.lightCount = (uint32_t)lights.size();
+	header.objectCount = (uint32_t)objects.size();
+	header.stringTableSize = (uint32_t)stringTable.size();
+	header.reserved = 0;
+
+	std::error_code error;
+	std::string tempPath = binaryPath + ".tmp";
+
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			std::cout << "Could not write compiled scene file:" << tempPath << std::endl;
+			return(false);
+		}
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(textures.data()), textures.size() * sizeof(TEXTURE_RECORD));
+		file.write(reinterpret_cast<const char*>(materials.data()), materials.size() * sizeof(MATERIAL_RECORD));
+		file.write(reinterpret_cast<const char*>(lights.data()), lights.size() * sizeof(LIGHT_RECORD));
+		file.write(reinterpret_cast<const char*>(objects.data()), objects.size() * sizeof(OBJECT_RECORD));
+		file.write(stringTable.data(), stringTable.size());
+
+		if (!file.good())
+		{
+			file.close();
+			std::filesystem::remove(tempPath, error);
+			return(false);
+		}
+	}
+
+	std::filesystem::rename(tempPath, binaryPath, error);
+	if (error)
+	{
+		std::cout << "Could not write compiled scene file:" << binaryPath << std::endl;
+		std::filesystem::remove(tempPath, error);
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReadSource()
+ *
+ *  This method is used for reading the whole text of a
+ *  scene file into memory.
+ ***********************************************************/
+bool SceneFile::ReadSource(const std::string& scenePath, std::string& source)
+{
+	std::ifstream file(scenePath, std::ios::binary);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	source = contents.str();
+
+	return(true);
+}
+
+/***********************************************************
+ *  Map()
+ *
+ *  This method is used for memory-mapping a snapshot file.
+ *  The snapshot is only kept when its header, size, string
+ *  offsets and record indexes are all valid, and when its
+ *  source hash matches, if the hash is checked.
+ ***********************************************************/
+bool SceneFile::Map(const std::string& binaryPath, bool bCheckHash, uint64_t sourceHash)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(binaryPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return(false);
+	}
+	m_fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if ((GetFileSizeEx(file, &fileSize) == FALSE) || (fileSize.QuadPart < (LONGLONG)sizeof(FILE_HEADER)))
+	{
+		Close();
+		return(false);
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		Close();
+		return(false);
+	}
+	m_mappingHandle = mapping;
+
+	m_pData = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	m_dataSize = (size_t)fileSize.QuadPart;
+	if (m_pData == NULL)
+	{
+		Close();
+		return(false);
+	}
+#else
+	int file = open(binaryPath.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return(false);
+	}
+
+	struct stat fileStatus;
+	if ((fstat(file, &fileStatus) != 0) || (fileStatus.st_size < (off_t)sizeof(FILE_HEADER)))
+	{
+		close(file);
+		return(false);
+	}
+
+	void* pMapping = mmap(NULL, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	// the mapping stays valid after the file is closed
+	close(file);
+	if (pMapping == MAP_FAILED)
+	{
+		return(false);
+	}
+
+	m_pData = (const unsigned char*)pMapping;
+	m_dataSize = (size_t)fileStatus.st_size;
+#endif
+
+	const FILE_HEADER* pHeader = GetHeader();
+	bool bValid = (memcmp(pHeader->magic, g_SceneFileMagic, sizeof(g_SceneFileMagic)) == 0) &&
+		(pHeader->version == g_SceneFileVersion) &&
+		((bCheckHash == false) || (pHeader->sourceHash == sourceHash)) &&
+		(GetFileSize(*pHeader) == m_dataSize);
+
+	if (bValid && (pHeader->stringTableSize > 0))
+	{
+		bValid = (GetString(0)[pHeader->stringTableSize - 1] == '\0');
+	}
+	for (uint32_t i = 0; bValid && (i < pHeader->textureCount); i++)
+	{
+		bValid = (GetTextures()[i].tagOffset < pHeader->stringTableSize) &&
+			(GetTextures()[i].pathOffset < pHeader->stringTableSize);
+	}
+	for (uint32_t i = 0; bValid && (i < pHeader->materialCount); i++)
+	{
+		bValid = (GetMaterials()[i].tagOffset < pHeader->stringTableSize);
+	}
+	for (uint32_t i = 0; bValid && (i < pHeader->objectCount); i++)
+	{
+		const OBJECT_RECORD& object = GetObjects()[i];
+		bValid = (object.mesh < MESH_TYPE_COUNT) &&
+			(object.textureIndex >= NO_INDEX) && (object.textureIndex < (int32_t)pHeader->textureCount) &&
+			(object.materialIndex >= NO_INDEX) && (object.materialIndex < (int32_t)pHeader->materialCount) &&
+			(object.nameOffset < pHeader->stringTableSize) &&
+			(object.parentIndex >= NO_INDEX) && (object.parentIndex < (int32_t)i);
+	}
+
+	if (bValid == false)
+	{
+		Close();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for unmapping the loaded snapshot.
+ ***********************************************************/
+void SceneFile::Close()
+{
+#ifdef _WIN32
+	if (NULL != m_pData)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+	if (NULL != m_mappingHandle)
+	{
+		CloseHandle((HANDLE)m_mappingHandle);
+	}
+	if (NULL != m_fileHandle)
+	{
+		CloseHandle((HANDLE)m_fileHandle);
+	}
+#else
+	if (NULL != m_pData)
+	{
+		munmap((void*)m_pData, m_dataSize);
+	}
+#endif
+
+	m_pData = NULL;
+	m_dataSize = 0;
+	m_fileHandle = NULL;
+	m_mappingHandle = NULL;
+}
+
+/***********************************************************
+ *  GetFileSize()
+ *
+ *  This method is used for getting the byte size of a
+ *  snapshot with the counts in the passed in header.
+ ***********************************************************/
+size_t SceneFile::GetFileSize(const FILE_HEADER& header)
+{
+	return(sizeof(FILE_HEADER) +
+		header.textureCount * sizeof(TEXTURE_RECORD) +
+		header.materialCount * sizeof(MATERIAL_RECORD) +
+		header.lightCount * sizeof(LIGHT_RECORD) +
+		header.objectCount * sizeof(OBJECT_RECORD) +
+		header.stringTableSize);
+}
+
+/***********************************************************
+ *  GetBinaryPath()
+ *
+ *  This method is used for getting the path of the snapshot
+ *  that is compiled from a text scene file.
+ ***********************************************************/
+std::string SceneFile::GetBinaryPath(const std::string& scenePath)
+{
+	return(scenePath + ".bin");
+}
+
+/***********************************************************
+ *  Record accessors
+ *
+ *  These methods are used for getting the records of the
+ *  loaded snapshot.  The record arrays follow the header in
+ *  the order textures, materials, lights, objects, and the
+ *  string table comes last.
+ ***********************************************************/
+uint32_t SceneFile::GetTextureCount() const
+{
+	return((NULL != m_pData) ? GetHeader()->textureCount : 0);
+}
+
+const SceneFile::TEXTURE_RECORD* SceneFile::GetTextures() const
+{
+	return((const TEXTURE_RECORD*)(m_pData + sizeof(FILE_HEADER)));
+}
+
+uint32_t SceneFile::GetMaterialCount() const
+{
+	return((NULL != m_pData) ? GetHeader()->materialCount : 0);
+}
+
+const SceneFile::MATERIAL_RECORD* SceneFile::GetMaterials() const
+{
+	return((const MATERIAL_RECORD*)(GetTextures() + GetHeader()->textureCount));
+}
+
+uint32_t SceneFile::GetLightCount() const
+{
+	return((NULL != m_pData) ? GetHeader()->lightCount : 0);
+}
+
+const SceneFile::LIGHT_RECORD* SceneFile::GetLights() const
+{
+	return((const LIGHT_RECORD*)(GetMaterials() + GetHeader()->materialCount));
+}
+
+uint32_t SceneFile::GetObjectCount() const
+{
+	return((NULL != m_pData) ? GetHeader()->objectCount : 0);
+}
+
+const SceneFile::OBJECT_RECORD* SceneFile::GetObjects() const
+{
+	return((const OBJECT_RECORD*)(GetLights() + GetHeader()->lightCount));
+}
+
+const char* SceneFile::GetString(uint32_t offset) const
+{
+	const char* pStringTable = (const char*)(GetObjects() + GetHeader()->objectCount);
+	return(pStringTable + offset);
+}
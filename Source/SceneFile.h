@@ -0,0 +1,148 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.h
+// ============
+// load text scene descriptions through a compiled, memory-mapped snapshot
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  This class loads a scene described in a text file, which
+ *  lists the textures, materials, lights and objects of the
+ *  scene.  The text is compiled once into a compact binary
+ *  snapshot, with every texture and material reference of
+ *  the objects already resolved to an index.  On later
+ *  starts the snapshot is memory-mapped and its records are
+ *  used directly, with no parsing.  Objects can be named and
+ *  attached to an earlier object as their parent, and the
+ *  parent is resolved to an index too.  The snapshot is stamped
+ *  with a hash of the text file, and is compiled again
+ *  whenever the text file changes.
+ ***********************************************************/
+class SceneFile
+{
+public:
+	// constructor
+	SceneFile();
+	// destructor
+	~SceneFile();
+
+	enum MESH_TYPE
+	{
+		MESH_PLANE = 0,
+		MESH_CYLINDER,
+		MESH_TORUS,
+		MESH_TYPE_COUNT
+	};
+
+	// index used for an object with no texture, material or parent
+	static const int32_t NO_INDEX = -1;
+
+	struct TEXTURE_RECORD
+	{
+		uint32_t tagOffset;
+		uint32_t pathOffset;
+	};
+
+	struct MATERIAL_RECORD
+	{
+		uint32_t tagOffset;
+		float ambientColor[3];
+		float ambientStrength;
+		float diffuseColor[3];
+		float specularColor[3];
+		float shininess;
+	};
+
+	struct LIGHT_RECORD
+	{
+		float position[3];
+		float ambientColor[3];
+		float diffuseColor[3];
+		float specularColor[3];
+		float focalStrength;
+		float specularIntensity;
+	};
+
+	struct OBJECT_RECORD
+	{
+		uint32_t mesh;
+		float scale[3];
+		float rotationDegrees[3];
+		float position[3];
+		float color[4];
+		int32_t textureIndex;
+		int32_t materialIndex;
+		uint32_t nameOffset;
+		int32_t parentIndex;
+	};
+
+	// load a text scene file through its compiled snapshot
+	bool Load(const std::string& scenePath);
+	// compile a text scene file into a binary snapshot
+	static bool Compile(
+		const std::string& scenePath,
+		const std::string& binaryPath);
+	// unmap the loaded snapshot
+	void Close();
+
+	// get the records of the loaded snapshot
+	uint32_t GetTextureCount() const;
+	const TEXTURE_RECORD* GetTextures() const;
+	uint32_t GetMaterialCount() const;
+	const MATERIAL_RECORD* GetMaterials() const;
+	uint32_t GetLightCount() const;
+	const LIGHT_RECORD* GetLights() const;
+	uint32_t GetObjectCount() const;
+	const OBJECT_RECORD* GetObjects() const;
+	// get a string of the loaded snapshot by its offset
+	const char* GetString(uint32_t offset) const;
+
+	// get the path of the snapshot compiled from a text scene file
+	static std::string GetBinaryPath(const std::string& scenePath);
+
+private:
+	// header at the start of every snapshot file
+	struct FILE_HEADER
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceHash;
+		uint32_t textureCount;
+		uint32_t materialCount;
+		uint32_t lightCount;
+		uint32_t objectCount;
+		uint32_t stringTableSize;
+		uint32_t reserved;
+	};
+
+	// the memory-mapped snapshot file
+	const unsigned char* m_pData;
+	size_t m_dataSize;
+	// the operating system handles of the mapping
+	void* m_fileHandle;
+	void* m_mappingHandle;
+
+	// compile the loaded text of a scene file into a binary snapshot
+	static bool CompileSource(
+		const std::string& scenePath,
+		const std::string& source,
+		uint64_t sourceHash,
+		const std::string& binaryPath);
+	// read the whole text of a scene file
+	static bool ReadSource(const std::string& scenePath, std::string& source);
+	// map a snapshot file and check that it is complete and fresh
+	bool Map(const std::string& binaryPath, bool bCheckHash, uint64_t sourceHash);
+	// get the header of the loaded snapshot
+	const FILE_HEADER* GetHeader() const { return (const FILE_HEADER*)m_pData; }
+	// get the byte size of a snapshot with the passed in counts
+	static size_t GetFileSize(const FILE_HEADER& header);
+};
@@ -1,994 +1,1225 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.cpp
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables
-namespace
-{
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager* pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
-}
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
-}
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationX * rotationY * rotationZ * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
-}
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
-}
-
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
- /***********************************************************
-
-  /***********************************************************
-  *  LoadSceneTextures()
-  *
-  *  This method is used for preparing the 3D scene by loading
-  *  the shapes, textures in memory to support the 3D scene
-  *  rendering
-  ***********************************************************/
-void SceneManager::LoadSceneTextures()
-{
-	bool bReturn = false;
-
-	/***************************/
-	// loads NAPKIN texture into project from final_project folder //
-	// assigns PPaper texture to paper texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/PPAPER.jpg",
-		"Paper");
-	/***************************/
-		/***************************/
-	// loads wood texture into project from final_project folder //
-	// assigns wood006 texture to wood texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/WoodTab.jpg",
-		"Table");
-	/***************************/
-// loads Metal stainless texture into project from final_project folder //
-// assigns Metal stainless texture to Metal_S texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/Metalstainless.jpg",
-		"Metal_S");
-	/***************************/
-	/***************************/
-// loads plastic texture into project from final_project folder //
-// assigns plastic texture to Plastic_P texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/PlasticGray.jpg",
-		"Plastic_P");
-	/***************************/
-	/***************************/
-// loads dark Metal texture into project from final_project folder //
-// assigns dark Metal texture to Metal_T texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/Metal_T.jpg",
-		"Metal_T");
-	/***************************/
-	/***************************/
-// loads everything bagel texture into project from final_project folder //
-// assigns everything texture to Bagel_B texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/Bagel01.jpg",
-		"Bagel_B");
-	/***************************/
-// loads candle texture into project from final_project folder //
-// assigns Candle to Candle_C texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/Candle.jpg",
-		"Candle_C");
-	/***************************/
-// loads candle light texture into project from final_project folder //
-// assigns Candle light to Candle_L texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/Candle_L.jpg",
-		"Candle_L");
-	/***************************/
-// loads Mug texture into project from final_project folder //
-// assigns Mug texture to Mug_M texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/Mug_M.jpg",
-		"Mug_M");
-	/***************************/
-// loads light blue texture into project from final_project folder //
-// assigns light blue texture to Lblue_B texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/Lblue_B.jpg",
-		"Lblue_B");
-	/***************************/
-// loads white lid texture into project from final_project folder //
-// assigns white lid texture to White_Lid texture slot //
-
-	bReturn = CreateGLTexture(
-		"C:/Users/arman/Documents/SNHU/CS 330/CS330Content/CS330Content/Projects/7-1_FinalProjectMilestones/White_Lid.jpg",
-		"White_Lid");
-	/***************************/
-
-	BindGLTextures();
-}
-
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-	// load the textures for the 3D scene
-	LoadSceneTextures();
-	DefineObjectMaterials();
-	SetupSceneLights();
-
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadTorusMesh();
-}
-/***********************************************************
-* DefineObjectMaterials()
- *
-* This method is used for configuring the various material
-* se?ngs for all of the objects in the 3D scene.
-***********************************************************/
-void SceneManager::DefineObjectMaterials()
-{
-	OBJECT_MATERIAL steelMaterial;
-	steelMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f); // low ambient
-	steelMaterial.ambientStrength = 0.2f; // mild ambient
-	steelMaterial.diffuseColor = glm::vec3(0.2f, 0.2f, 0.2f); //low diffuse
-	steelMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.6f); // mild specular component
-	steelMaterial.shininess = 128.0; //High Shininess like stainless steel
-	steelMaterial.tag = "steel";
-	m_objectMaterials.push_back(steelMaterial);
-
-	OBJECT_MATERIAL ceramicMaterial;
-	ceramicMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f); // low ambient
-	ceramicMaterial.ambientStrength = 0.4f; // mild ambient
-	ceramicMaterial.diffuseColor = glm::vec3(0.8f, 0.8f, 0.8f); // high diffuse
-	ceramicMaterial.specularColor = glm::vec3(0.4f, 0.4f, 0.4f);
-	ceramicMaterial.shininess = 32.0;  // mild shininess
-	ceramicMaterial.tag = "ceramic";
-	m_objectMaterials.push_back(ceramicMaterial);
-
-	OBJECT_MATERIAL woodMaterial;
-	woodMaterial.ambientColor = glm::vec3(0.4f, 0.3f, 0.1f);
-	woodMaterial.ambientStrength = 0.2f;
-	woodMaterial.diffuseColor = glm::vec3(0.3f, 0.2f, 0.1f);
-	woodMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	woodMaterial.shininess = 0.3;
-	woodMaterial.tag = "wood";
-	m_objectMaterials.push_back(woodMaterial);
-
-	OBJECT_MATERIAL plasticMaterial;
-	plasticMaterial.ambientColor = glm::vec3(0.1f, 0.1f, 0.1f); // low ambient
-	plasticMaterial.ambientStrength = 0.2f; // mile ambient 
-	plasticMaterial.diffuseColor = glm::vec3(0.6f, 0.6f, 0.6f); // low diffuse
-	plasticMaterial.specularColor = glm::vec3(0.8f, 0.8f, 0.8f); // high specular
-	plasticMaterial.shininess = 64.0; // moderate shine
-	plasticMaterial.tag = "plastic";
-	m_objectMaterials.push_back(plasticMaterial);
-
-	OBJECT_MATERIAL glassMaterial;
-	glassMaterial.ambientColor = glm::vec3(0.4f, 0.4f, 0.4f);
-	glassMaterial.ambientStrength = 0.3f;
-	glassMaterial.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	glassMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.6f);
-	glassMaterial.shininess = 85.0;
-	glassMaterial.tag = "glass";
-	m_objectMaterials.push_back(glassMaterial);
-
-	OBJECT_MATERIAL bagelMaterial; 
-	bagelMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f); // low ambient
-	bagelMaterial.ambientStrength = 0.3f; // mild ambient strength
-	bagelMaterial.diffuseColor = glm::vec3(0.4f, 0.4f, 0.5f); // warm, baked color
-	bagelMaterial.specularColor = glm::vec3(0.2f, 0.2f, 0.4f); // low specular component
-	bagelMaterial.shininess = 0.5; // low shine
-	bagelMaterial.tag = "bagel";
-	m_objectMaterials.push_back(bagelMaterial);
-
-	OBJECT_MATERIAL paperMaterial;
-	paperMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f); // Low ambient component
-	paperMaterial.ambientStrength = 0.4f; // Moderate ambient strength
-	paperMaterial.diffuseColor = glm::vec3(0.6f, 0.6f, 0.6f); // High diffuse component
-	paperMaterial.specularColor = glm::vec3(0.2f, 0.2f, 0.2f); // Low specular component
-	paperMaterial.shininess = 40.0; // Low shininess value
-	paperMaterial.tag = "paper";
-	m_objectMaterials.push_back(paperMaterial);
-
-	OBJECT_MATERIAL waxMaterial;
-	waxMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f); // Low ambient component
-	waxMaterial.ambientStrength = 0.4f; // Moderate ambient strength
-	waxMaterial.diffuseColor = glm::vec3(0.8f, 0.8f, 0.6f); // High diffuse component
-	waxMaterial.specularColor = glm::vec3(0.6f, 0.6f, 0.4f); // Moderate specular component
-	waxMaterial.shininess = 32.0f; // Moderate shininess value
-	waxMaterial.tag = "wax";
-	m_objectMaterials.push_back(waxMaterial);
-
-	OBJECT_MATERIAL candleFlameMaterial;
-	candleFlameMaterial.ambientColor = glm::vec3(0.0f, 0.0f, 0.0f); // No ambient component
-	candleFlameMaterial.ambientStrength = 0.0f; // No ambient strength
-	candleFlameMaterial.diffuseColor = glm::vec3(1.0f, 0.8f, 0.4f); // Yellow-orange color for the flame
-	candleFlameMaterial.specularColor = glm::vec3(0.0f, 0.0f, 0.0f); // No specular component
-	candleFlameMaterial.shininess = 0.0f; // No shininess value
-	candleFlameMaterial.tag = "candleFlame";
-	m_objectMaterials.push_back(candleFlameMaterial);
-}
-
-void SceneManager::SetupSceneLights()
-{
-	// Key Light 
-	m_pShaderManager->setVec3Value("lightSources[0].position", 3.0f, 14.0f, 0.0f);
-	m_pShaderManager->setVec3Value("lightSources[0].ambientColor", 0.01f, 0.01f, 0.01f);
-	m_pShaderManager->setVec3Value("lightSources[0].diffuseColor", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setVec3Value("lightSources[0].specularColor", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setFloatValue("lightSources[0].focalStrength", 64.0f);
-	m_pShaderManager->setFloatValue("lightSources[0].specularIntensity", 1.00f);
-
-	// Fill Light
-	m_pShaderManager->setVec3Value("lightSources[1].position", 3.0f, 14.0f, -3.0f);
-	m_pShaderManager->setVec3Value("lightSources[1].ambientColor", 0.02f, 0.02f, 0.02f);
-	m_pShaderManager->setVec3Value("lightSources[1].diffuseColor", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setVec3Value("lightSources[1].specularColor", 0.2f, 0.2f, 0.2f);
-	m_pShaderManager->setFloatValue("lightSources[1].focalStrength", 16.0f);
-	m_pShaderManager->setFloatValue("lightSources[1].specularIntensity", 0.05f);
-
-	// Back light
-	m_pShaderManager->setVec3Value("lightSources[2].position", 0.6f, 5.0f, 6.0f);
-	m_pShaderManager->setVec3Value("lightSources[2].ambientColor", 0.01f, 0.01f, 0.01f);
-	m_pShaderManager->setVec3Value("lightSources[2].diffuseColor", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setVec3Value("lightSources[2].specularColor", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setFloatValue("lightSources[2].focalStrength", 16.0f);
-	m_pShaderManager->setFloatValue("lightSources[2].specularIntensity", 0.3f);
-
-	// Rim light 1
-	m_pShaderManager->setVec3Value("lightSources[3].position", 0.6f, 5.0f, 6.0f);
-	m_pShaderManager->setVec3Value("lightSources[3].ambientColor", 0.01f, 0.01f, 0.01f);
-	m_pShaderManager->setVec3Value("lightSources[3].diffuseColor", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setVec3Value("lightSources[3].specularColor", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setFloatValue("lightSources[3].focalStrength", 16.0f);
-	m_pShaderManager->setFloatValue("lightSources[3].specularIntensity", 0.3f);
-
-	// Rim light 2
-	m_pShaderManager->setVec3Value("lightSources[4].position", 0.6f, 5.0f, 6.0f);
-	m_pShaderManager->setVec3Value("lightSources[4].ambientColor", 0.01f, 0.01f, 0.01f);
-	m_pShaderManager->setVec3Value("lightSources[4].diffuseColor", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setVec3Value("lightSources[4].specularColor", 0.4f, 0.4f, 0.4f);
-	m_pShaderManager->setFloatValue("lightSources[4].focalStrength", 16.0f);
-	m_pShaderManager->setFloatValue("lightSources[4].specularIntensity", 0.3f);
-
-	m_pShaderManager->setBoolValue("bUseLighting", true);
-}
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-void SceneManager::RenderScene()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	// Table Plane //
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderColor(1, 1, 1, 1);
-	// assigns wood texture to Table slot to plane mesh //
-	SetShaderTexture("Table");
-	SetShaderMaterial("wood");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	/****************************************************************/
-		//   First Cylinder Jar ******//
-		// set the XYZ scale for the jar mesh
-	scaleXYZ = glm::vec3(2.0f, 3.95f, 1.5f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 180.0f;
-
-	// set the XYZ position for the jar mesh
-	positionXYZ = glm::vec3(3.0f, 4.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use lightSlateGray //
-	SetShaderColor(0.439, 0.502, 0.565, 1);
-	// assigns Metal texture to Metal_S slot to cylinder mesh //
-	SetShaderTexture("Metal_S");
-	SetShaderMaterial("steel");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-			//   Second Cylinder Lid ******//
-		// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(1.8f, 1.5f, 1.7f);
-	// set the XYZ rotation for the cylinder lid mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = -10.0f;
-	ZrotationDegrees = 100.0f;
-
-	// set the XYZ position for the cylinder lid mesh
-	positionXYZ = glm::vec3(4.0f, 5.2f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use DarkSlateGray instead of Black to differentiate//
-	SetShaderColor(0.184, 0.310, 0.310, 1);
-	// assigns Metal texture to Metal_S slot to cylinder lid mesh //
-	SetShaderTexture("Metal_S");
-	SetShaderMaterial("steel");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-		 //   Second Cylinder Lid Seal  ******//
-		// set the XYZ scale for the cylinder lid seal mesh
-	scaleXYZ = glm::vec3(1.9f, 0.3f, 1.75f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = -10.0f;
-	ZrotationDegrees = 100.0f;
-
-	// set the XYZ position for the cylinder lid seal mesh
-	positionXYZ = glm::vec3(3.5f, 5.35f, -.1f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use silver for lid seal//
-	SetShaderColor(0.753, 0.753, 0.753, 1);
-	// assigns Metal texture to Metal_S slot to cylinder mesh //
-	SetShaderTexture("Plastic_P");
-	SetShaderMaterial("plastic");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-			 //    Cylinder jar lid handle  ******//
-		// set the XYZ scale for the cylinder jar lid handle mesh
-	scaleXYZ = glm::vec3(0.5f, 0.8f, 0.5f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = -10.0f;
-	ZrotationDegrees = 100.0f;
-
-	// set the XYZ position for the cylinder jar lid handle mesh
-	positionXYZ = glm::vec3(2.7f, 5.35f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use DimGray for lid handle//
-	SetShaderColor(0.412, 0.412, 0.412, 1);
-	// assigns dark metal texture to Metal_T slot to cylinder mesh //
-	SetShaderTexture("Metal_T");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-	// napkin  /
-	// set the XYZ scale for the napkinmesh
-	scaleXYZ = glm::vec3(2.0f, 1.5f, 1.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 30.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the napkin mesh
-	positionXYZ = glm::vec3(4.0f, 0.08f, 3.5f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use SeaShell for napkin //
-	SetShaderColor(1, 1, 1, 1);
-	// assigns paper texture slot to plane mesh //
-	SetShaderTexture("Paper");
-	SetShaderMaterial("paper");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-	/****************************************************************/
-			 //    torus for bagel  ******//
-		// set the XYZ scale for the torus mesh
-	scaleXYZ = glm::vec3(0.9f, 1.0f, 1.5f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the torus mesh
-	positionXYZ = glm::vec3(3.8f, 0.35f, 3.5f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use orange for  torus//
-	SetShaderColor(1.000, 0.647, 0.000, 1);
-	// assigns everything bagel texture to Bagel_B slot to torus mesh //
-	SetShaderTexture("Bagel_B");
-	SetShaderMaterial("bagel");
-
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawTorusMesh();
-	/****************************************************************/
-	/****************************************************************/
-		//   candle ******//
-		// set the XYZ scale for the cylinder mesh
-	scaleXYZ = glm::vec3(1.0f, 3.95f, 1.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 180.0f;
-
-	// set the XYZ position for the jar mesh
-	positionXYZ = glm::vec3(-1.0f, 4.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use texture color //
-	SetShaderColor(0.439, 0.502, 0.565, 1);
-	// assigns Candle texture to Candle_C slot to cylinder mesh //
-	SetShaderTexture("Candle_C");
-	SetShaderMaterial("wax");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-			 //    Candle light  ******//
-		// set the XYZ scale for the candle cylinder mesh //
-		//   candle flame a little longer because I like how it looks // 
-	scaleXYZ = glm::vec3(0.2f, 0.5f, 1.5f);
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 00.0f;
-	ZrotationDegrees = 100.0f;
-
-	// set the XYZ position for the cylinder  mesh
-	positionXYZ = glm::vec3(-0.8f, 4.00f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use candle light color//
-	SetShaderColor(0.412, 0.412, 0.412, 1);
-	// assigns candle light texture to candle_L slot to cylinder mesh //
-	SetShaderTexture("Candle_L");
-	SetShaderMaterial("candleFlame");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-	/****************************************************************/
-		//   mug ******//
-		// set the XYZ scale for the cylinder mesh
-	scaleXYZ = glm::vec3(2.0f, 2.45f, 1.5f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 180.0f;
-
-	// set the XYZ position for the jar mesh
-	positionXYZ = glm::vec3(-5.0f, 2.5f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use texture color //
-	SetShaderColor(0.439, 0.502, 0.565, 1);
-	// assigns Mug texture to Mug_M slot to cylinder mesh //
-	SetShaderTexture("Mug_M");
-	SetShaderMaterial("ceramic");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-		//   water bottle ******//
-		// set the XYZ scale for the cylinder mesh
-	scaleXYZ = glm::vec3(0.9f, 3.7f, 0.8f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -145.0f;
-
-	// set the XYZ position for the water bottle mesh
-	positionXYZ = glm::vec3(-6.3f, 3.9f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use texture color //
-	SetShaderColor(0.439, 0.502, 0.565, 1);
-	// assigns light blue texture to Lblue_B slot to cylinder lid mesh //
-	SetShaderTexture("Lblue_B");
-	SetShaderMaterial("plastic");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-		//   white lid water bottle ******//
-		// set the XYZ scale for the cylinder mesh
-	scaleXYZ = glm::vec3(0.4f, 0.7f, 0.4f);
-
-	// set the XYZ rotation for the lid mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = -145.0f;
-
-	// set the XYZ position for the water bottle mesh
-	positionXYZ = glm::vec3(-6.6f, 4.3f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	// will use texture color //
-	SetShaderColor(0.439, 0.502, 0.565, 1);
-	// assigns white lid texture to White_Lid slot to cylinder mesh //
-	SetShaderTexture("White_Lid");
-	SetShaderMaterial("plastic");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawCylinderMesh();
-	/****************************************************************/
-
-	
-}
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.cpp
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneManager.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cmath>
+#include <iomanip>
+#include <unordered_map>
+
+// declaration of global variables
+namespace
+{
+	const char* g_TextureArrayName = "textureArrays";
+	const char* g_UseLightingName = "bUseLighting";
+	const char* g_UseDrawDataName = "bUseDrawData";
+
+	// tag of the plain gray material given to objects that have
+	// no material, which no scene file tag can match
+	const char* g_DefaultMaterialTag = "<default>";
+
+	// distance from the camera that maps to the far end of the
+	// depth field of the render queue sort keys
+	const float g_SortDepthRange = 100.0f;
+
+	// smallest screen size of an object drawn with each level of
+	// detail but the coarsest, as the radius of its bounding sphere
+	// over half of the screen height
+	const float g_DetailLevelSizes[SceneMeshes::MAX_DETAIL_LEVELS - 1] = { 0.15f, 0.04f };
+	// how far past a level's size an object has to get before it
+	// changes level, so objects near the size do not flicker
+	const float g_DetailLevelHysteresis = 0.2f;
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(ShaderManager* pShaderManager, UniformCache* pUniformCache)
+{
+	m_pShaderManager = pShaderManager;
+	m_pUniformCache = pUniformCache;
+	m_defaultMaterialHandle = -1;
+	m_bStreamTextures = false;
+	m_streamingBudgetBytes = 4 * 1024 * 1024;
+	m_pTextureStreamer = NULL;
+	m_streamingPBOs[0] = 0;
+	m_streamingPBOs[1] = 0;
+	m_nextStreamingPBO = 0;
+	m_streamingUpload.bActive = false;
+	m_scenePath = "Scenes/desk.scene";
+	m_viewPosition = glm::vec3(0.0f, 0.0f, 0.0f);
+	m_bFrustumCulling = true;
+	m_bIndirectDrawing = false;
+	m_bLevelOfDetail = true;
+	m_viewProjection = glm::mat4(1.0f);
+	m_drawnTriangleCount = 0;
+	m_boundsVersion = 0;
+	m_culledCount = 0;
+	m_drawnCount = 0;
+	m_stateChanges = 0;
+	m_avoidedStateChanges = 0;
+
+	// get the handles of the uniforms that are set for every draw
+	if (NULL != m_pUniformCache)
+	{
+		m_uniforms.useDrawData = m_pUniformCache->GetUniform(g_UseDrawDataName);
+	}
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	m_pShaderManager = NULL;
+	m_pUniformCache = NULL;
+
+	// stop any texture streaming that is still running
+	if (NULL != m_pTextureStreamer)
+	{
+		delete m_pTextureStreamer;
+		m_pTextureStreamer = NULL;
+	}
+	if (0 != m_streamingPBOs[0])
+	{
+		glDeleteBuffers(2, m_streamingPBOs);
+	}
+
+	DestroyGLTextures();
+}
+
+/***********************************************************
+ *  ReserveTextureLayers()
+ *
+ *  This method is used for registering every queued image
+ *  tag and reserving a texture array layer for it, using the
+ *  image size read from the image file header.  The returned
+ *  index is the slot of the first queued image - the others
+ *  follow it in queue order.  Until a texture is loaded, its
+ *  slot shows the placeholder texture.
+ ***********************************************************/
+int SceneManager::ReserveTextureLayers(TextureLoader& textureLoader)
+{
+	std::vector<TextureLoader::IMAGE_DATA>& images = textureLoader.GetImages();
+	int firstSlot = (int)m_textureIDs.size();
+
+	// block compressed textures can only be used when the
+	// OpenGL driver supports them
+	if (m_textureCache.IsCompressionEnabled() && !GLEW_EXT_texture_compression_s3tc)
+	{
+		std::cout << "S3TC texture compression is not supported, using uncompressed textures" << std::endl;
+		m_textureCache.SetCompression(false);
+	}
+
+	textureLoader.ReadImageInfo();
+
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		TEXTURE_INFO textureInfo;
+		TextureCache::TEXTURE_FORMAT format = m_textureCache.GetTextureFormat(images[i].colorChannels);
+
+		textureInfo.tag = images[i].tag;
+		textureInfo.bLoaded = false;
+		if ((images[i].width > 0) && (images[i].height > 0))
+		{
+			textureInfo.location = m_texturePool.ReserveLayer(images[i].width, images[i].height, format);
+		}
+		else
+		{
+			std::cout << "Could not read image:" << images[i].filename << std::endl;
+			textureInfo.location = m_texturePool.GetPlaceholder();
+		}
+		if (m_textureHandles.count(textureInfo.tag) != 0)
+		{
+			std::cout << "Texture tag is already in use:" << textureInfo.tag << std::endl;
+		}
+		m_textureHandles[textureInfo.tag] = (int)m_textureIDs.size();
+		m_textureIDs.push_back(textureInfo);
+	}
+
+	m_texturePool.Allocate();
+
+	return(firstSlot);
+}
+
+/***********************************************************
+ *  CreateGLTextures()
+ *
+ *  This method is used for loading all of the textures that
+ *  were queued in the passed in texture loader.  The image
+ *  files are decoded at the same time on worker threads, and
+ *  then the decoded images are loaded into texture memory
+ *  on this thread in the order they were queued, so every
+ *  tag is registered to the same slot as before.  A timing
+ *  report is printed when all the textures are loaded.
+ ***********************************************************/
+bool SceneManager::CreateGLTextures(TextureLoader& textureLoader)
+{
+	std::vector<TextureLoader::IMAGE_DATA>& images = textureLoader.GetImages();
+	std::vector<double> uploadMilliseconds(images.size(), 0.0);
+	double totalDecodeMilliseconds = 0.0;
+	double totalUploadMilliseconds = 0.0;
+	double decodeWallMilliseconds = 0.0;
+	int cachedImages = 0;
+	int firstSlot = 0;
+	bool bReturn = true;
+
+	firstSlot = ReserveTextureLayers(textureLoader);
+
+	// decode all of the image files at the same time
+	textureLoader.SetTextureCache(&m_textureCache);
+	decodeWallMilliseconds = textureLoader.DecodeQueuedImages();
+
+	// load the decoded images into texture memory on the
+	// thread that owns the OpenGL context
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		if (images[i].bDecoded == false)
+		{
+			std::cout << "Could not load image:" << images[i].filename << std::endl;
+			bReturn = false;
+			continue;
+		}
+
+		auto startTime = std::chrono::steady_clock::now();
+		if (UploadGLTexture(images[i], firstSlot + (int)i) == false)
+		{
+			bReturn = false;
+		}
+		auto endTime = std::chrono::steady_clock::now();
+
+		uploadMilliseconds[i] = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+		totalDecodeMilliseconds += images[i].decodeMilliseconds;
+		totalUploadMilliseconds += uploadMilliseconds[i];
+		if (images[i].bFromCache)
+		{
+			cachedImages++;
+		}
+	}
+
+	// free the image data from local memory
+	textureLoader.FreeImages();
+
+	// display the decode and upload timing report
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << "INFO: Texture load report - " << images.size() << " images, "
+		<< textureLoader.GetWorkerCount() << " decode threads, "
+		<< cachedImages << " from texture cache" << std::endl;
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		std::cout << "  " << std::left << std::setw(12) << images[i].tag << std::right
+			<< " decode:" << std::setw(9) << images[i].decodeMilliseconds << " ms"
+			<< "  upload:" << std::setw(9) << uploadMilliseconds[i] << " ms"
+			<< "  " << images[i].width << "x" << images[i].height << "x" << images[i].colorChannels
+			<< (images[i].bFromCache ? "  cached" : "  decoded")
+			<< std::endl;
+	}
+	std::cout << "  decode total:" << std::setw(9) << totalDecodeMilliseconds << " ms"
+		<< "  decode wall clock:" << std::setw(9) << decodeWallMilliseconds << " ms"
+		<< "  upload total:" << std::setw(9) << totalUploadMilliseconds << " ms"
+		<< "  load total:" << std::setw(9) << decodeWallMilliseconds + totalUploadMilliseconds << " ms"
+		<< std::endl;
+	std::cout << std::defaultfloat;
+
+	return(bReturn);
+}
+
+/***********************************************************
+ *  UploadGLTexture()
+ *
+ *  This method is used for loading every prebuilt mipmap
+ *  level of a decoded image into the texture array layer
+ *  that was reserved for the passed in slot.
+ ***********************************************************/
+bool SceneManager::UploadGLTexture(const TextureLoader::IMAGE_DATA& image, int slot)
+{
+	TEXTURE_INFO& textureInfo = m_textureIDs[slot];
+
+	if (m_texturePool.IsCompatible(textureInfo.location, image.texture) == false)
+	{
+		std::cout << "Image does not match its reserved texture layer:" << image.filename << std::endl;
+		return false;
+	}
+
+	std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << image.colorChannels << std::endl;
+
+	// load the whole prebuilt mipmap chain, so there is no
+	// need to generate the mipmaps in the OpenGL driver
+	for (size_t level = 0; level < image.texture.mipLevels.size(); level++)
+	{
+		m_texturePool.UploadLevel(textureInfo.location, image.texture, level,
+			image.texture.mipLevels[level].data.data());
+	}
+
+	textureInfo.bLoaded = true;
+
+	return true;
+}
+
+/***********************************************************
+ *  SetTextureCacheOptions()
+ *
+ *  This method is used for turning the on-disk texture cache
+ *  and the block compression of cached textures on or off.
+ *  It needs to be called before the scene is prepared.
+ ***********************************************************/
+void SceneManager::SetTextureCacheOptions(bool bUseCache, bool bCompress)
+{
+	m_textureCache.SetEnabled(bUseCache);
+	m_textureCache.SetCompression(bCompress);
+}
+
+/***********************************************************
+ *  SetTextureStreaming()
+ *
+ *  This method is used for turning texture streaming on or
+ *  off.  When it is on, the scene starts rendering right away
+ *  with placeholder textures, and the real textures replace
+ *  them as they finish loading - at most the passed in number
+ *  of bytes are loaded into texture memory each frame.  It
+ *  needs to be called before the scene is prepared.
+ ***********************************************************/
+void SceneManager::SetTextureStreaming(bool bStreamTextures, size_t uploadBudgetBytes)
+{
+	m_bStreamTextures = bStreamTextures;
+	m_streamingBudgetBytes = uploadBudgetBytes;
+}
+
+/***********************************************************
+ *  StartTextureStreaming()
+ *
+ *  This method is used for registering every queued texture
+ *  tag to its slot, showing the placeholder texture, and then
+ *  starting to decode the real images in the background.
+ ***********************************************************/
+void SceneManager::StartTextureStreaming(TextureLoader& textureLoader)
+{
+	int firstSlot = 0;
+
+	m_streamingStartTime = std::chrono::steady_clock::now();
+
+	// register the tags right away so that they keep the same
+	// slots as when the textures are loaded before rendering
+	firstSlot = ReserveTextureLayers(textureLoader);
+
+	if (0 == m_streamingPBOs[0])
+	{
+		glGenBuffers(2, m_streamingPBOs);
+	}
+
+	if (NULL == m_pTextureStreamer)
+	{
+		m_pTextureStreamer = new TextureStreamer();
+	}
+	m_pTextureStreamer->Start(textureLoader.GetImages(), firstSlot, &m_textureCache);
+
+	std::cout << "INFO: Streaming " << textureLoader.GetImages().size() << " textures in the background" << std::endl;
+}
+
+/***********************************************************
+ *  UpdateTextureStreaming()
+ *
+ *  This method is used for loading decoded textures into
+ *  texture memory a few mipmap levels at a time, through
+ *  pixel buffer objects, so no single frame has to wait for
+ *  a whole texture.  Once all the levels of a texture are
+ *  loaded it replaces the placeholder in its slot.
+ ***********************************************************/
+void SceneManager::UpdateTextureStreaming()
+{
+	size_t uploadedBytes = 0;
+
+	if (NULL == m_pTextureStreamer)
+	{
+		return;
+	}
+
+	while (uploadedBytes < m_streamingBudgetBytes)
+	{
+		STREAMING_UPLOAD& upload = m_streamingUpload;
+
+		// start loading the next decoded texture
+		if (upload.bActive == false)
+		{
+			if (m_pTextureStreamer->PopDecodedImage(upload.streamedImage) == false)
+			{
+				break;
+			}
+
+			const TextureLoader::IMAGE_DATA& image = upload.streamedImage.image;
+			if ((image.bDecoded == false) ||
+				(m_texturePool.IsCompatible(m_textureIDs[upload.streamedImage.slot].location, image.texture) == false))
+			{
+				// the placeholder stays in the slot of a texture that
+				// could not be loaded
+				std::cout << "Could not load image:" << image.filename << std::endl;
+				continue;
+			}
+
+			upload.nextLevel = 0;
+			upload.bActive = true;
+		}
+
+		// copy the next mipmap level into a pixel buffer object, so
+		// the driver can transfer it without stalling this frame
+		TEXTURE_INFO& textureInfo = m_textureIDs[upload.streamedImage.slot];
+		const TextureCache::TEXTURE_DATA& texture = upload.streamedImage.image.texture;
+		const TextureCache::MIP_LEVEL& mipLevel = texture.mipLevels[upload.nextLevel];
+		GLuint pixelBuffer = m_streamingPBOs[m_nextStreamingPBO];
+		m_nextStreamingPBO = (m_nextStreamingPBO + 1) % 2;
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, mipLevel.data.size(), NULL, GL_STREAM_DRAW);
+		void* pMapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, mipLevel.data.size(),
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (NULL != pMapped)
+		{
+			memcpy(pMapped, mipLevel.data.data(), mipLevel.data.size());
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			m_texturePool.UploadLevel(textureInfo.location, texture, upload.nextLevel, (const void*)0);
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		uploadedBytes += mipLevel.data.size();
+		upload.nextLevel++;
+
+		// once every level is loaded, the texture replaces the
+		// placeholder in its slot
+		if (upload.nextLevel == texture.mipLevels.size())
+		{
+			textureInfo.bLoaded = true;
+
+			std::cout << "Successfully streamed image:" << upload.streamedImage.image.filename
+				<< ", decode:" << upload.streamedImage.image.decodeMilliseconds << " ms"
+				<< (upload.streamedImage.image.bFromCache ? " (cached)" : "") << std::endl;
+
+			upload.streamedImage.image.texture.mipLevels.clear();
+			upload.bActive = false;
+		}
+	}
+
+	// stop streaming once every texture has been loaded
+	if ((m_streamingUpload.bActive == false) && m_pTextureStreamer->IsFinished())
+	{
+		auto endTime = std::chrono::steady_clock::now();
+		std::cout << "INFO: Texture streaming finished in "
+			<< std::chrono::duration<double, std::milli>(endTime - m_streamingStartTime).count()
+			<< " ms" << std::endl;
+
+		delete m_pTextureStreamer;
+		m_pTextureStreamer = NULL;
+		glDeleteBuffers(2, m_streamingPBOs);
+		m_streamingPBOs[0] = 0;
+		m_streamingPBOs[1] = 0;
+	}
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for binding the texture arrays to
+ *  OpenGL texture units, and pointing the shader's array
+ *  samplers at them.  This only has to be done once, since
+ *  draws select their texture with a packed layer index.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	m_texturePool.BindArrays();
+
+	if (NULL != m_pUniformCache)
+	{
+		for (int i = 0; i < TexturePool::MAX_TEXTURE_ARRAYS; i++)
+		{
+			m_pUniformCache->SetIntValue(
+				std::string(g_TextureArrayName) + "[" + std::to_string(i) + "]",
+				(i < m_texturePool.GetArrayCount()) ? i : 0);
+		}
+	}
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory of all the
+ *  texture arrays.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	m_texturePool.Destroy();
+	m_textureIDs.clear();
+	m_textureHandles.clear();
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting a slot index for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(const std::string& tag)
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_textureHandles.find(tag);
+
+	if (found == m_textureHandles.end())
+	{
+		return(-1);
+	}
+
+	return(found->second);
+}
+
+/***********************************************************
+ *  GetTextureHandle()
+ *
+ *  This method is used for getting the handle of the texture
+ *  associated with the passed in tag, for use when rendering.
+ *  The handle is -1 when no texture has the tag.
+ ***********************************************************/
+int SceneManager::GetTextureHandle(const std::string& tag)
+{
+	return(FindTextureSlot(tag));
+}
+
+/***********************************************************
+ *  GetMaterialHandle()
+ *
+ *  This method is used for getting the handle of the material
+ *  associated with the passed in tag, for use when rendering.
+ *  The handle is -1 when no material has the tag.
+ ***********************************************************/
+int SceneManager::GetMaterialHandle(const std::string& tag)
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_materialHandles.find(tag);
+
+	if (found == m_materialHandles.end())
+	{
+		return(-1);
+	}
+
+	return(found->second);
+}
+
+/***********************************************************
+ *  FindObject()
+ *
+ *  This method is used for getting the index of the scene
+ *  object with the passed in name, which is also the index
+ *  of its transform.  The index is -1 when no object has the
+ *  name.
+ ***********************************************************/
+int SceneManager::FindObject(const std::string& name) const
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_objectNames.find(name);
+
+	if (found == m_objectNames.end())
+	{
+		return(-1);
+	}
+
+	return(found->second);
+}
+
+/***********************************************************
+ *  GetPackedTextureIndex()
+ *
+ *  This method is used for getting the packed array and layer
+ *  index the shader uses for the texture with the passed in
+ *  handle.  Textures that are not loaded yet use the
+ *  placeholder texture.
+ ***********************************************************/
+int SceneManager::GetPackedTextureIndex(int textureHandle) const
+{
+	TexturePool::TEXTURE_LOCATION location = m_texturePool.GetPlaceholder();
+
+	if ((textureHandle >= 0) && (textureHandle < (int)m_textureIDs.size()) &&
+		m_textureIDs[textureHandle].bLoaded)
+	{
+		location = m_textureIDs[textureHandle].location;
+	}
+
+	return(TexturePool::PackLocation(location));
+}
+
+/***********************************************************
+ *  CreateMaterialBuffer()
+ *
+ *  This method is used for uploading all of the defined
+ *  object materials into the material buffer, where their
+ *  handles are their indexes.
+ ***********************************************************/
+bool SceneManager::CreateMaterialBuffer()
+{
+	std::vector<MaterialBuffer::GPU_MATERIAL> materials;
+
+	for (size_t i = 0; i < m_objectMaterials.size(); i++)
+	{
+		materials.push_back(ConvertMaterial(m_objectMaterials[i]));
+	}
+
+	return(m_materialBuffer.Create(materials));
+}
+
+/***********************************************************
+ *  EditMaterial()
+ *
+ *  This method is used for changing the values of a defined
+ *  material while the scene is running.  Only the slot of
+ *  that material in the material buffer is rewritten.
+ ***********************************************************/
+bool SceneManager::EditMaterial(
+	int materialHandle,
+	const OBJECT_MATERIAL& material)
+{
+	if ((materialHandle < 0) || (materialHandle >= (int)m_objectMaterials.size()))
+	{
+		return(false);
+	}
+
+	// the tag stays the same, so the handle stays valid
+	std::string tag = m_objectMaterials[materialHandle].tag;
+	m_objectMaterials[materialHandle] = material;
+	m_objectMaterials[materialHandle].tag = tag;
+
+	return(m_materialBuffer.UpdateMaterial(materialHandle, ConvertMaterial(material)));
+}
+
+/***********************************************************
+ *  ConvertMaterial()
+ *
+ *  This method is used for converting an object material to
+ *  the layout the material buffer stores it in.
+ ***********************************************************/
+MaterialBuffer::GPU_MATERIAL SceneManager::ConvertMaterial(
+	const OBJECT_MATERIAL& material)
+{
+	MaterialBuffer::GPU_MATERIAL gpuMaterial;
+
+	gpuMaterial.ambientColor = material.ambientColor;
+	gpuMaterial.ambientStrength = material.ambientStrength;
+	gpuMaterial.diffuseColor = material.diffuseColor;
+	gpuMaterial.padding = 0.0f;
+	gpuMaterial.specularColor = material.specularColor;
+	gpuMaterial.shininess = material.shininess;
+
+	return(gpuMaterial);
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+ /***********************************************************
+
+  /***********************************************************
+ *  LoadSceneTextures()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the textures listed in the scene file into memory to
+ *  support the 3D scene rendering
+ ***********************************************************/
+void SceneManager::LoadSceneTextures()
+{
+	// all of the image files are decoded at the same time
+	TextureLoader textureLoader;
+
+	const SceneFile::TEXTURE_RECORD* pTextures = m_sceneFile.GetTextures();
+	for (uint32_t i = 0; i < m_sceneFile.GetTextureCount(); i++)
+	{
+		textureLoader.QueueImage(
+			m_sceneFile.GetString(pTextures[i].pathOffset),
+			m_sceneFile.GetString(pTextures[i].tagOffset));
+	}
+
+	// either stream the textures in while the scene renders, or
+	// load them all before the first frame
+	if (m_bStreamTextures)
+	{
+		StartTextureStreaming(textureLoader);
+	}
+	else
+	{
+		CreateGLTextures(textureLoader);
+	}
+
+	BindGLTextures();
+}
+
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering
+ ***********************************************************/
+void SceneManager::PrepareScene()
+{
+	// load the scene description, compiling it when it changed
+	if (m_sceneFile.Load(m_scenePath) == false)
+	{
+		std::cout << "ERROR: Could not load the 3D scene:" << m_scenePath << std::endl;
+		return;
+	}
+
+	// load the textures for the 3D scene
+	LoadSceneTextures();
+	DefineObjectMaterials();
+	// upload every material once, so draws only pass an index
+	if (CreateMaterialBuffer() == false)
+	{
+		std::cout << "ERROR: The object materials could not be uploaded" << std::endl;
+	}
+	SetupSceneLights();
+
+	// define the scene objects, whose texture and material
+	// references were resolved when the scene was compiled
+	DefineSceneObjects();
+
+	// the snapshot is not needed once the scene is built
+	m_sceneFile.Close();
+
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene
+
+	m_sceneMeshes.LoadMeshes();
+}
+/***********************************************************
+ *  DefineObjectMaterials()
+ *
+ *  This method is used for defining the object materials
+ *  listed in the scene file, and indexing them by tag for
+ *  resolving material handles.  A plain default material is
+ *  defined after them, for the objects that have none.
+ ***********************************************************/
+void SceneManager::DefineObjectMaterials()
+{
+	const SceneFile::MATERIAL_RECORD* pMaterials = m_sceneFile.GetMaterials();
+
+	m_objectMaterials.clear();
+	m_materialHandles.clear();
+	for (uint32_t i = 0; i < m_sceneFile.GetMaterialCount(); i++)
+	{
+		const SceneFile::MATERIAL_RECORD& record = pMaterials[i];
+
+		OBJECT_MATERIAL material;
+		material.ambientColor = glm::vec3(record.ambientColor[0], record.ambientColor[1], record.ambientColor[2]);
+		material.ambientStrength = record.ambientStrength;
+		material.diffuseColor = glm::vec3(record.diffuseColor[0], record.diffuseColor[1], record.diffuseColor[2]);
+		material.specularColor = glm::vec3(record.specularColor[0], record.specularColor[1], record.specularColor[2]);
+		material.shininess = record.shininess;
+		material.tag = m_sceneFile.GetString(record.tagOffset);
+
+		m_materialHandles[material.tag] = (int)m_objectMaterials.size();
+		m_objectMaterials.push_back(material);
+	}
+
+	OBJECT_MATERIAL defaultMaterial;
+	defaultMaterial.ambientColor = glm::vec3(0.2f, 0.2f, 0.2f);
+	defaultMaterial.ambientStrength = 0.2f;
+	defaultMaterial.diffuseColor = glm::vec3(0.5f, 0.5f, 0.5f);
+	defaultMaterial.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
+	defaultMaterial.shininess = 8.0f;
+	defaultMaterial.tag = g_DefaultMaterialTag;
+
+	m_defaultMaterialHandle = (int)m_objectMaterials.size();
+	m_objectMaterials.push_back(defaultMaterial);
+}
+/***********************************************************
+ *  SetupSceneLights()
+ *
+ *  This method is called to add and configure the light
+ *  sources listed in the scene file.
+ ***********************************************************/
+void SceneManager::SetupSceneLights()
+{
+	const SceneFile::LIGHT_RECORD* pLights = m_sceneFile.GetLights();
+
+	m_lightManager.Clear();
+	for (uint32_t i = 0; i < m_sceneFile.GetLightCount(); i++)
+	{
+		const SceneFile::LIGHT_RECORD& record = pLights[i];
+
+		LightManager::LIGHT_SOURCE light;
+		light.position = glm::vec3(record.position[0], record.position[1], record.position[2]);
+		light.ambientColor = glm::vec3(record.ambientColor[0], record.ambientColor[1], record.ambientColor[2]);
+		light.diffuseColor = glm::vec3(record.diffuseColor[0], record.diffuseColor[1], record.diffuseColor[2]);
+		light.specularColor = glm::vec3(record.specularColor[0], record.specularColor[1], record.specularColor[2]);
+		light.focalStrength = record.focalStrength;
+		light.specularIntensity = record.specularIntensity;
+		m_lightManager.AddLight(light);
+	}
+
+	// lights that share a position and highlight are merged
+	// into one light with their summed colors
+	int mergedCount = m_lightManager.MergeRedundantLights();
+	if (mergedCount > 0)
+	{
+		std::cout << "Merged " << mergedCount << " redundant lights, "
+			<< m_lightManager.GetLightCount() << " lights remain" << std::endl;
+	}
+	m_lightManager.Update();
+
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->SetBoolValue(g_UseLightingName, true);
+	}
+}
+/***********************************************************
+ *  DefineSceneObjects()
+ *
+ *  This method is used for defining the objects drawn in the
+ *  3D scene from the object records of the scene file.  The
+ *  records already hold texture and material indexes, which
+ *  are turned into handles with one lookup per texture and
+ *  material, so this stays linear in the number of objects.
+ *  Objects without a material, including those whose tag the
+ *  scene file did not define, get the default material, and
+ *  a warning says how many there are.
+ ***********************************************************/
+void SceneManager::DefineSceneObjects()
+{
+	std::vector<int> textureHandles(m_sceneFile.GetTextureCount(), -1);
+	std::vector<int> materialHandles(m_sceneFile.GetMaterialCount(), -1);
+
+	for (uint32_t i = 0; i < m_sceneFile.GetTextureCount(); i++)
+	{
+		textureHandles[i] = GetTextureHandle(m_sceneFile.GetString(m_sceneFile.GetTextures()[i].tagOffset));
+	}
+	for (uint32_t i = 0; i < m_sceneFile.GetMaterialCount(); i++)
+	{
+		materialHandles[i] = GetMaterialHandle(m_sceneFile.GetString(m_sceneFile.GetMaterials()[i].tagOffset));
+	}
+
+	const SceneFile::OBJECT_RECORD* pObjects = m_sceneFile.GetObjects();
+
+	m_sceneObjects.clear();
+	m_sceneObjects.reserve(m_sceneFile.GetObjectCount());
+	m_objectTransforms.Clear();
+	m_objectTransforms.Reserve(m_sceneFile.GetObjectCount());
+	m_objectNames.clear();
+	int defaultMaterialCount = 0;
+	for (uint32_t i = 0; i < m_sceneFile.GetObjectCount(); i++)
+	{
+		const SceneFile::OBJECT_RECORD& record = pObjects[i];
+		SCENE_OBJECT sceneObject;
+
+		// parents come before their children in the scene file, so
+		// the record and transform indexes stay the same
+		TransformHierarchy::TRANSFORM transform;
+		transform.scaleXYZ = glm::vec3(record.scale[0], record.scale[1], record.scale[2]);
+		transform.rotationDegrees = glm::vec3(record.rotationDegrees[0], record.rotationDegrees[1], record.rotationDegrees[2]);
+		transform.positionXYZ = glm::vec3(record.position[0], record.position[1], record.position[2]);
+		m_objectTransforms.AddTransform(transform, record.parentIndex);
+
+		const char* name = m_sceneFile.GetString(record.nameOffset);
+		if (name[0] != '\0')
+		{
+			m_objectNames[name] = (int)i;
+		}
+
+		sceneObject.mesh = (SceneFile::MESH_TYPE)record.mesh;
+		sceneObject.color = glm::vec4(record.color[0], record.color[1], record.color[2], record.color[3]);
+		sceneObject.textureHandle = (record.textureIndex >= 0) ? textureHandles[record.textureIndex] : -1;
+		sceneObject.materialHandle = (record.materialIndex >= 0) ? materialHandles[record.materialIndex] : -1;
+		if (sceneObject.materialHandle < 0)
+		{
+			sceneObject.materialHandle = m_defaultMaterialHandle;
+			defaultMaterialCount++;
+		}
+
+		m_sceneObjects.push_back(sceneObject);
+	}
+
+	if (defaultMaterialCount > 0)
+	{
+		std::cout << "WARNING: " << defaultMaterialCount
+			<< " scene objects have no material or an unknown material tag, and use the default material" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  UpdateObjectBounds()
+ *
+ *  This method is used for moving the bounding volumes of
+ *  the meshes to where each object is in the world.  The
+ *  volumes are only built again after an object has moved.
+ *  The sphere grows by the largest scale of the object, and
+ *  the box becomes the axis aligned box around the turned
+ *  mesh box.
+ ***********************************************************/
+void SceneManager::UpdateObjectBounds()
+{
+	if ((m_objectBounds.size() == m_sceneObjects.size()) &&
+		(m_boundsVersion == m_objectTransforms.GetVersion()))
+	{
+		return;
+	}
+
+	m_objectBounds.resize(m_sceneObjects.size());
+	for (size_t i = 0; i < m_sceneObjects.size(); i++)
+	{
+		const SceneMeshes::MESH_BOUNDS& meshBounds = m_sceneMeshes.GetMeshBounds(m_sceneObjects[i].mesh);
+		const glm::mat4& model = m_objectTransforms.GetWorldMatrix((int)i);
+		OBJECT_BOUNDS& bounds = m_objectBounds[i];
+
+		float largestScale = 0.0f;
+		for (int column = 0; column < 3; column++)
+		{
+			largestScale = std::max(largestScale, glm::length(glm::vec3(model[column])));
+		}
+		bounds.sphereCenter = glm::vec3(model * glm::vec4(meshBounds.sphereCenter, 1.0f));
+		bounds.sphereRadius = meshBounds.sphereRadius * largestScale;
+
+		glm::vec3 boxCenter = (meshBounds.boxMinimum + meshBounds.boxMaximum) * 0.5f;
+		glm::vec3 boxExtent = (meshBounds.boxMaximum - meshBounds.boxMinimum) * 0.5f;
+		glm::vec3 worldCenter = glm::vec3(model * glm::vec4(boxCenter, 1.0f));
+		glm::vec3 worldExtent(0.0f);
+		for (int axis = 0; axis < 3; axis++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				worldExtent[axis] += std::fabs(model[column][axis]) * boxExtent[column];
+			}
+		}
+		bounds.boxMinimum = worldCenter - worldExtent;
+		bounds.boxMaximum = worldCenter + worldExtent;
+	}
+
+	m_boundsVersion = m_objectTransforms.GetVersion();
+}
+
+/***********************************************************
+ *  SelectDetailLevel()
+ *
+ *  This method is used for choosing the level of detail of
+ *  an object from the size of its bounding sphere on the
+ *  screen.  The projected radius is the radius scaled by the
+ *  projection and divided by the distance in front of the
+ *  camera, which is the W of the sphere center.  An object
+ *  only moves to a coarser level once it is smaller than the
+ *  level's size by the hysteresis, and to a finer level once
+ *  it is larger by it, so it keeps its level while its size
+ *  hovers near one.
+ ***********************************************************/
+int SceneManager::SelectDetailLevel(size_t objectIndex, int currentLevel) const
+{
+	int levelCount = m_sceneMeshes.GetLevelCount(m_sceneObjects[objectIndex].mesh);
+	const OBJECT_BOUNDS& bounds = m_objectBounds[objectIndex];
+
+	if (!m_bLevelOfDetail || (levelCount <= 1))
+	{
+		return(0);
+	}
+
+	// the second row of the view projection is the camera's up
+	// axis scaled by the projection, so its length is the scale
+	glm::vec3 projectionRow(m_viewProjection[0][1], m_viewProjection[1][1], m_viewProjection[2][1]);
+	float w = m_viewProjection[0][3] * bounds.sphereCenter.x +
+		m_viewProjection[1][3] * bounds.sphereCenter.y +
+		m_viewProjection[2][3] * bounds.sphereCenter.z +
+		m_viewProjection[3][3];
+
+	// the camera inside of, or just behind, the sphere sees it at
+	// its largest
+	float screenSize = bounds.sphereRadius * glm::length(projectionRow) / std::max(w, bounds.sphereRadius);
+
+	int level = std::min(std::max(currentLevel, 0), levelCount - 1);
+	while ((level > 0) && (screenSize > g_DetailLevelSizes[level - 1] * (1.0f + g_DetailLevelHysteresis)))
+	{
+		level--;
+	}
+	while ((level < levelCount - 1) && (screenSize < g_DetailLevelSizes[level] * (1.0f - g_DetailLevelHysteresis)))
+	{
+		level++;
+	}
+
+	return(level);
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by
+ *  transforming and drawing the basic 3D shapes
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	PROFILE_SCOPE("RenderScene");
+
+	BuildFramePacket(m_framePacket);
+	SubmitFramePacket(m_framePacket);
+}
+
+/***********************************************************
+ *  BuildFramePacket()
+ *
+ *  This method is used for doing the work of a frame that
+ *  needs no OpenGL context: moving the objects, culling and
+ *  sorting them, and gathering their instance data and draws
+ *  into the packet.  It may run on a thread of its own, as
+ *  long as nothing else moves the objects meanwhile, and the
+ *  camera is set before it from the same thread.
+ ***********************************************************/
+void SceneManager::BuildFramePacket(FramePipeline::FRAME_PACKET& packet)
+{
+	PROFILE_SCOPE("BuildFramePacket");
+
+	// build the world matrices of any objects that moved
+	m_objectTransforms.Update();
+
+	BuildRenderQueue(packet);
+	BuildDraws(packet);
+}
+
+/***********************************************************
+ *  SubmitFramePacket()
+ *
+ *  This method is used for making the OpenGL calls of a
+ *  built frame: loading streamed textures and changed lights,
+ *  uploading the instance data and drawing it.
+ ***********************************************************/
+void SceneManager::SubmitFramePacket(FramePipeline::FRAME_PACKET& packet)
+{
+	PROFILE_SCOPE("SubmitFramePacket");
+
+	{
+		PROFILE_SCOPE("UpdateScene");
+		PROFILE_GPU_SCOPE("UpdateScene");
+
+		// load any streamed textures that are ready
+		UpdateTextureStreaming();
+		// upload any lights that changed since the last frame
+		m_lightManager.Update();
+	}
+
+	m_culledCount = packet.culledCount;
+	m_drawnCount = packet.drawnCount;
+	m_drawnTriangleCount = packet.drawnTriangleCount;
+	m_stateChanges = packet.stateChanges;
+	m_avoidedStateChanges = packet.avoidedStateChanges;
+	RenderStats::Add(RenderStats::DRAWN_OBJECTS, packet.drawnCount);
+	RenderStats::Add(RenderStats::CULLED_OBJECTS, packet.culledCount);
+
+	if (NULL == m_pUniformCache)
+	{
+		return;
+	}
+
+	UploadInstances(packet);
+	DrawFramePacket(packet);
+}
+
+/***********************************************************
+ *  BuildRenderQueue()
+ *
+ *  This method is used for queueing every object that is in
+ *  view, at the level of detail chosen for its size on the
+ *  screen, and sorting the queue.
+ ***********************************************************/
+void SceneManager::BuildRenderQueue(FramePipeline::FRAME_PACKET& packet)
+{
+	PROFILE_SCOPE("BuildRenderQueue");
+
+	UpdateObjectBounds();
+	m_objectLevels.resize(m_sceneObjects.size(), 0);
+
+	// queue every object that is in view with a key made from its
+	// state and its distance from the camera, and sort the queue so
+	// that objects sharing a mesh, level of detail, texture and
+	// material are next to each other
+	m_renderQueue.Clear();
+	packet.culledCount = 0;
+	for (size_t i = 0; i < m_sceneObjects.size(); i++)
+	{
+		const SCENE_OBJECT& sceneObject = m_sceneObjects[i];
+
+		// the sphere test is cheaper and rejects most hidden objects,
+		// and the box test catches long, thin objects the sphere misses
+		if (m_bFrustumCulling)
+		{
+			const OBJECT_BOUNDS& bounds = m_objectBounds[i];
+			if ((m_viewFrustum.IsSphereVisible(bounds.sphereCenter, bounds.sphereRadius) == false) ||
+				(m_viewFrustum.IsBoxVisible(bounds.boxMinimum, bounds.boxMaximum) == false))
+			{
+				packet.culledCount++;
+				continue;
+			}
+		}
+		glm::vec3 worldPosition = m_objectTransforms.GetWorldPosition((int)i);
+		float depth = glm::length(worldPosition - m_viewPosition) / g_SortDepthRange;
+
+		m_objectLevels[i] = (uint8_t)SelectDetailLevel(i, m_objectLevels[i]);
+
+		// each level of a mesh sorts as a mesh of its own, and the
+		// handles are offset by one so that no handle sorts first
+		m_renderQueue.AddItem(
+			RenderQueue::MakeSortKey(
+				sceneObject.mesh * SceneMeshes::MAX_DETAIL_LEVELS + m_objectLevels[i],
+				sceneObject.textureHandle + 1,
+				sceneObject.materialHandle + 1,
+				depth),
+			(uint32_t)i);
+	}
+	m_renderQueue.Sort();
+
+	packet.drawnCount = m_renderQueue.GetItems().size();
+	packet.stateChanges = m_renderQueue.GetStateChanges();
+	packet.avoidedStateChanges = m_renderQueue.GetAvoidedStateChanges();
+}
+
+/***********************************************************
+ *  BuildDraws()
+ *
+ *  This method is used for gathering the instance data of
+ *  the queued objects, and the draws that draw them.
+ ***********************************************************/
+void SceneManager::BuildDraws(FramePipeline::FRAME_PACKET& packet)
+{
+	PROFILE_SCOPE("BuildDraws");
+
+	// gather the instance data of every object in sorted order,
+	// so that the instances of each mesh are next to each other
+	const std::vector<RenderQueue::DRAW_ITEM>& drawItems = m_renderQueue.GetItems();
+
+	packet.instances.resize(drawItems.size());
+	packet.drawnTriangleCount = 0;
+	for (size_t i = 0; i < drawItems.size(); i++)
+	{
+		const SCENE_OBJECT& sceneObject = m_sceneObjects[drawItems[i].objectIndex];
+		SceneMeshes::INSTANCE_DATA& instance = packet.instances[i];
+
+		packet.drawnTriangleCount += m_sceneMeshes.GetMeshRange(sceneObject.mesh, m_objectLevels[drawItems[i].objectIndex]).indexCount / 3;
+
+		instance.model = m_objectTransforms.GetWorldMatrix((int)drawItems[i].objectIndex);
+		instance.color = sceneObject.color;
+		instance.textureIndex = sceneObject.textureHandle;
+		instance.materialIndex = sceneObject.materialHandle;
+		instance.padding[0] = 0;
+		instance.padding[1] = 0;
+	}
+
+	packet.bIndirectDrawing = IsIndirectDrawing();
+	packet.drawBatches.clear();
+	packet.drawCommands.clear();
+
+	if (packet.bIndirectDrawing)
+	{
+		// one command for each object, whose base instance and draw
+		// index both select the object's instance data, so the whole
+		// scene is drawn with one call
+		packet.drawCommands.resize(drawItems.size());
+		for (size_t i = 0; i < drawItems.size(); i++)
+		{
+			uint32_t objectIndex = drawItems[i].objectIndex;
+			const SceneMeshes::MESH_RANGE& range = m_sceneMeshes.GetMeshRange(m_sceneObjects[objectIndex].mesh, m_objectLevels[objectIndex]);
+			SceneMeshes::DRAW_COMMAND& command = packet.drawCommands[i];
+
+			command.indexCount = (GLuint)range.indexCount;
+			command.instanceCount = 1;
+			command.firstIndex = range.firstIndex;
+			command.baseVertex = range.baseVertex;
+			command.baseInstance = (GLuint)i;
+		}
+		return;
+	}
+
+	// otherwise each run of instances that share a mesh and level
+	// of detail is drawn with one call
+	size_t firstInstance = 0;
+	while (firstInstance < drawItems.size())
+	{
+		uint32_t meshLevel = RenderQueue::GetMesh(drawItems[firstInstance].sortKey);
+		size_t instanceCount = 1;
+
+		while ((firstInstance + instanceCount < drawItems.size()) &&
+			(RenderQueue::GetMesh(drawItems[firstInstance + instanceCount].sortKey) == meshLevel))
+		{
+			instanceCount++;
+		}
+
+		FramePipeline::DRAW_BATCH batch;
+		batch.mesh = (SceneFile::MESH_TYPE)(meshLevel / SceneMeshes::MAX_DETAIL_LEVELS);
+		batch.level = (int)(meshLevel % SceneMeshes::MAX_DETAIL_LEVELS);
+		batch.firstInstance = (GLuint)firstInstance;
+		batch.instanceCount = (GLsizei)instanceCount;
+		packet.drawBatches.push_back(batch);
+
+		firstInstance += instanceCount;
+	}
+}
+
+/***********************************************************
+ *  UploadInstances()
+ *
+ *  This method is used for uploading the instance data of
+ *  the packet, once the texture handles in it are turned
+ *  into the texture arrays and layers they are loaded in.
+ ***********************************************************/
+void SceneManager::UploadInstances(FramePipeline::FRAME_PACKET& packet)
+{
+	PROFILE_SCOPE("UploadInstances");
+	PROFILE_GPU_SCOPE("UploadInstances");
+
+	for (size_t i = 0; i < packet.instances.size(); i++)
+	{
+		SceneMeshes::INSTANCE_DATA& instance = packet.instances[i];
+		instance.textureIndex = (instance.textureIndex >= 0) ? GetPackedTextureIndex(instance.textureIndex) : -1;
+	}
+	m_sceneMeshes.UploadInstances(packet.instances);
+}
+
+/***********************************************************
+ *  DrawFramePacket()
+ *
+ *  This method is used for drawing the uploaded instances
+ *  with the draws of the packet.
+ ***********************************************************/
+void SceneManager::DrawFramePacket(const FramePipeline::FRAME_PACKET& packet)
+{
+	PROFILE_SCOPE("DrawFramePacket");
+	PROFILE_GPU_SCOPE("DrawFramePacket");
+
+	// every draw reads from the one vertex array that holds every
+	// mesh, and the instance attributes are used whenever the draw
+	// data buffer is not
+	m_sceneMeshes.BindVertexArray();
+
+	if (packet.bIndirectDrawing)
+	{
+		m_pUniformCache->SetBoolValue(m_uniforms.useDrawData, m_sceneMeshes.HasDrawIndex());
+		m_sceneMeshes.DrawIndirect(packet.drawCommands);
+		glBindVertexArray(0);
+		return;
+	}
+
+	m_pUniformCache->SetBoolValue(m_uniforms.useDrawData, false);
+	for (size_t i = 0; i < packet.drawBatches.size(); i++)
+	{
+		const FramePipeline::DRAW_BATCH& batch = packet.drawBatches[i];
+		m_sceneMeshes.DrawMeshInstanced(batch.mesh, batch.level, batch.firstInstance, batch.instanceCount);
+	}
+	glBindVertexArray(0);
+}
@@ -1,115 +1,285 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.h
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager *pShaderManager);
-	// destructor
-	~SceneManager();
-
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	struct OBJECT_MATERIAL
-	{
-		float ambientStrength;
-		glm::vec3 ambientColor;
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
-	void BindGLTextures();
-	// free the loaded OpenGL textures
-	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	// set the UV scale for the texture mapping
-	void SetTextureUVScale(
-		float u, float v);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-public:
-
-	// The following methods are for the students to 
-	// customize for their own 3D scene
-	void PrepareScene();
-	void RenderScene();
-
-	// loads textures from image files
-	void LoadSceneTextures();
-
-	// pre-define the object materials for lighting
-	void DefineObjectMaterials();
-
-	// pre-set light sources for 3D scene
-	void SetupSceneLights();
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.h
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "UniformCache.h"
+#include "MaterialBuffer.h"
+#include "LightManager.h"
+#include "SceneFile.h"
+#include "RenderQueue.h"
+#include "Frustum.h"
+#include "SceneMeshes.h"
+#include "TransformHierarchy.h"
+#include "TextureCache.h"
+#include "TextureLoader.h"
+#include "TexturePool.h"
+#include "TextureStreamer.h"
+#include "FramePipeline.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor
+	SceneManager(ShaderManager *pShaderManager, UniformCache* pUniformCache);
+	// destructor
+	~SceneManager();
+
+	struct TEXTURE_INFO
+	{
+		std::string tag;
+		TexturePool::TEXTURE_LOCATION location;
+		bool bLoaded;
+	};
+
+	struct OBJECT_MATERIAL
+	{
+		float ambientStrength;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		std::string tag;
+	};
+
+	// the transform of a scene object has the same index as the
+	// object in the transform hierarchy
+	struct SCENE_OBJECT
+	{
+		SceneFile::MESH_TYPE mesh;
+		glm::vec4 color;
+		int textureHandle;
+		int materialHandle;
+	};
+
+private:
+	// handles of the uniforms that are set for every draw
+	struct SCENE_UNIFORMS
+	{
+		int useDrawData;
+	};
+
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to the uniform cache that sets the shader values
+	UniformCache* m_pUniformCache;
+	// handles of the per draw uniforms
+	SCENE_UNIFORMS m_uniforms;
+	// basic shape meshes, drawn instanced or with multi-draw indirect
+	SceneMeshes m_sceneMeshes;
+	// packet that RenderScene() builds and submits each frame
+	FramePipeline::FRAME_PACKET m_framePacket;
+	// true when the scene is drawn with one multi-draw indirect
+	// call, which can be changed while a frame is being built
+	std::atomic<bool> m_bIndirectDrawing;
+	// loaded textures info
+	std::vector<TEXTURE_INFO> m_textureIDs;
+	// texture arrays holding the loaded textures
+	TexturePool m_texturePool;
+	// texture slots indexed by texture tag
+	std::unordered_map<std::string, int> m_textureHandles;
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// material indexes indexed by material tag
+	std::unordered_map<std::string, int> m_materialHandles;
+	// material of the objects that have none, or an unknown tag,
+	// which follows the materials of the scene file
+	int m_defaultMaterialHandle;
+	// uniform buffer holding the object materials
+	MaterialBuffer m_materialBuffer;
+	// storage buffer holding the scene lights
+	LightManager m_lightManager;
+	// objects drawn in the 3D scene
+	std::vector<SCENE_OBJECT> m_sceneObjects;
+	// transforms and cached world matrices of the scene objects
+	TransformHierarchy m_objectTransforms;
+	// object indexes indexed by object name
+	std::unordered_map<std::string, int> m_objectNames;
+	// path of the text scene file
+	std::string m_scenePath;
+	// compiled snapshot of the scene file, mapped while the scene is built
+	SceneFile m_sceneFile;
+	// draws of the frame, sorted by state and depth
+	RenderQueue m_renderQueue;
+	// camera position used for the depth of the draws
+	glm::vec3 m_viewPosition;
+
+	// world space bounding volumes of a scene object
+	struct OBJECT_BOUNDS
+	{
+		glm::vec3 sphereCenter;
+		float sphereRadius;
+		glm::vec3 boxMinimum;
+		glm::vec3 boxMaximum;
+	};
+
+	// view frustum of the camera that the objects are culled against
+	Frustum m_viewFrustum;
+	// true when objects outside of the view frustum are not drawn
+	bool m_bFrustumCulling;
+	// bounding volumes of the scene objects, in world space
+	std::vector<OBJECT_BOUNDS> m_objectBounds;
+	// version of the object transforms the bounds were built from
+	uint32_t m_boundsVersion;
+	// number of objects culled and drawn in the last frame submitted
+	size_t m_culledCount;
+	size_t m_drawnCount;
+	// view and projection matrix the levels of detail are chosen by
+	glm::mat4 m_viewProjection;
+	// true when small objects are drawn with coarser meshes
+	bool m_bLevelOfDetail;
+	// level of detail each scene object was last drawn with
+	std::vector<uint8_t> m_objectLevels;
+	// number of triangles drawn in the last frame submitted
+	size_t m_drawnTriangleCount;
+	// state changes of the last frame submitted, and those avoided
+	unsigned int m_stateChanges;
+	unsigned int m_avoidedStateChanges;
+	// on-disk cache of decoded textures
+	TextureCache m_textureCache;
+
+	// a texture that is being streamed into texture memory
+	struct STREAMING_UPLOAD
+	{
+		bool bActive;
+		TextureStreamer::STREAMED_IMAGE streamedImage;
+		size_t nextLevel;
+	};
+
+	// true when textures are streamed in while the scene renders
+	bool m_bStreamTextures;
+	// most texture bytes streamed into texture memory per frame
+	size_t m_streamingBudgetBytes;
+	// decodes the streamed textures in the background
+	TextureStreamer* m_pTextureStreamer;
+	// pixel buffer objects used for streaming texture data
+	GLuint m_streamingPBOs[2];
+	int m_nextStreamingPBO;
+	// the streamed texture currently being loaded
+	STREAMING_UPLOAD m_streamingUpload;
+	// time the texture streaming was started
+	std::chrono::steady_clock::time_point m_streamingStartTime;
+
+	// load all queued texture images using worker threads
+	bool CreateGLTextures(TextureLoader& textureLoader);
+	// register the queued textures and reserve their array layers
+	int ReserveTextureLayers(TextureLoader& textureLoader);
+	// load a decoded texture image into its texture array layer
+	bool UploadGLTexture(const TextureLoader::IMAGE_DATA& image, int slot);
+	// register placeholders and start streaming the queued textures
+	void StartTextureStreaming(TextureLoader& textureLoader);
+	// bind the texture arrays to texture units in memory
+	void BindGLTextures();
+	// free the loaded OpenGL textures
+	void DestroyGLTextures();
+	// find a loaded texture by tag
+	int FindTextureSlot(const std::string& tag);
+	// get the packed index the shader uses for a texture
+	int GetPackedTextureIndex(int textureHandle) const;
+	// upload the object materials into the material buffer
+	bool CreateMaterialBuffer();
+	// move the object bounding volumes to where the objects are
+	void UpdateObjectBounds();
+	// choose the level of detail of an object from its size on the screen
+	int SelectDetailLevel(size_t objectIndex, int currentLevel) const;
+	// the passes of a frame: queue and sort the objects in view and
+	// gather their instance data and draws into the frame packet,
+	// then upload the instance data and draw them
+	void BuildRenderQueue(FramePipeline::FRAME_PACKET& packet);
+	void BuildDraws(FramePipeline::FRAME_PACKET& packet);
+	void UploadInstances(FramePipeline::FRAME_PACKET& packet);
+	void DrawFramePacket(const FramePipeline::FRAME_PACKET& packet);
+	// convert an object material to the material buffer layout
+	static MaterialBuffer::GPU_MATERIAL ConvertMaterial(
+		const OBJECT_MATERIAL& material);
+
+public:
+
+	// set the camera position that the draws are sorted by
+	void SetViewPosition(const glm::vec3& viewPosition) { m_viewPosition = viewPosition; }
+	// set the view and projection matrix used for culling the objects
+	// and choosing their levels of detail
+	void SetViewProjection(const glm::mat4& viewProjection) { m_viewProjection = viewProjection; m_viewFrustum.SetViewProjection(viewProjection); }
+	// turn culling of the objects outside of the view on or off
+	void SetFrustumCulling(bool bFrustumCulling) { m_bFrustumCulling = bFrustumCulling; }
+	// turn drawing small objects with coarser meshes on or off
+	void SetLevelOfDetail(bool bLevelOfDetail) { m_bLevelOfDetail = bLevelOfDetail; }
+	// draw the scene with one multi-draw indirect call, when it is
+	// supported, instead of one instanced draw for each mesh
+	void SetIndirectDrawing(bool bIndirectDrawing) { m_bIndirectDrawing = bIndirectDrawing; }
+	// check whether the scene is being drawn with multi-draw indirect
+	bool IsIndirectDrawing() const { return m_bIndirectDrawing && m_sceneMeshes.IsIndirectSupported(); }
+	// get the number of objects culled and drawn in the last frame
+	size_t GetCulledCount() const { return m_culledCount; }
+	size_t GetDrawnCount() const { return m_drawnCount; }
+	// get the number of triangles drawn in the last frame
+	size_t GetDrawnTriangleCount() const { return m_drawnTriangleCount; }
+	// get the state changes of the last frame, and those that sorting
+	// the render queue avoided
+	unsigned int GetStateChanges() const { return m_stateChanges; }
+	unsigned int GetAvoidedStateChanges() const { return m_avoidedStateChanges; }
+	// set the text scene file that PrepareScene() loads
+	void SetSceneFile(const std::string& scenePath) { m_scenePath = scenePath; }
+	// turn the on-disk texture cache and texture compression on or off
+	void SetTextureCacheOptions(bool bUseCache, bool bCompress);
+	// turn streaming of textures while the scene renders on or off
+	void SetTextureStreaming(bool bStreamTextures, size_t uploadBudgetBytes = 4 * 1024 * 1024);
+	// load streamed textures into texture memory, within the frame budget
+	void UpdateTextureStreaming();
+
+	// get the handles used for rendering with a texture or material
+	int GetTextureHandle(const std::string& tag);
+	int GetMaterialHandle(const std::string& tag);
+	// change a defined material while the scene is running
+	bool EditMaterial(
+		int materialHandle,
+		const OBJECT_MATERIAL& material);
+	// get the lights of the scene, for changing them while it runs
+	LightManager& GetLightManager() { return m_lightManager; }
+	// get the object transforms, for moving objects while the scene runs
+	TransformHierarchy& GetObjectTransforms() { return m_objectTransforms; }
+	// find a named scene object, and get its index
+	int FindObject(const std::string& name) const;
+
+	// The following methods are for the students to 
+	// customize for their own 3D scene
+	void PrepareScene();
+	void RenderScene();
+
+	// build a frame into a packet, which makes no OpenGL calls, so
+	// it can run on another thread than the one that submits it
+	void BuildFramePacket(FramePipeline::FRAME_PACKET& packet);
+	// make the OpenGL calls that draw a built frame
+	void SubmitFramePacket(FramePipeline::FRAME_PACKET& packet);
+
+	// loads textures from image files
+	void LoadSceneTextures();
+
+	// pre-define the object materials for lighting
+	void DefineObjectMaterials();
+
+	// pre-set light sources for 3D scene
+	void SetupSceneLights();
+
+	// define the objects drawn in the 3D scene
+	void DefineSceneObjects();
 };
\ No newline at end of file
@@ -0,0 +1,546 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenemeshes.cpp
+// ============
+// build the basic scene meshes and draw many instances of them at once
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneMeshes.h"
+#include "RenderStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// declaration of global variables
+namespace
+{
+	const float g_Pi = 3.14159265358979f;
+
+	// number of sides around the cylinder, for each level of detail
+	const int g_CylinderSides[SceneMeshes::MAX_DETAIL_LEVELS] = { 36, 18, 10 };
+	// number of segments around the torus ring and around its tube,
+	// for each level of detail
+	const int g_TorusMainSegments[SceneMeshes::MAX_DETAIL_LEVELS] = { 30, 18, 10 };
+	const int g_TorusTubeSegments[SceneMeshes::MAX_DETAIL_LEVELS] = { 30, 12, 6 };
+	// radius of the torus ring and of its tube
+	const float g_TorusMainRadius = 1.0f;
+	const float g_TorusTubeRadius = 0.2f;
+
+	// number of instances the instance buffer starts with room for
+	const size_t g_InitialInstanceCapacity = 256;
+	// number of commands the command buffer starts with room for
+	const size_t g_InitialCommandCapacity = 256;
+}
+
+static_assert(sizeof(SceneMeshes::INSTANCE_DATA) == 96, "INSTANCE_DATA must stay tightly packed");
+static_assert(sizeof(SceneMeshes::DRAW_COMMAND) == 20, "DRAW_COMMAND must match the indirect command layout");
+
+/***********************************************************
+ *  SceneMeshes()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneMeshes::SceneMeshes()
+{
+	for (int i = 0; i < SceneFile::MESH_TYPE_COUNT; i++)
+	{
+		for (int level = 0; level < MAX_DETAIL_LEVELS; level++)
+		{
+			m_meshes[i][level].range.baseVertex = 0;
+			m_meshes[i][level].range.firstIndex = 0;
+			m_meshes[i][level].range.indexCount = 0;
+			m_meshes[i][level].bounds = ComputeBounds(std::vector<VERTEX>());
+		}
+		m_levelCounts[i] = 1;
+	}
+	m_vao = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_instanceBuffer = 0;
+	m_instanceCapacity = 0;
+	m_commandBuffer = 0;
+	m_commandCapacity = 0;
+	m_bIndirectSupported = false;
+	m_bDrawIndexSupported = false;
+}
+
+/***********************************************************
+ *  ~SceneMeshes()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneMeshes::~SceneMeshes()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  LoadMeshes()
+ *
+ *  This method is used for building every mesh into the
+ *  shared buffers, along with the instance buffer that the
+ *  vertex array reads from.
+ ***********************************************************/
+bool SceneMeshes::LoadMeshes()
+{
+	std::vector<VERTEX> vertices;
+	std::vector<GLuint> indices;
+	std::vector<VERTEX> sharedVertices;
+	std::vector<GLuint> sharedIndices;
+
+	Destroy();
+
+	// the instance buffer always has storage, so that single
+	// draws never read the instance attributes out of bounds
+	m_instanceCapacity = g_InitialInstanceCapacity;
+	glGenBuffers(1, &m_instanceBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(INSTANCE_DATA), NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// multi-draw indirect is core in OpenGL 4.3, and the index of
+	// each draw reaches the shaders in 4.6 or with the extension
+	m_bIndirectSupported = (GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect) ? true : false;
+	m_bDrawIndexSupported = m_bIndirectSupported && (GLEW_VERSION_4_6 || GLEW_ARB_shader_draw_parameters);
+	if (m_bIndirectSupported)
+	{
+		m_commandCapacity = g_InitialCommandCapacity;
+		glGenBuffers(1, &m_commandBuffer);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, m_commandCapacity * sizeof(DRAW_COMMAND), NULL, GL_STREAM_DRAW);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	// the plane is as simple as it gets, while the curved meshes
+	// have a coarser level for each step down in size
+	BuildPlane(vertices, indices);
+	AddMesh(m_meshes[SceneFile::MESH_PLANE][0], vertices, indices, sharedVertices, sharedIndices);
+	m_levelCounts[SceneFile::MESH_PLANE] = 1;
+	for (int level = 0; level < MAX_DETAIL_LEVELS; level++)
+	{
+		BuildCylinder(g_CylinderSides[level], vertices, indices);
+		AddMesh(m_meshes[SceneFile::MESH_CYLINDER][level], vertices, indices, sharedVertices, sharedIndices);
+		BuildTorus(g_TorusMainSegments[level], g_TorusTubeSegments[level], vertices, indices);
+		AddMesh(m_meshes[SceneFile::MESH_TORUS][level], vertices, indices, sharedVertices, sharedIndices);
+	}
+	m_levelCounts[SceneFile::MESH_CYLINDER] = MAX_DETAIL_LEVELS;
+	m_levelCounts[SceneFile::MESH_TORUS] = MAX_DETAIL_LEVELS;
+
+	CreateBuffers(sharedVertices, sharedIndices);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the shared buffers, the
+ *  vertex array and the instance buffer.
+ ***********************************************************/
+void SceneMeshes::Destroy()
+{
+	for (int i = 0; i < SceneFile::MESH_TYPE_COUNT; i++)
+	{
+		for (int level = 0; level < MAX_DETAIL_LEVELS; level++)
+		{
+			m_meshes[i][level].range.baseVertex = 0;
+			m_meshes[i][level].range.firstIndex = 0;
+			m_meshes[i][level].range.indexCount = 0;
+		}
+		m_levelCounts[i] = 1;
+	}
+
+	if (0 != m_vao)
+	{
+		glDeleteVertexArrays(1, &m_vao);
+		glDeleteBuffers(1, &m_vertexBuffer);
+		glDeleteBuffers(1, &m_indexBuffer);
+		m_vao = 0;
+		m_vertexBuffer = 0;
+		m_indexBuffer = 0;
+	}
+
+	if (0 != m_instanceBuffer)
+	{
+		glDeleteBuffers(1, &m_instanceBuffer);
+		m_instanceBuffer = 0;
+	}
+	m_instanceCapacity = 0;
+
+	if (0 != m_commandBuffer)
+	{
+		glDeleteBuffers(1, &m_commandBuffer);
+		m_commandBuffer = 0;
+	}
+	m_commandCapacity = 0;
+	m_bIndirectSupported = false;
+	m_bDrawIndexSupported = false;
+}
+
+/***********************************************************
+ *  AddMesh()
+ *
+ *  This method is used for adding the vertices and indices
+ *  of a mesh to the end of the shared ones.  The indices are
+ *  kept relative to the mesh's first vertex, which the draws
+ *  pass as the base vertex.
+ ***********************************************************/
+void SceneMeshes::AddMesh(
+	MESH& mesh,
+	const std::vector<VERTEX>& vertices,
+	const std::vector<GLuint>& indices,
+	std::vector<VERTEX>& sharedVertices,
+	std::vector<GLuint>& sharedIndices)
+{
+	mesh.range.baseVertex = (GLint)sharedVertices.size();
+	mesh.range.firstIndex = (GLuint)sharedIndices.size();
+	mesh.range.indexCount = (GLsizei)indices.size();
+	mesh.bounds = ComputeBounds(vertices);
+
+	sharedVertices.insert(sharedVertices.end(), vertices.begin(), vertices.end());
+	sharedIndices.insert(sharedIndices.end(), indices.begin(), indices.end());
+}
+
+/***********************************************************
+ *  CreateBuffers()
+ *
+ *  This method is used for loading the shared vertices and
+ *  indices into buffers, and creating the one vertex array
+ *  every mesh is drawn from.  The vertex array reads the
+ *  vertex position, normal and texture coordinate from the
+ *  vertex buffer, and advances through the instance buffer
+ *  once per instance.
+ ***********************************************************/
+void SceneMeshes::CreateBuffers(
+	const std::vector<VERTEX>& sharedVertices,
+	const std::vector<GLuint>& sharedIndices)
+{
+	glGenVertexArrays(1, &m_vao);
+	glBindVertexArray(m_vao);
+
+	glGenBuffers(1, &m_vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sharedVertices.size() * sizeof(VERTEX), sharedVertices.data(), GL_STATIC_DRAW);
+
+	glGenBuffers(1, &m_indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sharedIndices.size() * sizeof(GLuint), sharedIndices.data(), GL_STATIC_DRAW);
+
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VERTEX), (void*)offsetof(VERTEX, position));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(VERTEX), (void*)offsetof(VERTEX, normal));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(VERTEX), (void*)offsetof(VERTEX, textureCoordinate));
+
+	// the model matrix takes one attribute location per column
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	for (GLuint column = 0; column < 4; column++)
+	{
+		GLuint location = INSTANCE_MODEL_LOCATION + column;
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(INSTANCE_DATA),
+			(void*)(offsetof(INSTANCE_DATA, model) + column * sizeof(glm::vec4)));
+		glVertexAttribDivisor(location, 1);
+	}
+	glEnableVertexAttribArray(INSTANCE_COLOR_LOCATION);
+	glVertexAttribPointer(INSTANCE_COLOR_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof(INSTANCE_DATA),
+		(void*)offsetof(INSTANCE_DATA, color));
+	glVertexAttribDivisor(INSTANCE_COLOR_LOCATION, 1);
+	glEnableVertexAttribArray(INSTANCE_TEXTURE_LOCATION);
+	glVertexAttribIPointer(INSTANCE_TEXTURE_LOCATION, 1, GL_INT, sizeof(INSTANCE_DATA),
+		(void*)offsetof(INSTANCE_DATA, textureIndex));
+	glVertexAttribDivisor(INSTANCE_TEXTURE_LOCATION, 1);
+	glEnableVertexAttribArray(INSTANCE_MATERIAL_LOCATION);
+	glVertexAttribIPointer(INSTANCE_MATERIAL_LOCATION, 1, GL_INT, sizeof(INSTANCE_DATA),
+		(void*)offsetof(INSTANCE_DATA, materialIndex));
+	glVertexAttribDivisor(INSTANCE_MATERIAL_LOCATION, 1);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  ComputeBounds()
+ *
+ *  This method is used for getting the smallest axis aligned
+ *  box around a set of vertices, and a sphere around them
+ *  that is centered on the box.
+ ***********************************************************/
+SceneMeshes::MESH_BOUNDS SceneMeshes::ComputeBounds(const std::vector<VERTEX>& vertices)
+{
+	MESH_BOUNDS bounds;
+	bounds.boxMinimum = glm::vec3(0.0f);
+	bounds.boxMaximum = glm::vec3(0.0f);
+	bounds.sphereCenter = glm::vec3(0.0f);
+	bounds.sphereRadius = 0.0f;
+
+	if (vertices.empty())
+	{
+		return(bounds);
+	}
+
+	bounds.boxMinimum = vertices[0].position;
+	bounds.boxMaximum = vertices[0].position;
+	for (size_t i = 1; i < vertices.size(); i++)
+	{
+		const glm::vec3& position = vertices[i].position;
+		bounds.boxMinimum = glm::vec3(
+			std::min(bounds.boxMinimum.x, position.x),
+			std::min(bounds.boxMinimum.y, position.y),
+			std::min(bounds.boxMinimum.z, position.z));
+		bounds.boxMaximum = glm::vec3(
+			std::max(bounds.boxMaximum.x, position.x),
+			std::max(bounds.boxMaximum.y, position.y),
+			std::max(bounds.boxMaximum.z, position.z));
+	}
+
+	bounds.sphereCenter = (bounds.boxMinimum + bounds.boxMaximum) * 0.5f;
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		bounds.sphereRadius = std::max(bounds.sphereRadius, glm::length(vertices[i].position - bounds.sphereCenter));
+	}
+
+	return(bounds);
+}
+
+/***********************************************************
+ *  BindVertexArray()
+ *
+ *  This method is used for binding the vertex array that all
+ *  of the meshes are drawn from.  It only has to be bound
+ *  once before the draws of a frame, since every mesh uses
+ *  the same one.
+ ***********************************************************/
+void SceneMeshes::BindVertexArray() const
+{
+	glBindVertexArray(m_vao);
+	RenderStats::Add(RenderStats::STATE_CHANGES);
+}
+
+/***********************************************************
+ *  UploadInstances()
+ *
+ *  This method is used for uploading the instance data of a
+ *  frame.  The buffer is orphaned before it is written, so
+ *  the upload never waits on draws of the previous frame, and
+ *  it is doubled in size whenever it runs out of room.
+ ***********************************************************/
+void SceneMeshes::UploadInstances(const std::vector<INSTANCE_DATA>& instances)
+{
+	if (0 == m_instanceBuffer)
+	{
+		return;
+	}
+
+	while (m_instanceCapacity < instances.size())
+	{
+		m_instanceCapacity *= 2;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(INSTANCE_DATA), NULL, GL_STREAM_DRAW);
+	if (!instances.empty())
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(INSTANCE_DATA), instances.data());
+		RenderStats::Add(RenderStats::BUFFER_UPLOADS);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  DrawMeshInstanced()
+ *
+ *  This method is used for drawing a range of the uploaded
+ *  instances with one level of a mesh, in a single draw
+ *  call.  The vertex array has to be bound with
+ *  BindVertexArray() first.
+ ***********************************************************/
+void SceneMeshes::DrawMeshInstanced(
+	SceneFile::MESH_TYPE mesh,
+	int level,
+	GLuint firstInstance,
+	GLsizei instanceCount) const
+{
+	if ((mesh < 0) || (mesh >= SceneFile::MESH_TYPE_COUNT) || (level < 0) || (level >= m_levelCounts[mesh]) ||
+		(0 == m_meshes[mesh][level].range.indexCount) || (instanceCount <= 0))
+	{
+		return;
+	}
+
+	const MESH_RANGE& range = m_meshes[mesh][level].range;
+	glDrawElementsInstancedBaseVertexBaseInstance(
+		GL_TRIANGLES,
+		range.indexCount,
+		GL_UNSIGNED_INT,
+		(void*)(range.firstIndex * sizeof(GLuint)),
+		instanceCount,
+		range.baseVertex,
+		firstInstance);
+	RenderStats::Add(RenderStats::DRAW_CALLS);
+	RenderStats::Add(RenderStats::TRIANGLES, (uint64_t)(range.indexCount / 3) * instanceCount);
+}
+
+/***********************************************************
+ *  DrawIndirect()
+ *
+ *  This method is used for drawing a list of draws with one
+ *  multi-draw indirect call.  The commands are uploaded into
+ *  the command buffer the same way the instance data is, and
+ *  the instance buffer is bound for storage as well, so that
+ *  the shaders can read the instance data by the index of
+ *  each draw.  When they cannot, each command's base instance
+ *  selects the instance attributes instead.  The vertex array
+ *  has to be bound with BindVertexArray() first.
+ ***********************************************************/
+void SceneMeshes::DrawIndirect(const std::vector<DRAW_COMMAND>& commands)
+{
+	if ((0 == m_commandBuffer) || commands.empty())
+	{
+		return;
+	}
+
+	while (m_commandCapacity < commands.size())
+	{
+		m_commandCapacity *= 2;
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, m_commandCapacity * sizeof(DRAW_COMMAND), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(DRAW_COMMAND), commands.data());
+	RenderStats::Add(RenderStats::BUFFER_UPLOADS);
+	RenderStats::Add(RenderStats::STATE_CHANGES);
+
+	if (m_bDrawIndexSupported)
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, m_instanceBuffer);
+		RenderStats::Add(RenderStats::STATE_CHANGES);
+	}
+
+	glMultiDrawElementsIndirect(
+		GL_TRIANGLES,
+		GL_UNSIGNED_INT,
+		NULL,
+		(GLsizei)commands.size(),
+		sizeof(DRAW_COMMAND));
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	RenderStats::Add(RenderStats::DRAW_CALLS);
+	for (size_t i = 0; i < commands.size(); i++)
+	{
+		RenderStats::Add(RenderStats::TRIANGLES, (uint64_t)(commands[i].indexCount / 3) * commands[i].instanceCount);
+	}
+}
+
+/***********************************************************
+ *  BuildPlane()
+ *
+ *  This method is used for building a plane from -1 to 1 in
+ *  X and Z, facing up.
+ ***********************************************************/
+void SceneMeshes::BuildPlane(std::vector<VERTEX>& vertices, std::vector<GLuint>& indices)
+{
+	const glm::vec3 up(0.0f, 1.0f, 0.0f);
+
+	vertices.clear();
+	indices.clear();
+
+	vertices.push_back({ glm::vec3(-1.0f, 0.0f, -1.0f), up, glm::vec2(0.0f, 1.0f) });
+	vertices.push_back({ glm::vec3(1.0f, 0.0f, -1.0f), up, glm::vec2(1.0f, 1.0f) });
+	vertices.push_back({ glm::vec3(1.0f, 0.0f, 1.0f), up, glm::vec2(1.0f, 0.0f) });
+	vertices.push_back({ glm::vec3(-1.0f, 0.0f, 1.0f), up, glm::vec2(0.0f, 0.0f) });
+
+	indices = { 0, 1, 3, 1, 2, 3 };
+}
+
+/***********************************************************
+ *  BuildCylinder()
+ *
+ *  This method is used for building a cylinder of radius 1
+ *  from 0 to 1 in Y, with its top and bottom closed, and the
+ *  passed in number of sides.
+ ***********************************************************/
+void SceneMeshes::BuildCylinder(int sides, std::vector<VERTEX>& vertices, std::vector<GLuint>& indices)
+{
+	vertices.clear();
+	indices.clear();
+
+	// the side, with the seam vertices repeated for the texture
+	for (int i = 0; i <= sides; i++)
+	{
+		float angle = 2.0f * g_Pi * (float)i / (float)sides;
+		glm::vec3 normal(std::cos(angle), 0.0f, std::sin(angle));
+		float u = (float)i / (float)sides;
+
+		vertices.push_back({ glm::vec3(normal.x, 0.0f, normal.z), normal, glm::vec2(u, 0.0f) });
+		vertices.push_back({ glm::vec3(normal.x, 1.0f, normal.z), normal, glm::vec2(u, 1.0f) });
+	}
+	for (GLuint i = 0; i < (GLuint)sides; i++)
+	{
+		GLuint bottom = i * 2;
+		indices.insert(indices.end(), { bottom, bottom + 1, bottom + 2, bottom + 1, bottom + 3, bottom + 2 });
+	}
+
+	// the bottom and top caps, each a fan around its center
+	for (int cap = 0; cap < 2; cap++)
+	{
+		float y = (float)cap;
+		glm::vec3 normal(0.0f, (cap == 0) ? -1.0f : 1.0f, 0.0f);
+		GLuint center = (GLuint)vertices.size();
+
+		vertices.push_back({ glm::vec3(0.0f, y, 0.0f), normal, glm::vec2(0.5f, 0.5f) });
+		for (int i = 0; i <= sides; i++)
+		{
+			float angle = 2.0f * g_Pi * (float)i / (float)sides;
+			float x = std::cos(angle);
+			float z = std::sin(angle);
+			vertices.push_back({ glm::vec3(x, y, z), normal, glm::vec2(0.5f + 0.5f * x, 0.5f + 0.5f * z) });
+		}
+		for (GLuint i = 0; i < (GLuint)sides; i++)
+		{
+			indices.insert(indices.end(), { center, center + 1 + i, center + 2 + i });
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildTorus()
+ *
+ *  This method is used for building a torus whose ring lies
+ *  in the XY plane around the origin, with the passed in
+ *  number of segments around the ring and around the tube.
+ ***********************************************************/
+void SceneMeshes::BuildTorus(int mainSegments, int tubeSegments, std::vector<VERTEX>& vertices, std::vector<GLuint>& indices)
+{
+	vertices.clear();
+	indices.clear();
+
+	for (int i = 0; i <= mainSegments; i++)
+	{
+		float mainAngle = 2.0f * g_Pi * (float)i / (float)mainSegments;
+		glm::vec3 ringDirection(std::cos(mainAngle), std::sin(mainAngle), 0.0f);
+
+		for (int j = 0; j <= tubeSegments; j++)
+		{
+			float tubeAngle = 2.0f * g_Pi * (float)j / (float)tubeSegments;
+			glm::vec3 normal = ringDirection * std::cos(tubeAngle) + glm::vec3(0.0f, 0.0f, std::sin(tubeAngle));
+			glm::vec3 position = ringDirection * g_TorusMainRadius + normal * g_TorusTubeRadius;
+
+			vertices.push_back({ position, normal,
+				glm::vec2((float)i / (float)mainSegments, (float)j / (float)tubeSegments) });
+		}
+	}
+
+	GLuint ringVertices = (GLuint)tubeSegments + 1;
+	for (GLuint i = 0; i < (GLuint)mainSegments; i++)
+	{
+		for (GLuint j = 0; j < (GLuint)tubeSegments; j++)
+		{
+			GLuint current = i * ringVertices + j;
+			GLuint next = current + ringVertices;
+			indices.insert(indices.end(), { current, next, current + 1, next, next + 1, current + 1 });
+		}
+	}
+}
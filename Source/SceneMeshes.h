@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenemeshes.h
+// ============
+// build the basic scene meshes and draw many instances of them at once
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneFile.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  SceneMeshes
+ *
+ *  This class builds the plane, cylinder and torus meshes the
+ *  scene is made of, with the same sizes and orientations as
+ *  the ShapeMeshes primitives.  All of the meshes share one
+ *  vertex buffer and one index buffer behind a single vertex
+ *  array, and each mesh is a range of them that is drawn with
+ *  a base vertex and first index, so moving from one mesh to
+ *  the next never switches vertex arrays.  It draws every
+ *  instance of a mesh with a single instanced draw call, or
+ *  a whole list of draws with one multi-draw indirect call.
+ *  The instance data of a frame is uploaded into one
+ *  instance buffer, and each draw reads its own range of it.
+ *  The curved meshes are built at several levels of detail,
+ *  from the finest at level 0 to coarser ones for objects
+ *  that are small on the screen.  Each mesh also has a
+ *  bounding sphere and box, which are used for culling.
+ ***********************************************************/
+class SceneMeshes
+{
+public:
+	// constructor
+	SceneMeshes();
+	// destructor
+	~SceneMeshes();
+
+	// per-instance values read by the vertex shader
+	struct INSTANCE_DATA
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		// packed texture array and layer, or -1 for no texture
+		GLint textureIndex;
+		GLint materialIndex;
+		GLint padding[2];
+	};
+
+	// bounding volumes of a mesh, in the mesh's own space
+	struct MESH_BOUNDS
+	{
+		glm::vec3 sphereCenter;
+		float sphereRadius;
+		glm::vec3 boxMinimum;
+		glm::vec3 boxMaximum;
+	};
+
+	// one draw of a multi-draw indirect call, in the layout that
+	// glMultiDrawElementsIndirect reads
+	struct DRAW_COMMAND
+	{
+		GLuint indexCount;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// range of the shared buffers that holds the geometry of a mesh
+	struct MESH_RANGE
+	{
+		GLint baseVertex;
+		GLuint firstIndex;
+		GLsizei indexCount;
+	};
+
+	// vertex attribute locations of the instance data
+	static const GLuint INSTANCE_MODEL_LOCATION = 3;
+	static const GLuint INSTANCE_COLOR_LOCATION = 7;
+	static const GLuint INSTANCE_TEXTURE_LOCATION = 8;
+	static const GLuint INSTANCE_MATERIAL_LOCATION = 9;
+	// most levels of detail a mesh can have
+	static const int MAX_DETAIL_LEVELS = 3;
+
+	// shader storage binding point the instance data is read from
+	// by the index of each draw of a multi-draw
+	static const GLuint DRAW_DATA_BINDING = 2;
+
+	// build all of the meshes
+	bool LoadMeshes();
+	// free all of the meshes and the instance buffer
+	void Destroy();
+
+	// get the bounding volumes of a mesh, which enclose every level
+	const MESH_BOUNDS& GetMeshBounds(SceneFile::MESH_TYPE mesh) const { return m_meshes[mesh][0].bounds; }
+	// get the range of the shared buffers that a level of a mesh is drawn from
+	const MESH_RANGE& GetMeshRange(SceneFile::MESH_TYPE mesh, int level = 0) const { return m_meshes[mesh][level].range; }
+	// get the number of levels of detail of a mesh
+	int GetLevelCount(SceneFile::MESH_TYPE mesh) const { return m_levelCounts[mesh]; }
+
+	// bind the vertex array that every mesh is drawn from, once
+	// before the draws of a frame
+	void BindVertexArray() const;
+	// upload the instance data of a frame
+	void UploadInstances(const std::vector<INSTANCE_DATA>& instances);
+	// draw a range of the uploaded instances with one level of a mesh
+	void DrawMeshInstanced(
+		SceneFile::MESH_TYPE mesh,
+		int level,
+		GLuint firstInstance,
+		GLsizei instanceCount) const;
+	// draw a list of draws of the uploaded instances with one call
+	void DrawIndirect(const std::vector<DRAW_COMMAND>& commands);
+
+	// check whether multi-draw indirect calls can be made
+	bool IsIndirectSupported() const { return m_bIndirectSupported; }
+	// check whether the shaders can read the index of each draw of
+	// a multi-draw, so the instance data is read from storage
+	bool HasDrawIndex() const { return m_bDrawIndexSupported; }
+
+private:
+	struct VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 textureCoordinate;
+	};
+
+	struct MESH
+	{
+		MESH_RANGE range;
+		MESH_BOUNDS bounds;
+	};
+
+	// the meshes, indexed by mesh type and level of detail
+	MESH m_meshes[SceneFile::MESH_TYPE_COUNT][MAX_DETAIL_LEVELS];
+	// number of levels of detail of each mesh type
+	int m_levelCounts[SceneFile::MESH_TYPE_COUNT];
+	// vertex array and buffers shared by all of the meshes
+	GLuint m_vao;
+	GLuint m_vertexBuffer;
+	GLuint m_indexBuffer;
+	// buffer holding the instance data of the frame
+	GLuint m_instanceBuffer;
+	// number of instances the instance buffer has room for
+	size_t m_instanceCapacity;
+	// buffer holding the multi-draw commands of the frame
+	GLuint m_commandBuffer;
+	// number of commands the command buffer has room for
+	size_t m_commandCapacity;
+	// true when multi-draw indirect calls are supported
+	bool m_bIndirectSupported;
+	// true when the shaders can read the index of each draw
+	bool m_bDrawIndexSupported;
+
+	// add the geometry of a mesh to the end of the shared vertices
+	// and indices, and remember where it starts
+	static void AddMesh(
+		MESH& mesh,
+		const std::vector<VERTEX>& vertices,
+		const std::vector<GLuint>& indices,
+		std::vector<VERTEX>& sharedVertices,
+		std::vector<GLuint>& sharedIndices);
+	// create the shared buffers and the vertex array
+	void CreateBuffers(
+		const std::vector<VERTEX>& sharedVertices,
+		const std::vector<GLuint>& sharedIndices);
+
+	// get the bounding volumes that enclose a set of vertices
+	static MESH_BOUNDS ComputeBounds(const std::vector<VERTEX>& vertices);
+
+	// build the vertices and indices of each mesh
+	static void BuildPlane(std::vector<VERTEX>& vertices, std::vector<GLuint>& indices);
+	static void BuildCylinder(int sides, std::vector<VERTEX>& vertices, std::vector<GLuint>& indices);
+	static void BuildTorus(int mainSegments, int tubeSegments, std::vector<VERTEX>& vertices, std::vector<GLuint>& indices);
+};
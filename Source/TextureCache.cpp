@@ -0,0 +1,615 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.cpp
+// ============
+// store decoded texture images, with all their mipmap levels, on disk
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+// declaration of the global variables and defines
+namespace
+{
+	// identifies the cache files and the layout they were written with
+	const char g_CacheFileMagic[4] = { 'T', 'X', 'C', '1' };
+	const uint32_t g_CacheFileVersion = 1;
+
+	// largest image dimension accepted from a cache file
+	const uint32_t g_MaxCachedDimension = 16384;
+
+	/***********************************************************
+	 *  PackColor565()
+	 *
+	 *  Pack an 8 bit per channel color into 5:6:5 bits.
+	 ***********************************************************/
+	uint16_t PackColor565(const int color[3])
+	{
+		int r = (color[0] * 31 + 127) / 255;
+		int g = (color[1] * 63 + 127) / 255;
+		int b = (color[2] * 31 + 127) / 255;
+		return((uint16_t)((r << 11) | (g << 5) | b));
+	}
+
+	/***********************************************************
+	 *  UnpackColor565()
+	 *
+	 *  Expand a 5:6:5 bit color back to 8 bits per channel.
+	 ***********************************************************/
+	void UnpackColor565(uint16_t packed, int color[3])
+	{
+		int r = (packed >> 11) & 0x1F;
+		int g = (packed >> 5) & 0x3F;
+		int b = packed & 0x1F;
+		color[0] = (r << 3) | (r >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (b << 3) | (b >> 2);
+	}
+
+	/***********************************************************
+	 *  EncodeColorBlock()
+	 *
+	 *  Encode the 16 texels of a 4x4 block as a BC1 color block,
+	 *  using the inset bounding box of the block colors as the
+	 *  two endpoints.  The block is always written in the four
+	 *  color mode so it can also be used inside a BC3 block.
+	 ***********************************************************/
+	void EncodeColorBlock(const unsigned char texels[16][4], unsigned char* block)
+	{
+		int minColor[3] = { 255, 255, 255 };
+		int maxColor[3] = { 0, 0, 0 };
+
+		for (int i = 0; i < 16; i++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				minColor[c] = std::min(minColor[c], (int)texels[i][c]);
+				maxColor[c] = std::max(maxColor[c], (int)texels[i][c]);
+			}
+		}
+
+		// pull the endpoints in slightly to reduce the error of
+		// the interpolated colors
+		for (int c = 0; c < 3; c++)
+		{
+			int inset = (maxColor[c] - minColor[c]) / 16;
+			minColor[c] = std::min(255, minColor[c] + inset);
+			maxColor[c] = std::max(0, maxColor[c] - inset);
+		}
+
+		uint16_t color0 = PackColor565(maxColor);
+		uint16_t color1 = PackColor565(minColor);
+		if (color0 < color1)
+		{
+			std::swap(color0, color1);
+		}
+
+		uint32_t indices = 0;
+		if (color0 != color1)
+		{
+			int palette[4][3];
+			UnpackColor565(color0, palette[0]);
+			UnpackColor565(color1, palette[1]);
+			for (int c = 0; c < 3; c++)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			for (int i = 0; i < 16; i++)
+			{
+				int bestIndex = 0;
+				int bestError = INT32_MAX;
+				for (int p = 0; p < 4; p++)
+				{
+					int error = 0;
+					for (int c = 0; c < 3; c++)
+					{
+						int delta = (int)texels[i][c] - palette[p][c];
+						error += delta * delta;
+					}
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = p;
+					}
+				}
+				indices |= (uint32_t)bestIndex << (2 * i);
+			}
+		}
+
+		block[0] = (unsigned char)(color0 & 0xFF);
+		block[1] = (unsigned char)(color0 >> 8);
+		block[2] = (unsigned char)(color1 & 0xFF);
+		block[3] = (unsigned char)(color1 >> 8);
+		for (int i = 0; i < 4; i++)
+		{
+			block[4 + i] = (unsigned char)((indices >> (8 * i)) & 0xFF);
+		}
+	}
+
+	/***********************************************************
+	 *  EncodeAlphaBlock()
+	 *
+	 *  Encode the alpha values of the 16 texels of a 4x4 block
+	 *  as a BC3 alpha block with eight interpolated values.
+	 ***********************************************************/
+	void EncodeAlphaBlock(const unsigned char texels[16][4], unsigned char* block)
+	{
+		int alpha0 = 0;
+		int alpha1 = 255;
+
+		for (int i = 0; i < 16; i++)
+		{
+			alpha0 = std::max(alpha0, (int)texels[i][3]);
+			alpha1 = std::min(alpha1, (int)texels[i][3]);
+		}
+
+		uint64_t indices = 0;
+		if (alpha0 != alpha1)
+		{
+			int palette[8];
+			palette[0] = alpha0;
+			palette[1] = alpha1;
+			for (int p = 1; p < 7; p++)
+			{
+				palette[p + 1] = ((7 - p) * alpha0 + p * alpha1) / 7;
+			}
+
+			for (int i = 0; i < 16; i++)
+			{
+				int bestIndex = 0;
+				int bestError = INT32_MAX;
+				for (int p = 0; p < 8; p++)
+				{
+					int error = std::abs((int)texels[i][3] - palette[p]);
+					if (error < bestError)
+					{
+						bestError = error;
+						bestIndex = p;
+					}
+				}
+				indices |= (uint64_t)bestIndex << (3 * i);
+			}
+		}
+
+		block[0] = (unsigned char)alpha0;
+		block[1] = (unsigned char)alpha1;
+		for (int i = 0; i < 6; i++)
+		{
+			block[2 + i] = (unsigned char)((indices >> (8 * i)) & 0xFF);
+		}
+	}
+
+	/***********************************************************
+	 *  WriteValue() / ReadValue()
+	 *
+	 *  Write or read one fixed size value in a cache file.
+	 ***********************************************************/
+	template <typename T>
+	void WriteValue(std::ofstream& file, T value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	template <typename T>
+	bool ReadValue(std::ifstream& file, T& value)
+	{
+		file.read(reinterpret_cast<char*>(&value), sizeof(T));
+		return(file.good());
+	}
+}
+
+/***********************************************************
+ *  TextureCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureCache::TextureCache()
+{
+	m_cacheDirectory = "TextureCache";
+	m_bEnabled = true;
+	m_bCompress = false;
+}
+
+/***********************************************************
+ *  HashBytes()
+ *
+ *  This method is used for calculating the 64 bit FNV-1a
+ *  hash of a block of memory.  A previous hash value can be
+ *  passed in to continue hashing across several blocks.
+ ***********************************************************/
+uint64_t TextureCache::HashBytes(const unsigned char* data, size_t size, uint64_t hash)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+
+	return(hash);
+}
+
+/***********************************************************
+ *  GetLevelSize()
+ *
+ *  This method is used for getting the number of bytes in
+ *  one mipmap level of a texture format.  Block compressed
+ *  levels are stored as whole 4x4 blocks.
+ ***********************************************************/
+size_t TextureCache::GetLevelSize(TEXTURE_FORMAT format, int width, int height)
+{
+	size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+
+	switch (format)
+	{
+	case FORMAT_BC1:
+		return(blocks * 8);
+	case FORMAT_BC3:
+		return(blocks * 16);
+	case FORMAT_RGBA8:
+		return((size_t)width * height * 4);
+	case FORMAT_RGB8:
+	default:
+		return((size_t)width * height * 3);
+	}
+}
+
+/***********************************************************
+ *  GetCacheFilePath()
+ *
+ *  This method is used for getting the path of the cache
+ *  file for a source image.  The file name comes from a hash
+ *  of the source path, and compressed and uncompressed copies
+ *  of the same image are kept in separate files.
+ ***********************************************************/
+std::string TextureCache::GetCacheFilePath(const std::string& sourcePath) const
+{
+	char fileName[64];
+	uint64_t pathHash = HashBytes(
+		reinterpret_cast<const unsigned char*>(sourcePath.data()),
+		sourcePath.size());
+
+	snprintf(fileName, sizeof(fileName), "%016llx%s",
+		(unsigned long long)pathHash,
+		m_bCompress ? ".bc.texc" : ".texc");
+
+	return(m_cacheDirectory + "/" + fileName);
+}
+
+/***********************************************************
+ *  LoadCachedTexture()
+ *
+ *  This method is used for reading the cache file of a
+ *  source image.  False is returned if there is no cache file
+ *  or if it is stale - it was written for another source path,
+ *  from different source file contents, in a different format
+ *  or by an older version of this code.  It is also returned
+ *  if the mipmap levels are not a halving chain or a level
+ *  does not hold exactly the bytes of its size, so that a
+ *  truncated or corrupt file is rebuilt from the source image
+ *  instead of being uploaded.
+ ***********************************************************/
+bool TextureCache::LoadCachedTexture(
+	const std::string& sourcePath,
+	uint64_t contentHash,
+	TEXTURE_DATA& texture) const
+{
+	std::ifstream file(GetCacheFilePath(sourcePath), std::ios::binary);
+	char magic[4];
+	uint32_t version = 0;
+	uint64_t cachedHash = 0;
+	uint32_t format = 0;
+	uint32_t colorChannels = 0;
+	uint32_t levelCount = 0;
+	uint32_t pathLength = 0;
+
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	file.read(magic, sizeof(magic));
+	if (!file.good() || (memcmp(magic, g_CacheFileMagic, sizeof(magic)) != 0))
+	{
+		return(false);
+	}
+	if (!ReadValue(file, version) || (version != g_CacheFileVersion) ||
+		!ReadValue(file, cachedHash) || (cachedHash != contentHash) ||
+		!ReadValue(file, format) ||
+		!ReadValue(file, colorChannels) ||
+		!ReadValue(file, levelCount) ||
+		!ReadValue(file, pathLength) || (pathLength != sourcePath.size()))
+	{
+		return(false);
+	}
+
+	// the cache file must hold the format that is currently wanted
+	bool bCompressedFile = (format == FORMAT_BC1) || (format == FORMAT_BC3);
+	if ((bCompressedFile != m_bCompress) || (format > FORMAT_BC3) || (levelCount == 0) || (levelCount > 32))
+	{
+		return(false);
+	}
+
+	std::string cachedPath(pathLength, '\0');
+	file.read(&cachedPath[0], pathLength);
+	if (!file.good() || (cachedPath != sourcePath))
+	{
+		return(false);
+	}
+
+	// and as many color channels as that format stores
+	bool bAlphaFormat = (format == FORMAT_RGBA8) || (format == FORMAT_BC3);
+	if (colorChannels != (bAlphaFormat ? 4u : 3u))
+	{
+		return(false);
+	}
+
+	texture.format = (TEXTURE_FORMAT)format;
+	texture.colorChannels = (int)colorChannels;
+	texture.mipLevels.resize(levelCount);
+	for (uint32_t i = 0; i < levelCount; i++)
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		uint32_t size = 0;
+
+		if (!ReadValue(file, width) || !ReadValue(file, height) || !ReadValue(file, size) ||
+			(width == 0) || (height == 0) ||
+			(width > g_MaxCachedDimension) || (height > g_MaxCachedDimension))
+		{
+			texture.mipLevels.clear();
+			return(false);
+		}
+
+		// each level must be half the size of the one before, and
+		// hold exactly the bytes of its size, since OpenGL reads
+		// that many from it
+		if (((i > 0) &&
+			((width != (uint32_t)std::max(1, texture.mipLevels[i - 1].width / 2)) ||
+			(height != (uint32_t)std::max(1, texture.mipLevels[i - 1].height / 2)))) ||
+			(size != GetLevelSize(texture.format, (int)width, (int)height)))
+		{
+			texture.mipLevels.clear();
+			return(false);
+		}
+
+		texture.mipLevels[i].width = (int)width;
+		texture.mipLevels[i].height = (int)height;
+		texture.mipLevels[i].data.resize(size);
+		file.read(reinterpret_cast<char*>(texture.mipLevels[i].data.data()), size);
+		if (!file.good())
+		{
+			texture.mipLevels.clear();
+			return(false);
+		}
+	}
+
+	// the chain goes down to a 1x1 level, as BuildTexture() makes it
+	if ((texture.mipLevels.back().width != 1) || (texture.mipLevels.back().height != 1))
+	{
+		texture.mipLevels.clear();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  SaveCachedTexture()
+ *
+ *  This method is used for writing the cache file of a
+ *  source image.  The file is written under a temporary name
+ *  first and then renamed, so a partly written cache file is
+ *  never read back.
+ ***********************************************************/
+bool TextureCache::SaveCachedTexture(
+	const std::string& sourcePath,
+	uint64_t contentHash,
+	const TEXTURE_DATA& texture) const
+{
+	std::error_code error;
+	std::string cachePath = GetCacheFilePath(sourcePath);
+	std::string tempPath = cachePath + ".tmp";
+
+	std::filesystem::create_directories(m_cacheDirectory, error);
+
+	{
+		std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			std::cout << "Could not write texture cache file:" << tempPath << std::endl;
+			return(false);
+		}
+
+		file.write(g_CacheFileMagic, sizeof(g_CacheFileMagic));
+		WriteValue(file, g_CacheFileVersion);
+		WriteValue(file, contentHash);
+		WriteValue(file, (uint32_t)texture.format);
+		WriteValue(file, (uint32_t)texture.colorChannels);
+		WriteValue(file, (uint32_t)texture.mipLevels.size());
+		WriteValue(file, (uint32_t)sourcePath.size());
+		file.write(sourcePath.data(), sourcePath.size());
+
+		for (size_t i = 0; i < texture.mipLevels.size(); i++)
+		{
+			const MIP_LEVEL& level = texture.mipLevels[i];
+			WriteValue(file, (uint32_t)level.width);
+			WriteValue(file, (uint32_t)level.height);
+			WriteValue(file, (uint32_t)level.data.size());
+			file.write(reinterpret_cast<const char*>(level.data.data()), level.data.size());
+		}
+
+		if (!file.good())
+		{
+			file.close();
+			std::filesystem::remove(tempPath, error);
+			return(false);
+		}
+	}
+
+	std::filesystem::rename(tempPath, cachePath, error);
+	if (error)
+	{
+		std::filesystem::remove(tempPath, error);
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetTextureFormat()
+ *
+ *  This method is used for getting the format that textures
+ *  with the passed in number of color channels are built in.
+ ***********************************************************/
+TextureCache::TEXTURE_FORMAT TextureCache::GetTextureFormat(int colorChannels) const
+{
+	if (m_bCompress)
+	{
+		return((colorChannels == 4) ? FORMAT_BC3 : FORMAT_BC1);
+	}
+
+	return((colorChannels == 4) ? FORMAT_RGBA8 : FORMAT_RGB8);
+}
+
+/***********************************************************
+ *  BuildTexture()
+ *
+ *  This method is used for building the full mipmap chain
+ *  of a decoded image, down to a 1x1 level, and block
+ *  compressing every level when compression is turned on.
+ ***********************************************************/
+TextureCache::TEXTURE_DATA TextureCache::BuildTexture(
+	const unsigned char* pixels,
+	int width,
+	int height,
+	int colorChannels) const
+{
+	TEXTURE_DATA texture;
+	MIP_LEVEL level;
+
+	texture.colorChannels = colorChannels;
+	texture.format = (colorChannels == 4) ? FORMAT_RGBA8 : FORMAT_RGB8;
+
+	level.width = width;
+	level.height = height;
+	level.data.assign(pixels, pixels + (size_t)width * height * colorChannels);
+	texture.mipLevels.push_back(level);
+
+	while ((level.width > 1) || (level.height > 1))
+	{
+		MIP_LEVEL nextLevel;
+		DownsampleLevel(level, colorChannels, nextLevel);
+		texture.mipLevels.push_back(nextLevel);
+		level = nextLevel;
+	}
+
+	if (m_bCompress)
+	{
+		texture.format = GetTextureFormat(colorChannels);
+		for (size_t i = 0; i < texture.mipLevels.size(); i++)
+		{
+			MIP_LEVEL compressedLevel;
+			CompressLevel(texture.mipLevels[i], colorChannels, compressedLevel);
+			texture.mipLevels[i] = compressedLevel;
+		}
+	}
+
+	return(texture);
+}
+
+/***********************************************************
+ *  DownsampleLevel()
+ *
+ *  This method is used for generating the next smaller
+ *  mipmap level by averaging each 2x2 group of texels.  The
+ *  last row or column is repeated for odd sized levels.
+ ***********************************************************/
+void TextureCache::DownsampleLevel(const MIP_LEVEL& source, int colorChannels, MIP_LEVEL& destination)
+{
+	destination.width = std::max(1, source.width / 2);
+	destination.height = std::max(1, source.height / 2);
+	destination.data.resize((size_t)destination.width * destination.height * colorChannels);
+
+	for (int y = 0; y < destination.height; y++)
+	{
+		int y0 = std::min(y * 2, source.height - 1);
+		int y1 = std::min(y * 2 + 1, source.height - 1);
+		for (int x = 0; x < destination.width; x++)
+		{
+			int x0 = std::min(x * 2, source.width - 1);
+			int x1 = std::min(x * 2 + 1, source.width - 1);
+			for (int c = 0; c < colorChannels; c++)
+			{
+				int sum =
+					source.data[((size_t)y0 * source.width + x0) * colorChannels + c] +
+					source.data[((size_t)y0 * source.width + x1) * colorChannels + c] +
+					source.data[((size_t)y1 * source.width + x0) * colorChannels + c] +
+					source.data[((size_t)y1 * source.width + x1) * colorChannels + c];
+				destination.data[((size_t)y * destination.width + x) * colorChannels + c] =
+					(unsigned char)((sum + 2) / 4);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  CompressLevel()
+ *
+ *  This method is used for block compressing one mipmap
+ *  level - BC1 for RGB levels and BC3 for RGBA levels.
+ *  Levels smaller than a block repeat their edge texels.
+ ***********************************************************/
+void TextureCache::CompressLevel(const MIP_LEVEL& source, int colorChannels, MIP_LEVEL& destination)
+{
+	int blocksWide = (source.width + 3) / 4;
+	int blocksHigh = (source.height + 3) / 4;
+	int blockSize = (colorChannels == 4) ? 16 : 8;
+
+	destination.width = source.width;
+	destination.height = source.height;
+	destination.data.resize((size_t)blocksWide * blocksHigh * blockSize);
+
+	for (int by = 0; by < blocksHigh; by++)
+	{
+		for (int bx = 0; bx < blocksWide; bx++)
+		{
+			unsigned char texels[16][4];
+			unsigned char* block = &destination.data[((size_t)by * blocksWide + bx) * blockSize];
+
+			for (int ty = 0; ty < 4; ty++)
+			{
+				int y = std::min(by * 4 + ty, source.height - 1);
+				for (int tx = 0; tx < 4; tx++)
+				{
+					int x = std::min(bx * 4 + tx, source.width - 1);
+					const unsigned char* texel = &source.data[((size_t)y * source.width + x) * colorChannels];
+					texels[ty * 4 + tx][0] = texel[0];
+					texels[ty * 4 + tx][1] = texel[1];
+					texels[ty * 4 + tx][2] = texel[2];
+					texels[ty * 4 + tx][3] = (colorChannels == 4) ? texel[3] : 255;
+				}
+			}
+
+			if (colorChannels == 4)
+			{
+				EncodeAlphaBlock(texels, block);
+				EncodeColorBlock(texels, block + 8);
+			}
+			else
+			{
+				EncodeColorBlock(texels, block);
+			}
+		}
+	}
+}
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.h
+// ============
+// store decoded texture images, with all their mipmap levels, on disk
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureCache
+ *
+ *  This class keeps a copy of every decoded texture image in
+ *  a cache directory, together with its full mipmap chain and
+ *  optionally block compressed (BC1 for RGB images and BC3
+ *  for RGBA images).  Each cache file is keyed by the source
+ *  image path and stamped with a hash of the source file
+ *  contents, so a cache file is only used while the image
+ *  file it was built from is unchanged.
+ ***********************************************************/
+class TextureCache
+{
+public:
+	// constructor
+	TextureCache();
+
+	enum TEXTURE_FORMAT
+	{
+		FORMAT_RGB8 = 0,
+		FORMAT_RGBA8,
+		FORMAT_BC1,
+		FORMAT_BC3
+	};
+
+	struct MIP_LEVEL
+	{
+		int width;
+		int height;
+		std::vector<unsigned char> data;
+	};
+
+	struct TEXTURE_DATA
+	{
+		TEXTURE_FORMAT format;
+		int colorChannels;
+		std::vector<MIP_LEVEL> mipLevels;
+	};
+
+	// set the directory that cache files are kept in
+	void SetCacheDirectory(const std::string& directory) { m_cacheDirectory = directory; }
+	// turn the use of the cache on or off
+	void SetEnabled(bool bEnabled) { m_bEnabled = bEnabled; }
+	bool IsEnabled() const { return m_bEnabled; }
+	// turn block compression of cached textures on or off
+	void SetCompression(bool bCompress) { m_bCompress = bCompress; }
+	bool IsCompressionEnabled() const { return m_bCompress; }
+
+	// get the format textures with the passed in channels are built in
+	TEXTURE_FORMAT GetTextureFormat(int colorChannels) const;
+
+	// try to read a fresh cache file for the passed in source image
+	bool LoadCachedTexture(
+		const std::string& sourcePath,
+		uint64_t contentHash,
+		TEXTURE_DATA& texture) const;
+	// write a cache file for the passed in source image
+	bool SaveCachedTexture(
+		const std::string& sourcePath,
+		uint64_t contentHash,
+		const TEXTURE_DATA& texture) const;
+
+	// build a texture with a full mipmap chain from decoded pixels
+	TEXTURE_DATA BuildTexture(
+		const unsigned char* pixels,
+		int width,
+		int height,
+		int colorChannels) const;
+
+	// hash a block of memory with 64 bit FNV-1a
+	static uint64_t HashBytes(const unsigned char* data, size_t size, uint64_t hash = 14695981039346656037ull);
+	// get the byte size of one mipmap level in a format
+	static size_t GetLevelSize(TEXTURE_FORMAT format, int width, int height);
+
+private:
+	// directory that cache files are kept in
+	std::string m_cacheDirectory;
+	// true when the cache is used
+	bool m_bEnabled;
+	// true when cached textures are block compressed
+	bool m_bCompress;
+
+	// get the cache file path for a source image
+	std::string GetCacheFilePath(const std::string& sourcePath) const;
+
+	// generate the next smaller mipmap level with a box filter
+	static void DownsampleLevel(const MIP_LEVEL& source, int colorChannels, MIP_LEVEL& destination);
+	// block compress one mipmap level
+	static void CompressLevel(const MIP_LEVEL& source, int colorChannels, MIP_LEVEL& destination);
+};
@@ -0,0 +1,254 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.cpp
+// ============
+// decode texture image files into memory on a pool of worker threads
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+
+/***********************************************************
+ *  TextureLoader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureLoader::TextureLoader()
+{
+	m_workerCount = 0;
+	m_pTextureCache = NULL;
+}
+
+/***********************************************************
+ *  ~TextureLoader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureLoader::~TextureLoader()
+{
+	FreeImages();
+}
+
+/***********************************************************
+ *  QueueImage()
+ *
+ *  This method is used for adding an image file, and the tag
+ *  that the loaded texture will be registered under, to the
+ *  list of images that will be decoded.
+ ***********************************************************/
+void TextureLoader::QueueImage(const char* filename, const std::string& tag)
+{
+	IMAGE_DATA image;
+
+	image.filename = filename;
+	image.tag = tag;
+	image.width = 0;
+	image.height = 0;
+	image.colorChannels = 0;
+	image.decodeMilliseconds = 0.0;
+	image.bDecoded = false;
+	image.bFromCache = false;
+
+	m_images.push_back(image);
+}
+
+/***********************************************************
+ *  ReadImageInfo()
+ *
+ *  This method is used for reading the width, height and
+ *  number of color channels of every queued image from the
+ *  image file header, without decoding the image.
+ ***********************************************************/
+void TextureLoader::ReadImageInfo()
+{
+	for (size_t i = 0; i < m_images.size(); i++)
+	{
+		if (!stbi_info(
+			m_images[i].filename.c_str(),
+			&m_images[i].width,
+			&m_images[i].height,
+			&m_images[i].colorChannels))
+		{
+			m_images[i].width = 0;
+			m_images[i].height = 0;
+			m_images[i].colorChannels = 0;
+		}
+	}
+}
+
+/***********************************************************
+ *  DecodeImage()
+ *
+ *  This method is used for getting the texture data of the
+ *  passed in image on the calling thread.  The image file is
+ *  read into memory and hashed, and if the texture cache has
+ *  a fresh copy for those file contents the cached mipmap
+ *  chain is used as is.  Otherwise the image is decoded, its
+ *  mipmap chain is built and the cache file is rewritten.
+ ***********************************************************/
+bool TextureLoader::DecodeImage(IMAGE_DATA& image) const
+{
+	TextureCache defaultCache;
+	const TextureCache* pTextureCache = m_pTextureCache;
+	std::vector<unsigned char> fileData;
+	uint64_t contentHash = 0;
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	// without a texture cache, the mipmap chain is still built here
+	if (NULL == pTextureCache)
+	{
+		defaultCache.SetEnabled(false);
+		pTextureCache = &defaultCache;
+	}
+
+	// read the whole image file into memory
+	std::ifstream file(image.filename, std::ios::binary);
+	if (file.is_open())
+	{
+		fileData.assign(
+			std::istreambuf_iterator<char>(file),
+			std::istreambuf_iterator<char>());
+	}
+
+	if (fileData.size() > 0)
+	{
+		contentHash = TextureCache::HashBytes(fileData.data(), fileData.size());
+
+		// try to use the cached copy of the image first
+		if (pTextureCache->IsEnabled() &&
+			pTextureCache->LoadCachedTexture(image.filename, contentHash, image.texture))
+		{
+			image.bFromCache = true;
+			image.bDecoded = true;
+		}
+		else
+		{
+			// try to parse the image data from the image file contents
+			unsigned char* pixels = stbi_load_from_memory(
+				fileData.data(),
+				(int)fileData.size(),
+				&image.width,
+				&image.height,
+				&image.colorChannels,
+				0);
+
+			if ((NULL != pixels) && ((image.colorChannels == 3) || (image.colorChannels == 4)))
+			{
+				image.texture = pTextureCache->BuildTexture(
+					pixels,
+					image.width,
+					image.height,
+					image.colorChannels);
+				image.bDecoded = true;
+
+				if (pTextureCache->IsEnabled())
+				{
+					pTextureCache->SaveCachedTexture(image.filename, contentHash, image.texture);
+				}
+			}
+			else if (NULL != pixels)
+			{
+				std::cout << "Not implemented to handle image with " << image.colorChannels << " channels" << std::endl;
+			}
+
+			if (NULL != pixels)
+			{
+				stbi_image_free(pixels);
+			}
+		}
+	}
+
+	if (image.bDecoded)
+	{
+		image.width = image.texture.mipLevels[0].width;
+		image.height = image.texture.mipLevels[0].height;
+		image.colorChannels = image.texture.colorChannels;
+	}
+
+	auto endTime = std::chrono::steady_clock::now();
+	image.decodeMilliseconds =
+		std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+	return(image.bDecoded);
+}
+
+/***********************************************************
+ *  DecodeQueuedImages()
+ *
+ *  This method is used for decoding all of the queued image
+ *  files at the same time.  Each worker thread keeps taking
+ *  the next image that has not been decoded yet until none
+ *  are left.  When the worker count is zero, one worker per
+ *  hardware thread is used.  The wall clock time of the whole
+ *  decode is returned in milliseconds.
+ ***********************************************************/
+double TextureLoader::DecodeQueuedImages(unsigned int workerCount)
+{
+	std::atomic<size_t> nextImage(0);
+	std::vector<std::thread> workers;
+
+	if (workerCount == 0)
+	{
+		workerCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	m_workerCount = std::min<unsigned int>(workerCount, (unsigned int)m_images.size());
+
+	// indicate to always flip images vertically when loaded - this
+	// is global state in stb_image, so it is set once before any of
+	// the worker threads start reading it
+	stbi_set_flip_vertically_on_load(true);
+
+	auto startTime = std::chrono::steady_clock::now();
+
+	auto decodeWorker = [this, &nextImage]()
+	{
+		size_t index = nextImage++;
+		while (index < m_images.size())
+		{
+			DecodeImage(m_images[index]);
+			index = nextImage++;
+		}
+	};
+
+	// the calling thread also decodes, so one less thread is started
+	for (unsigned int i = 1; i < m_workerCount; i++)
+	{
+		workers.push_back(std::thread(decodeWorker));
+	}
+	decodeWorker();
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+
+	auto endTime = std::chrono::steady_clock::now();
+
+	return(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+}
+
+/***********************************************************
+ *  FreeImages()
+ *
+ *  This method is used for freeing all of the decoded image
+ *  data from local memory.
+ ***********************************************************/
+void TextureLoader::FreeImages()
+{
+	for (size_t i = 0; i < m_images.size(); i++)
+	{
+		m_images[i].texture.mipLevels.clear();
+		m_images[i].texture.mipLevels.shrink_to_fit();
+	}
+}
@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.h
+// ============
+// decode texture image files into memory on a pool of worker threads
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureCache.h"
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureLoader
+ *
+ *  This class collects the texture image files needed by a
+ *  3D scene and decodes all of them concurrently.  Only the
+ *  decoding happens on the worker threads - the decoded
+ *  pixels are handed back so that the OpenGL calls can be
+ *  made from the thread that owns the OpenGL context.
+ ***********************************************************/
+class TextureLoader
+{
+public:
+	// constructor
+	TextureLoader();
+	// destructor
+	~TextureLoader();
+
+	struct IMAGE_DATA
+	{
+		std::string filename;
+		std::string tag;
+		int width;
+		int height;
+		int colorChannels;
+		double decodeMilliseconds;
+		bool bDecoded;
+		bool bFromCache;
+		TextureCache::TEXTURE_DATA texture;
+	};
+
+	// set the texture cache used while decoding, or NULL for none
+	void SetTextureCache(const TextureCache* pTextureCache) { m_pTextureCache = pTextureCache; }
+
+	// add an image file to the list of images to decode
+	void QueueImage(const char* filename, const std::string& tag);
+	// read the size of every queued image from its file header
+	void ReadImageInfo();
+	// decode all the queued images using a pool of worker threads
+	double DecodeQueuedImages(unsigned int workerCount = 0);
+	// free the decoded image data from local memory
+	void FreeImages();
+
+	// get the list of queued and decoded images
+	std::vector<IMAGE_DATA>& GetImages() { return m_images; }
+	// get the number of worker threads used for the last decode
+	unsigned int GetWorkerCount() const { return m_workerCount; }
+
+	// decode a single image file on the calling thread
+	bool DecodeImage(IMAGE_DATA& image) const;
+
+private:
+	// texture cache used while decoding
+	const TextureCache* m_pTextureCache;
+	// images queued for decoding
+	std::vector<IMAGE_DATA> m_images;
+	// number of worker threads used for the last decode
+	unsigned int m_workerCount;
+};
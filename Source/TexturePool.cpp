@@ -0,0 +1,398 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturepool.cpp
+// ============
+// pack same sized scene textures into layers of 2D array textures
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TexturePool.h"
+#include "RenderStats.h"
+
+#include <algorithm>
+#include <iostream>
+
+/***********************************************************
+ *  TexturePool()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TexturePool::TexturePool()
+{
+	// the first array holds the 1x1 placeholder texture, its
+	// storage is created with the first allocation
+	TEXTURE_ARRAY placeholder;
+	placeholder.textureID = 0;
+	placeholder.width = 1;
+	placeholder.height = 1;
+	placeholder.format = TextureCache::FORMAT_RGBA8;
+	placeholder.levelCount = 1;
+	placeholder.layerCount = 1;
+	placeholder.allocatedLayers = 0;
+	m_arrays.push_back(placeholder);
+}
+
+/***********************************************************
+ *  ~TexturePool()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TexturePool::~TexturePool()
+{
+}
+
+/***********************************************************
+ *  GetFullLevelCount()
+ *
+ *  This method is used for getting the number of mipmap
+ *  levels in a full chain down to 1x1.
+ ***********************************************************/
+int TexturePool::GetFullLevelCount(int width, int height)
+{
+	int levelCount = 1;
+	int size = std::max(width, height);
+
+	while (size > 1)
+	{
+		size /= 2;
+		levelCount++;
+	}
+
+	return(levelCount);
+}
+
+/***********************************************************
+ *  ReserveLayer()
+ *
+ *  This method is used for reserving a layer for a texture
+ *  with the passed in size and format.  The layer is taken
+ *  from the array holding textures of the same kind, and a
+ *  new array is started when there is none yet.  The array
+ *  storage is not created until Allocate() is called.
+ ***********************************************************/
+TexturePool::TEXTURE_LOCATION TexturePool::ReserveLayer(int width, int height, TextureCache::TEXTURE_FORMAT format)
+{
+	TEXTURE_LOCATION location = GetPlaceholder();
+	int levelCount = GetFullLevelCount(width, height);
+
+	// the placeholder array is never shared
+	for (size_t i = 1; i < m_arrays.size(); i++)
+	{
+		if ((m_arrays[i].width == width) && (m_arrays[i].height == height) &&
+			(m_arrays[i].format == format) && (m_arrays[i].levelCount == levelCount))
+		{
+			location.arrayIndex = (int)i;
+			location.layer = m_arrays[i].layerCount;
+			m_arrays[i].layerCount++;
+			return(location);
+		}
+	}
+
+	if (m_arrays.size() >= MAX_TEXTURE_ARRAYS)
+	{
+		std::cout << "No texture array available for a " << width << "x" << height << " texture" << std::endl;
+		return(location);
+	}
+
+	TEXTURE_ARRAY textureArray;
+	textureArray.textureID = 0;
+	textureArray.width = width;
+	textureArray.height = height;
+	textureArray.format = format;
+	textureArray.levelCount = levelCount;
+	textureArray.layerCount = 1;
+	textureArray.allocatedLayers = 0;
+	m_arrays.push_back(textureArray);
+
+	location.arrayIndex = (int)m_arrays.size() - 1;
+	location.layer = 0;
+
+	return(location);
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  This method is used for creating the storage of every
+ *  array that has more reserved layers than allocated ones.
+ *  When an array that already holds textures has to grow,
+ *  the loaded layers are copied into the new storage.
+ ***********************************************************/
+bool TexturePool::Allocate()
+{
+	bool bReturn = true;
+
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		TEXTURE_ARRAY& textureArray = m_arrays[i];
+
+		if (textureArray.allocatedLayers >= textureArray.layerCount)
+		{
+			continue;
+		}
+
+		GLuint textureID = 0;
+		glGenTextures(1, &textureID);
+		AllocateStorage(textureArray, textureID);
+
+		if (0 != textureArray.textureID)
+		{
+			// keep the textures that were already loaded
+			if (GLEW_VERSION_4_3 || GLEW_ARB_copy_image)
+			{
+				for (int level = 0; level < textureArray.levelCount; level++)
+				{
+					glCopyImageSubData(
+						textureArray.textureID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+						textureID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+						std::max(1, textureArray.width >> level),
+						std::max(1, textureArray.height >> level),
+						textureArray.allocatedLayers);
+				}
+			}
+			else
+			{
+				std::cout << "Texture array copies are not supported, reloaded textures are needed" << std::endl;
+				bReturn = false;
+			}
+			glDeleteTextures(1, &textureArray.textureID);
+		}
+		else if (i == 0)
+		{
+			// fill in the neutral gray placeholder texel
+			const unsigned char placeholderPixel[4] = { 128, 128, 128, 255 };
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, 1, 1, 1,
+				GL_RGBA, GL_UNSIGNED_BYTE, placeholderPixel);
+		}
+
+		textureArray.textureID = textureID;
+		textureArray.allocatedLayers = textureArray.layerCount;
+	}
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	return(bReturn);
+}
+
+/***********************************************************
+ *  AllocateStorage()
+ *
+ *  This method is used for creating the storage of every
+ *  mipmap level of an array texture, and configuring the
+ *  texture mapping parameters used for the scene textures.
+ *  The new texture object is left bound.
+ ***********************************************************/
+void TexturePool::AllocateStorage(TEXTURE_ARRAY& textureArray, GLuint textureID) const
+{
+	GLenum internalFormat = GL_RGB8;
+	GLenum pixelFormat = GL_RGB;
+	bool bCompressed = (textureArray.format == TextureCache::FORMAT_BC1) ||
+		(textureArray.format == TextureCache::FORMAT_BC3);
+
+	GetGLFormat(textureArray.format, internalFormat, pixelFormat);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+	RenderStats::Add(RenderStats::TEXTURE_BINDS);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters, sampling between the
+	// prebuilt mipmap levels when the texture is minified
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, textureArray.levelCount - 1);
+
+	for (int level = 0; level < textureArray.levelCount; level++)
+	{
+		int width = std::max(1, textureArray.width >> level);
+		int height = std::max(1, textureArray.height >> level);
+
+		if (bCompressed)
+		{
+			glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat,
+				width, height, textureArray.layerCount, 0,
+				(GLsizei)(GetLevelSize(textureArray.format, width, height) * textureArray.layerCount),
+				NULL);
+		}
+		else
+		{
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, level, internalFormat,
+				width, height, textureArray.layerCount, 0,
+				pixelFormat, GL_UNSIGNED_BYTE, NULL);
+		}
+	}
+}
+
+/***********************************************************
+ *  IsCompatible()
+ *
+ *  This method is used for checking whether decoded texture
+ *  data has the size, format and mipmap levels of the array
+ *  that its layer was reserved in.
+ ***********************************************************/
+bool TexturePool::IsCompatible(
+	const TEXTURE_LOCATION& location,
+	const TextureCache::TEXTURE_DATA& texture) const
+{
+	if ((location.arrayIndex <= 0) || (location.arrayIndex >= (int)m_arrays.size()) ||
+		texture.mipLevels.empty())
+	{
+		return(false);
+	}
+
+	const TEXTURE_ARRAY& textureArray = m_arrays[location.arrayIndex];
+
+	return((textureArray.width == texture.mipLevels[0].width) &&
+		(textureArray.height == texture.mipLevels[0].height) &&
+		(textureArray.format == texture.format) &&
+		(textureArray.levelCount == (int)texture.mipLevels.size()) &&
+		(location.layer < textureArray.allocatedLayers));
+}
+
+/***********************************************************
+ *  UploadLevel()
+ *
+ *  This method is used for loading one mipmap level of a
+ *  texture into its layer.  The data pointer is an offset
+ *  into the bound pixel buffer object when one is used.
+ ***********************************************************/
+bool TexturePool::UploadLevel(
+	const TEXTURE_LOCATION& location,
+	const TextureCache::TEXTURE_DATA& texture,
+	size_t level,
+	const void* pData)
+{
+	if (IsCompatible(location, texture) == false)
+	{
+		return(false);
+	}
+
+	const TEXTURE_ARRAY& textureArray = m_arrays[location.arrayIndex];
+	const TextureCache::MIP_LEVEL& mipLevel = texture.mipLevels[level];
+	GLenum internalFormat = GL_RGB8;
+	GLenum pixelFormat = GL_RGB;
+
+	GetGLFormat(textureArray.format, internalFormat, pixelFormat);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.textureID);
+	RenderStats::Add(RenderStats::TEXTURE_BINDS);
+
+	// the smaller RGB mipmap levels have rows that are not
+	// a multiple of four bytes long
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	if ((texture.format == TextureCache::FORMAT_BC1) || (texture.format == TextureCache::FORMAT_BC3))
+	{
+		glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)level,
+			0, 0, location.layer, mipLevel.width, mipLevel.height, 1,
+			internalFormat, (GLsizei)mipLevel.data.size(), pData);
+	}
+	else
+	{
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)level,
+			0, 0, location.layer, mipLevel.width, mipLevel.height, 1,
+			pixelFormat, GL_UNSIGNED_BYTE, pData);
+	}
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	return(true);
+}
+
+/***********************************************************
+ *  BindArrays()
+ *
+ *  This method is used for binding every array texture to
+ *  the texture unit matching its array index.
+ ***********************************************************/
+void TexturePool::BindArrays() const
+{
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		glActiveTexture(GL_TEXTURE0 + (GLenum)i);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_arrays[i].textureID);
+	}
+	RenderStats::Add(RenderStats::TEXTURE_BINDS, m_arrays.size());
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing all of the array textures
+ *  and their reserved layers.
+ ***********************************************************/
+void TexturePool::Destroy()
+{
+	for (size_t i = 0; i < m_arrays.size(); i++)
+	{
+		if (0 != m_arrays[i].textureID)
+		{
+			glDeleteTextures(1, &m_arrays[i].textureID);
+		}
+	}
+
+	// only the placeholder array is kept, without its storage
+	m_arrays.resize(1);
+	m_arrays[0].textureID = 0;
+	m_arrays[0].allocatedLayers = 0;
+}
+
+/***********************************************************
+ *  GetPlaceholder()
+ *
+ *  This method is used for getting the location of the 1x1
+ *  placeholder texture.
+ ***********************************************************/
+TexturePool::TEXTURE_LOCATION TexturePool::GetPlaceholder() const
+{
+	TEXTURE_LOCATION location;
+
+	location.arrayIndex = 0;
+	location.layer = 0;
+
+	return(location);
+}
+
+/***********************************************************
+ *  GetGLFormat()
+ *
+ *  This method is used for getting the OpenGL internal
+ *  format and pixel format of a texture format.
+ ***********************************************************/
+void TexturePool::GetGLFormat(TextureCache::TEXTURE_FORMAT format, GLenum& internalFormat, GLenum& pixelFormat)
+{
+	switch (format)
+	{
+	case TextureCache::FORMAT_RGBA8:
+		internalFormat = GL_RGBA8;
+		pixelFormat = GL_RGBA;
+		break;
+	case TextureCache::FORMAT_BC1:
+		internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		pixelFormat = GL_RGB;
+		break;
+	case TextureCache::FORMAT_BC3:
+		internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		pixelFormat = GL_RGBA;
+		break;
+	case TextureCache::FORMAT_RGB8:
+	default:
+		internalFormat = GL_RGB8;
+		pixelFormat = GL_RGB;
+		break;
+	}
+}
+
+/***********************************************************
+ *  GetLevelSize()
+ *
+ *  This method is used for getting the number of bytes in
+ *  one mipmap level of one layer.
+ ***********************************************************/
+size_t TexturePool::GetLevelSize(TextureCache::TEXTURE_FORMAT format, int width, int height)
+{
+	return(TextureCache::GetLevelSize(format, width, height));
+}
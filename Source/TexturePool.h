@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturepool.h
+// ============
+// pack same sized scene textures into layers of 2D array textures
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureCache.h"
+
+#include <GL/glew.h>
+
+#include <vector>
+
+/***********************************************************
+ *  TexturePool
+ *
+ *  This class stores all of the scene textures in OpenGL 2D
+ *  array textures.  Textures with the same size, format and
+ *  number of mipmap levels share one array, and each texture
+ *  is one layer of its array.  Every array stays bound to its
+ *  own texture unit, so selecting a texture for a draw only
+ *  means passing the packed array and layer index to the
+ *  shader.  The first array always holds a 1x1 placeholder
+ *  for textures that are not loaded.
+ ***********************************************************/
+class TexturePool
+{
+public:
+	// constructor
+	TexturePool();
+	// destructor
+	~TexturePool();
+
+	// most arrays that can be bound at the same time - this must
+	// match the size of the sampler array in the fragment shader
+	static const int MAX_TEXTURE_ARRAYS = 16;
+
+	struct TEXTURE_LOCATION
+	{
+		int arrayIndex;
+		int layer;
+	};
+
+	// reserve a layer for a texture with the passed in properties
+	TEXTURE_LOCATION ReserveLayer(int width, int height, TextureCache::TEXTURE_FORMAT format);
+	// create or grow the array textures for all reserved layers
+	bool Allocate();
+	// load one mipmap level of a texture into its layer
+	bool UploadLevel(
+		const TEXTURE_LOCATION& location,
+		const TextureCache::TEXTURE_DATA& texture,
+		size_t level,
+		const void* pData);
+	// check whether decoded texture data fits a reserved layer
+	bool IsCompatible(
+		const TEXTURE_LOCATION& location,
+		const TextureCache::TEXTURE_DATA& texture) const;
+	// bind every array texture to its texture unit
+	void BindArrays() const;
+	// free all of the array textures
+	void Destroy();
+
+	// get the location of the placeholder texture
+	TEXTURE_LOCATION GetPlaceholder() const;
+	// get the number of array textures
+	int GetArrayCount() const { return (int)m_arrays.size(); }
+
+	// pack an array index and layer into the integer the shader uses
+	static int PackLocation(const TEXTURE_LOCATION& location) { return (location.arrayIndex << 16) | location.layer; }
+	// get the number of mipmap levels in a full chain
+	static int GetFullLevelCount(int width, int height);
+
+private:
+	struct TEXTURE_ARRAY
+	{
+		GLuint textureID;
+		int width;
+		int height;
+		TextureCache::TEXTURE_FORMAT format;
+		int levelCount;
+		int layerCount;
+		int allocatedLayers;
+	};
+
+	// the array textures in the pool
+	std::vector<TEXTURE_ARRAY> m_arrays;
+
+	// create the array texture storage for an array
+	void AllocateStorage(TEXTURE_ARRAY& textureArray, GLuint textureID) const;
+	// get the OpenGL formats for a texture format
+	static void GetGLFormat(TextureCache::TEXTURE_FORMAT format, GLenum& internalFormat, GLenum& pixelFormat);
+	// get the byte size of one mipmap level of one layer
+	static size_t GetLevelSize(TextureCache::TEXTURE_FORMAT format, int width, int height);
+};
@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturestreamer.cpp
+// ============
+// decode texture images in the background while the scene is rendering
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureStreamer.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+
+/***********************************************************
+ *  TextureStreamer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureStreamer::TextureStreamer()
+	: m_nextImage(0), m_decodedCount(0), m_bStopRequested(false)
+{
+}
+
+/***********************************************************
+ *  ~TextureStreamer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureStreamer::~TextureStreamer()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for starting the background threads
+ *  that decode the passed in images.  The images are given
+ *  consecutive texture slots beginning at the first slot.
+ *  When the worker count is zero, one worker per hardware
+ *  thread is used.
+ ***********************************************************/
+void TextureStreamer::Start(
+	const std::vector<TextureLoader::IMAGE_DATA>& images,
+	int firstSlot,
+	const TextureCache* pTextureCache,
+	unsigned int workerCount)
+{
+	Stop();
+
+	m_pendingImages.clear();
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		STREAMED_IMAGE streamedImage;
+		streamedImage.slot = firstSlot + (int)i;
+		streamedImage.image = images[i];
+		m_pendingImages.push_back(streamedImage);
+	}
+
+	m_nextImage = 0;
+	m_decodedCount = 0;
+	m_bStopRequested = false;
+	m_textureLoader.SetTextureCache(pTextureCache);
+
+	if (workerCount == 0)
+	{
+		workerCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	workerCount = std::min<unsigned int>(workerCount, (unsigned int)m_pendingImages.size());
+
+	// indicate to always flip images vertically when loaded
+	stbi_set_flip_vertically_on_load(true);
+
+	for (unsigned int i = 0; i < workerCount; i++)
+	{
+		m_workers.push_back(std::thread(&TextureStreamer::DecodeWorker, this));
+	}
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping the background threads.
+ *  Images that are being decoded are finished first, and the
+ *  images that were not decoded yet are dropped.
+ ***********************************************************/
+void TextureStreamer::Stop()
+{
+	m_bStopRequested = true;
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+}
+
+/***********************************************************
+ *  DecodeWorker()
+ *
+ *  This method runs on each background thread.  It keeps
+ *  taking the next image that has not been decoded yet and
+ *  puts it in the decoded image queue when it is done.
+ ***********************************************************/
+void TextureStreamer::DecodeWorker()
+{
+	size_t index = m_nextImage++;
+
+	while ((index < m_pendingImages.size()) && (m_bStopRequested == false))
+	{
+		STREAMED_IMAGE streamedImage = m_pendingImages[index];
+
+		m_textureLoader.DecodeImage(streamedImage.image);
+
+		{
+			std::lock_guard<std::mutex> lock(m_queueMutex);
+			m_decodedImages.push_back(std::move(streamedImage));
+		}
+		m_decodedCount++;
+
+		index = m_nextImage++;
+	}
+}
+
+/***********************************************************
+ *  PopDecodedImage()
+ *
+ *  This method is used for taking the next decoded image out
+ *  of the queue.  It never waits for a decode to finish, and
+ *  returns false when no decoded image is ready yet.
+ ***********************************************************/
+bool TextureStreamer::PopDecodedImage(STREAMED_IMAGE& streamedImage)
+{
+	std::lock_guard<std::mutex> lock(m_queueMutex);
+
+	if (m_decodedImages.empty())
+	{
+		return(false);
+	}
+
+	streamedImage = std::move(m_decodedImages.front());
+	m_decodedImages.pop_front();
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsFinished()
+ *
+ *  This method is used for checking whether every image has
+ *  been decoded and taken out of the decoded image queue.
+ ***********************************************************/
+bool TextureStreamer::IsFinished()
+{
+	std::lock_guard<std::mutex> lock(m_queueMutex);
+
+	return((m_decodedCount == m_pendingImages.size()) && m_decodedImages.empty());
+}
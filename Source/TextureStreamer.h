@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturestreamer.h
+// ============
+// decode texture images in the background while the scene is rendering
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureLoader.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  TextureStreamer
+ *
+ *  This class decodes texture images on background threads
+ *  without ever blocking the thread that renders the scene.
+ *  Each decoded image is put in a queue that the rendering
+ *  thread takes images from, whenever it has time to load
+ *  them into OpenGL texture memory.
+ ***********************************************************/
+class TextureStreamer
+{
+public:
+	// constructor
+	TextureStreamer();
+	// destructor
+	~TextureStreamer();
+
+	struct STREAMED_IMAGE
+	{
+		int slot;
+		TextureLoader::IMAGE_DATA image;
+	};
+
+	// start decoding the passed in images in the background
+	void Start(
+		const std::vector<TextureLoader::IMAGE_DATA>& images,
+		int firstSlot,
+		const TextureCache* pTextureCache,
+		unsigned int workerCount = 0);
+	// stop decoding and wait for the background threads to exit
+	void Stop();
+
+	// take the next decoded image from the queue, if there is one
+	bool PopDecodedImage(STREAMED_IMAGE& streamedImage);
+	// true when every image has been decoded and taken from the queue
+	bool IsFinished();
+
+private:
+	// images waiting to be decoded, and their texture slots
+	std::vector<STREAMED_IMAGE> m_pendingImages;
+	// decoded images waiting to be loaded into texture memory
+	std::deque<STREAMED_IMAGE> m_decodedImages;
+	// protects the decoded image queue
+	std::mutex m_queueMutex;
+	// index of the next image to decode
+	std::atomic<size_t> m_nextImage;
+	// number of images that have been decoded
+	std::atomic<size_t> m_decodedCount;
+	// set to stop the background threads early
+	std::atomic<bool> m_bStopRequested;
+	// background decoding threads
+	std::vector<std::thread> m_workers;
+	// decodes the images, using the texture cache when set
+	TextureLoader m_textureLoader;
+
+	// background thread that decodes pending images
+	void DecodeWorker();
+};
@@ -0,0 +1,346 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformhierarchy.cpp
+// ============
+// keep the scene object transforms with cached, dirty-tracked world matrices
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformHierarchy.h"
+#include "TransformKernels.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+
+/***********************************************************
+ *  TransformHierarchy()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TransformHierarchy::TransformHierarchy()
+{
+	m_firstDirty = 0;
+	m_version = 0;
+}
+
+/***********************************************************
+ *  AddTransform()
+ *
+ *  This method is used for adding a transform, placed
+ *  relative to the passed in parent when there is one.  The
+ *  parent has to be added already, and an invalid parent is
+ *  ignored.  The world matrix is built by the next update.
+ ***********************************************************/
+int TransformHierarchy::AddTransform(const TRANSFORM& transform, int parentIndex)
+{
+	int index = (int)m_parentIndexes.size();
+
+	if (IsValid(parentIndex) == false)
+	{
+		parentIndex = NO_PARENT;
+	}
+	else if (m_frameIndexes[parentIndex] < 0)
+	{
+		// the first child of a transform gives it a parent frame,
+		// which is built when the parent is next updated
+		m_frameIndexes[parentIndex] = (int)m_parentFrames.size();
+		m_parentFrames.push_back(glm::mat4(1.0f));
+		MarkDirty(parentIndex);
+	}
+
+	m_scaleX.push_back(transform.scaleXYZ.x);
+	m_scaleY.push_back(transform.scaleXYZ.y);
+	m_scaleZ.push_back(transform.scaleXYZ.z);
+	m_rotationX.push_back(transform.rotationDegrees.x);
+	m_rotationY.push_back(transform.rotationDegrees.y);
+	m_rotationZ.push_back(transform.rotationDegrees.z);
+	m_positionX.push_back(transform.positionXYZ.x);
+	m_positionY.push_back(transform.positionXYZ.y);
+	m_positionZ.push_back(transform.positionXYZ.z);
+	m_parentIndexes.push_back(parentIndex);
+	m_dirty.push_back(0);
+	m_updated.push_back(0);
+	m_frameIndexes.push_back(-1);
+	m_worldMatrices.push_back(glm::mat4(1.0f));
+
+	MarkDirty(index);
+
+	return(index);
+}
+
+/***********************************************************
+ *  Reserve()
+ *
+ *  This method is used for reserving memory for a number of
+ *  transforms before they are added.
+ ***********************************************************/
+void TransformHierarchy::Reserve(size_t count)
+{
+	m_scaleX.reserve(count);
+	m_scaleY.reserve(count);
+	m_scaleZ.reserve(count);
+	m_rotationX.reserve(count);
+	m_rotationY.reserve(count);
+	m_rotationZ.reserve(count);
+	m_positionX.reserve(count);
+	m_positionY.reserve(count);
+	m_positionZ.reserve(count);
+	m_parentIndexes.reserve(count);
+	m_dirty.reserve(count);
+	m_updated.reserve(count);
+	m_frameIndexes.reserve(count);
+	m_worldMatrices.reserve(count);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all of the transforms.
+ ***********************************************************/
+void TransformHierarchy::Clear()
+{
+	m_scaleX.clear();
+	m_scaleY.clear();
+	m_scaleZ.clear();
+	m_rotationX.clear();
+	m_rotationY.clear();
+	m_rotationZ.clear();
+	m_positionX.clear();
+	m_positionY.clear();
+	m_positionZ.clear();
+	m_parentIndexes.clear();
+	m_dirty.clear();
+	m_updated.clear();
+	m_frameIndexes.clear();
+	m_parentFrames.clear();
+	m_worldMatrices.clear();
+	m_firstDirty = 0;
+	m_version++;
+}
+
+/***********************************************************
+ *  GetTransform()
+ *
+ *  This method is used for getting the values of a transform.
+ ***********************************************************/
+TransformHierarchy::TRANSFORM TransformHierarchy::GetTransform(int index) const
+{
+	TRANSFORM transform;
+	transform.scaleXYZ = glm::vec3(m_scaleX[index], m_scaleY[index], m_scaleZ[index]);
+	transform.rotationDegrees = glm::vec3(m_rotationX[index], m_rotationY[index], m_rotationZ[index]);
+	transform.positionXYZ = glm::vec3(m_positionX[index], m_positionY[index], m_positionZ[index]);
+
+	return(transform);
+}
+
+/***********************************************************
+ *  SetTransform()
+ *
+ *  This method is used for changing all of the values of a
+ *  transform.  The transform is only flagged as changed when
+ *  one of its values is different.
+ ***********************************************************/
+void TransformHierarchy::SetTransform(int index, const TRANSFORM& transform)
+{
+	SetScale(index, transform.scaleXYZ);
+	SetRotation(index, transform.rotationDegrees);
+	SetPosition(index, transform.positionXYZ);
+}
+
+/***********************************************************
+ *  SetScale()
+ *
+ *  This method is used for changing the scale of a transform.
+ ***********************************************************/
+void TransformHierarchy::SetScale(int index, const glm::vec3& scaleXYZ)
+{
+	if (IsValid(index) &&
+		((m_scaleX[index] != scaleXYZ.x) || (m_scaleY[index] != scaleXYZ.y) || (m_scaleZ[index] != scaleXYZ.z)))
+	{
+		m_scaleX[index] = scaleXYZ.x;
+		m_scaleY[index] = scaleXYZ.y;
+		m_scaleZ[index] = scaleXYZ.z;
+		MarkDirty(index);
+	}
+}
+
+/***********************************************************
+ *  SetRotation()
+ *
+ *  This method is used for changing the rotation of a
+ *  transform.
+ ***********************************************************/
+void TransformHierarchy::SetRotation(int index, const glm::vec3& rotationDegrees)
+{
+	if (IsValid(index) &&
+		((m_rotationX[index] != rotationDegrees.x) || (m_rotationY[index] != rotationDegrees.y) || (m_rotationZ[index] != rotationDegrees.z)))
+	{
+		m_rotationX[index] = rotationDegrees.x;
+		m_rotationY[index] = rotationDegrees.y;
+		m_rotationZ[index] = rotationDegrees.z;
+		MarkDirty(index);
+	}
+}
+
+/***********************************************************
+ *  SetPosition()
+ *
+ *  This method is used for changing the position of a
+ *  transform.
+ ***********************************************************/
+void TransformHierarchy::SetPosition(int index, const glm::vec3& positionXYZ)
+{
+	if (IsValid(index) &&
+		((m_positionX[index] != positionXYZ.x) || (m_positionY[index] != positionXYZ.y) || (m_positionZ[index] != positionXYZ.z)))
+	{
+		m_positionX[index] = positionXYZ.x;
+		m_positionY[index] = positionXYZ.y;
+		m_positionZ[index] = positionXYZ.z;
+		MarkDirty(index);
+	}
+}
+
+/***********************************************************
+ *  MarkDirty()
+ *
+ *  This method is used for flagging a transform as changed.
+ ***********************************************************/
+void TransformHierarchy::MarkDirty(int index)
+{
+	m_dirty[index] = 1;
+	m_firstDirty = std::min(m_firstDirty, (size_t)index);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for building the world matrices of
+ *  the transforms that changed, and of every child of a
+ *  transform whose world matrix was built.  Each run of
+ *  neighboring transforms that need a new matrix is built
+ *  with one call to the SIMD kernels, and then the children
+ *  are placed in the frames of their parents.  Since parents
+ *  come before their children, one pass starting at the
+ *  first changed transform is enough.  When nothing changed,
+ *  this returns right away.
+ ***********************************************************/
+int TransformHierarchy::Update()
+{
+	size_t count = m_parentIndexes.size();
+	int updatedCount = 0;
+
+	if (m_firstDirty >= count)
+	{
+		return(0);
+	}
+
+	// a transform is built again when it changed, or its parent was
+	for (size_t i = m_firstDirty; i < count; i++)
+	{
+		int parentIndex = m_parentIndexes[i];
+		m_updated[i] = m_dirty[i] | ((parentIndex != NO_PARENT) ? m_updated[parentIndex] : 0);
+	}
+
+	TransformKernels::TRANSFORM_ARRAYS arrays;
+	arrays.scaleX = m_scaleX.data();
+	arrays.scaleY = m_scaleY.data();
+	arrays.scaleZ = m_scaleZ.data();
+	arrays.rotationX = m_rotationX.data();
+	arrays.rotationY = m_rotationY.data();
+	arrays.rotationZ = m_rotationZ.data();
+	arrays.positionX = m_positionX.data();
+	arrays.positionY = m_positionY.data();
+	arrays.positionZ = m_positionZ.data();
+
+	size_t first = m_firstDirty;
+	while (first < count)
+	{
+		if (m_updated[first] == 0)
+		{
+			first++;
+			continue;
+		}
+
+		size_t end = first + 1;
+		while ((end < count) && (m_updated[end] != 0))
+		{
+			end++;
+		}
+
+		TransformKernels::BuildMatrices(arrays, first, end - first, m_worldMatrices.data());
+		updatedCount += (int)(end - first);
+		first = end;
+	}
+
+	// place the children in the frames of their parents, and build
+	// the frames of the parents, in order so parents come first
+	if (!m_parentFrames.empty())
+	{
+		for (size_t i = m_firstDirty; i < count; i++)
+		{
+			if (m_updated[i] == 0)
+			{
+				continue;
+			}
+
+			int parentIndex = m_parentIndexes[i];
+			if (parentIndex != NO_PARENT)
+			{
+				m_worldMatrices[i] = m_parentFrames[m_frameIndexes[parentIndex]] * m_worldMatrices[i];
+			}
+
+			if (m_frameIndexes[i] >= 0)
+			{
+				glm::mat4 frame = ComputeMatrix(
+					glm::vec3(1.0f),
+					glm::vec3(m_rotationX[i], m_rotationY[i], m_rotationZ[i]),
+					glm::vec3(m_positionX[i], m_positionY[i], m_positionZ[i]));
+
+				if (parentIndex != NO_PARENT)
+				{
+					frame = m_parentFrames[m_frameIndexes[parentIndex]] * frame;
+				}
+				m_parentFrames[m_frameIndexes[i]] = frame;
+			}
+		}
+	}
+
+	// clear the flags for the next update
+	std::fill(m_dirty.begin() + m_firstDirty, m_dirty.end(), (uint8_t)0);
+	std::fill(m_updated.begin() + m_firstDirty, m_updated.end(), (uint8_t)0);
+
+	m_firstDirty = count;
+	m_version++;
+
+	return(updatedCount);
+}
+
+/***********************************************************
+ *  ComputeMatrix()
+ *
+ *  This method is used for building the matrix of a scale,
+ *  rotation and position, in the order the scene has always
+ *  used - scale, then the Z, Y and X rotations, and then the
+ *  translation.
+ ***********************************************************/
+glm::mat4 TransformHierarchy::ComputeMatrix(
+	const glm::vec3& scaleXYZ,
+	const glm::vec3& rotationDegrees,
+	const glm::vec3& positionXYZ)
+{
+	// variables for this method
+	glm::mat4 scale;
+	glm::mat4 rotationX;
+	glm::mat4 rotationY;
+	glm::mat4 rotationZ;
+	glm::mat4 translation;
+
+	scale = glm::scale(scaleXYZ);
+	rotationX = glm::rotate(glm::radians(rotationDegrees.x), glm::vec3(1.0f, 0.0f, 0.0f));
+	rotationY = glm::rotate(glm::radians(rotationDegrees.y), glm::vec3(0.0f, 1.0f, 0.0f));
+	rotationZ = glm::rotate(glm::radians(rotationDegrees.z), glm::vec3(0.0f, 0.0f, 1.0f));
+	translation = glm::translate(positionXYZ);
+
+	return(translation * rotationX * rotationY * rotationZ * scale);
+}
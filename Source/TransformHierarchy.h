@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformhierarchy.h
+// ============
+// keep the scene object transforms with cached, dirty-tracked world matrices
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  TransformHierarchy
+ *
+ *  This class stores the scale, rotation and position of
+ *  every scene object along with its world matrix.  A world
+ *  matrix is only built again when one of its values, or a
+ *  value of one of its parents, has changed, so a scene that
+ *  does not move costs nothing to update.  A child is placed
+ *  relative to the position and rotation of its parent, but
+ *  is not stretched by the parent's scale.  Parents always
+ *  have to be added before their children.  The values are
+ *  kept in one array per component, so that the matrices of
+ *  many changed transforms are built together by the SIMD
+ *  kernels of TransformKernels.
+ ***********************************************************/
+class TransformHierarchy
+{
+public:
+	// constructor
+	TransformHierarchy();
+
+	// parent index of a transform that has no parent
+	static const int NO_PARENT = -1;
+
+	struct TRANSFORM
+	{
+		glm::vec3 scaleXYZ;
+		glm::vec3 rotationDegrees;
+		glm::vec3 positionXYZ;
+	};
+
+	// add a transform, and get its index
+	int AddTransform(const TRANSFORM& transform, int parentIndex = NO_PARENT);
+	// reserve memory for a number of transforms
+	void Reserve(size_t count);
+	// remove all of the transforms
+	void Clear();
+
+	// change the values of a transform
+	void SetTransform(int index, const TRANSFORM& transform);
+	void SetScale(int index, const glm::vec3& scaleXYZ);
+	void SetRotation(int index, const glm::vec3& rotationDegrees);
+	void SetPosition(int index, const glm::vec3& positionXYZ);
+
+	// build the world matrices of the changed transforms, and
+	// get the number of world matrices that were built
+	int Update();
+
+	// get the values of a transform
+	TRANSFORM GetTransform(int index) const;
+	// get the parent of a transform
+	int GetParent(int index) const { return m_parentIndexes[index]; }
+	// get the world matrix of a transform, as of the last update
+	const glm::mat4& GetWorldMatrix(int index) const { return m_worldMatrices[index]; }
+	// get the world matrices of all the transforms, as of the last update
+	const glm::mat4* GetWorldMatrices() const { return m_worldMatrices.data(); }
+	// get the world position of a transform, as of the last update
+	glm::vec3 GetWorldPosition(int index) const { return glm::vec3(m_worldMatrices[index][3]); }
+	// get the number of transforms
+	int GetTransformCount() const { return (int)m_parentIndexes.size(); }
+	// get a number that changes whenever a world matrix changes
+	uint32_t GetVersion() const { return m_version; }
+
+	// build the matrix of a scale, rotation and position
+	static glm::mat4 ComputeMatrix(
+		const glm::vec3& scaleXYZ,
+		const glm::vec3& rotationDegrees,
+		const glm::vec3& positionXYZ);
+
+private:
+	// transform values, one array per component, with every
+	// parent before its children
+	std::vector<float> m_scaleX;
+	std::vector<float> m_scaleY;
+	std::vector<float> m_scaleZ;
+	std::vector<float> m_rotationX;
+	std::vector<float> m_rotationY;
+	std::vector<float> m_rotationZ;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	std::vector<int> m_parentIndexes;
+	// set for each transform whose values changed
+	std::vector<uint8_t> m_dirty;
+	// set for each transform whose world matrix is built this update
+	std::vector<uint8_t> m_updated;
+	// for each transform with children, its index in the parent
+	// frames, or -1
+	std::vector<int> m_frameIndexes;
+	// position and rotation only, which the children are placed in
+	std::vector<glm::mat4> m_parentFrames;
+	std::vector<glm::mat4> m_worldMatrices;
+	// lowest index of a changed transform, or the count when none changed
+	size_t m_firstDirty;
+	// changes whenever a world matrix changes
+	uint32_t m_version;
+
+	// flag a transform as changed
+	void MarkDirty(int index);
+	// check whether an index refers to a transform
+	bool IsValid(int index) const { return (index >= 0) && (index < (int)m_parentIndexes.size()); }
+};
+
@@ -0,0 +1,484 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformkernels.cpp
+// ============
+// build many model matrices at once from transforms kept in arrays
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformKernels.h"
+
+#include <atomic>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TRANSFORM_KERNELS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only allow the SSE and AVX instructions in functions
+// that are marked for them, unless the whole program is built for them
+#if defined(TRANSFORM_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TRANSFORM_KERNELS_SSE_TARGET __attribute__((target("sse2")))
+#define TRANSFORM_KERNELS_AVX_TARGET __attribute__((target("avx")))
+#else
+#define TRANSFORM_KERNELS_SSE_TARGET
+#define TRANSFORM_KERNELS_AVX_TARGET
+#endif
+
+// declaration of global variables
+namespace
+{
+	const float g_DegreesToRadians = 3.14159265358979f / 180.0f;
+
+	// pi / 2 split in three parts, so that angles are reduced
+	// to the -pi / 4 to pi / 4 range without losing precision
+	const float g_TwoOverPi = 0.636619772367581f;
+	const float g_HalfPi1 = 1.5703125f;
+	const float g_HalfPi2 = 4.837512969970703125e-4f;
+	const float g_HalfPi3 = 7.54978995489188216e-8f;
+
+	// polynomial coefficients of sine and cosine for -pi / 4 to pi / 4
+	const float g_SinCoefficients[3] = { -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f };
+	const float g_CosCoefficients[3] = { 2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f };
+
+	const char* g_KernelNames[TransformKernels::KERNEL_TYPE_COUNT] = { "scalar", "sse", "avx" };
+
+	// the kernel in use, or -1 until the first matrices are built
+	std::atomic<int> g_Kernel(-1);
+
+	/***********************************************************
+	 *  BuildMatricesScalar()
+	 *
+	 *  This function is used for building the model matrices
+	 *  of a range of transforms one at a time.  The matrices
+	 *  are the same as translation * rotationX * rotationY *
+	 *  rotationZ * scale.
+	 ***********************************************************/
+	void BuildMatricesScalar(
+		const TransformKernels::TRANSFORM_ARRAYS& transforms,
+		size_t first,
+		size_t count,
+		glm::mat4* pMatrices)
+	{
+		for (size_t i = first; i < first + count; i++)
+		{
+			float sinX = std::sin(transforms.rotationX[i] * g_DegreesToRadians);
+			float cosX = std::cos(transforms.rotationX[i] * g_DegreesToRadians);
+			float sinY = std::sin(transforms.rotationY[i] * g_DegreesToRadians);
+			float cosY = std::cos(transforms.rotationY[i] * g_DegreesToRadians);
+			float sinZ = std::sin(transforms.rotationZ[i] * g_DegreesToRadians);
+			float cosZ = std::cos(transforms.rotationZ[i] * g_DegreesToRadians);
+			float scaleX = transforms.scaleX[i];
+			float scaleY = transforms.scaleY[i];
+			float scaleZ = transforms.scaleZ[i];
+
+			glm::mat4& matrix = pMatrices[i];
+			matrix[0] = glm::vec4(
+				cosY * cosZ * scaleX,
+				(sinX * sinY * cosZ + cosX * sinZ) * scaleX,
+				(sinX * sinZ - cosX * sinY * cosZ) * scaleX,
+				0.0f);
+			matrix[1] = glm::vec4(
+				-cosY * sinZ * scaleY,
+				(cosX * cosZ - sinX * sinY * sinZ) * scaleY,
+				(cosX * sinY * sinZ + sinX * cosZ) * scaleY,
+				0.0f);
+			matrix[2] = glm::vec4(
+				sinY * scaleZ,
+				-sinX * cosY * scaleZ,
+				cosX * cosY * scaleZ,
+				0.0f);
+			matrix[3] = glm::vec4(
+				transforms.positionX[i],
+				transforms.positionY[i],
+				transforms.positionZ[i],
+				1.0f);
+		}
+	}
+
+#ifdef TRANSFORM_KERNELS_X86
+	/***********************************************************
+	 *  SinCosSSE()
+	 *
+	 *  This function is used for getting the sine and cosine
+	 *  of four angles, in radians.
+	 ***********************************************************/
+	TRANSFORM_KERNELS_SSE_TARGET inline void SinCosSSE(__m128 angle, __m128& sine, __m128& cosine)
+	{
+		// reduce the angle by the nearest multiple of pi / 2
+		__m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(g_TwoOverPi)));
+		__m128 multiple = _mm_cvtepi32_ps(quadrant);
+		__m128 x = _mm_sub_ps(angle, _mm_mul_ps(multiple, _mm_set1_ps(g_HalfPi1)));
+		x = _mm_sub_ps(x, _mm_mul_ps(multiple, _mm_set1_ps(g_HalfPi2)));
+		x = _mm_sub_ps(x, _mm_mul_ps(multiple, _mm_set1_ps(g_HalfPi3)));
+		__m128 x2 = _mm_mul_ps(x, x);
+
+		__m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(g_SinCoefficients[0]), x2), _mm_set1_ps(g_SinCoefficients[1]));
+		s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(g_SinCoefficients[2]));
+		s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, x2), x), x);
+
+		__m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(g_CosCoefficients[0]), x2), _mm_set1_ps(g_CosCoefficients[1]));
+		c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(g_CosCoefficients[2]));
+		c = _mm_mul_ps(_mm_mul_ps(c, x2), x2);
+		c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(x2, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+		// sine and cosine trade places in the odd quadrants, sine
+		// is negative in quadrants 2 and 3, and cosine in 1 and 2
+		quadrant = _mm_and_si128(quadrant, _mm_set1_epi32(3));
+		__m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+		__m128 sineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), 30));
+		__m128 cosineSign = _mm_castsi128_ps(_mm_slli_epi32(
+			_mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30));
+
+		sine = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+		cosine = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+		sine = _mm_xor_ps(sine, sineSign);
+		cosine = _mm_xor_ps(cosine, cosineSign);
+	}
+
+	/***********************************************************
+	 *  StoreColumnSSE()
+	 *
+	 *  This function is used for storing one column of four
+	 *  matrices, from one register per component.
+	 ***********************************************************/
+	TRANSFORM_KERNELS_SSE_TARGET inline void StoreColumnSSE(
+		float* pMatrices, int column, __m128 x, __m128 y, __m128 z, __m128 w)
+	{
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(pMatrices + column * 4, x);
+		_mm_storeu_ps(pMatrices + 16 + column * 4, y);
+		_mm_storeu_ps(pMatrices + 32 + column * 4, z);
+		_mm_storeu_ps(pMatrices + 48 + column * 4, w);
+	}
+
+	/***********************************************************
+	 *  BuildMatricesSSE()
+	 *
+	 *  This function is used for building the model matrices
+	 *  of a range of transforms four at a time.
+	 ***********************************************************/
+	TRANSFORM_KERNELS_SSE_TARGET void BuildMatricesSSE(
+		const TransformKernels::TRANSFORM_ARRAYS& transforms,
+		size_t first,
+		size_t count,
+		glm::mat4* pMatrices)
+	{
+		const __m128 toRadians = _mm_set1_ps(g_DegreesToRadians);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		size_t end = first + count;
+		size_t i = first;
+
+		for (; i + 4 <= end; i += 4)
+		{
+			__m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+			SinCosSSE(_mm_mul_ps(_mm_loadu_ps(transforms.rotationX + i), toRadians), sinX, cosX);
+			SinCosSSE(_mm_mul_ps(_mm_loadu_ps(transforms.rotationY + i), toRadians), sinY, cosY);
+			SinCosSSE(_mm_mul_ps(_mm_loadu_ps(transforms.rotationZ + i), toRadians), sinZ, cosZ);
+			__m128 scaleX = _mm_loadu_ps(transforms.scaleX + i);
+			__m128 scaleY = _mm_loadu_ps(transforms.scaleY + i);
+			__m128 scaleZ = _mm_loadu_ps(transforms.scaleZ + i);
+
+			__m128 sinYcosZ = _mm_mul_ps(sinY, cosZ);
+			__m128 sinYsinZ = _mm_mul_ps(sinY, sinZ);
+			float* pOut = &pMatrices[i][0][0];
+
+			StoreColumnSSE(pOut, 0,
+				_mm_mul_ps(_mm_mul_ps(cosY, cosZ), scaleX),
+				_mm_mul_ps(_mm_add_ps(_mm_mul_ps(sinX, sinYcosZ), _mm_mul_ps(cosX, sinZ)), scaleX),
+				_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(sinX, sinZ), _mm_mul_ps(cosX, sinYcosZ)), scaleX),
+				zero);
+			StoreColumnSSE(pOut, 1,
+				_mm_mul_ps(_mm_sub_ps(zero, _mm_mul_ps(cosY, sinZ)), scaleY),
+				_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(cosX, cosZ), _mm_mul_ps(sinX, sinYsinZ)), scaleY),
+				_mm_mul_ps(_mm_add_ps(_mm_mul_ps(cosX, sinYsinZ), _mm_mul_ps(sinX, cosZ)), scaleY),
+				zero);
+			StoreColumnSSE(pOut, 2,
+				_mm_mul_ps(sinY, scaleZ),
+				_mm_mul_ps(_mm_sub_ps(zero, _mm_mul_ps(sinX, cosY)), scaleZ),
+				_mm_mul_ps(_mm_mul_ps(cosX, cosY), scaleZ),
+				zero);
+			StoreColumnSSE(pOut, 3,
+				_mm_loadu_ps(transforms.positionX + i),
+				_mm_loadu_ps(transforms.positionY + i),
+				_mm_loadu_ps(transforms.positionZ + i),
+				one);
+		}
+
+		BuildMatricesScalar(transforms, i, end - i, pMatrices);
+	}
+
+	/***********************************************************
+	 *  SinCosAVX()
+	 *
+	 *  This function is used for getting the sine and cosine
+	 *  of eight angles, in radians.  AVX has no 256-bit integer
+	 *  instructions, so the quadrant is worked out in two
+	 *  halves with SSE integer instructions.
+	 ***********************************************************/
+	TRANSFORM_KERNELS_AVX_TARGET inline void SinCosAVX(__m256 angle, __m256& sine, __m256& cosine)
+	{
+		// reduce the angle by the nearest multiple of pi / 2
+		__m256 multiple = _mm256_round_ps(_mm256_mul_ps(angle, _mm256_set1_ps(g_TwoOverPi)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+		__m256 x = _mm256_sub_ps(angle, _mm256_mul_ps(multiple, _mm256_set1_ps(g_HalfPi1)));
+		x = _mm256_sub_ps(x, _mm256_mul_ps(multiple, _mm256_set1_ps(g_HalfPi2)));
+		x = _mm256_sub_ps(x, _mm256_mul_ps(multiple, _mm256_set1_ps(g_HalfPi3)));
+		__m256 x2 = _mm256_mul_ps(x, x);
+
+		__m256 s = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(g_SinCoefficients[0]), x2), _mm256_set1_ps(g_SinCoefficients[1]));
+		s = _mm256_add_ps(_mm256_mul_ps(s, x2), _mm256_set1_ps(g_SinCoefficients[2]));
+		s = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(s, x2), x), x);
+
+		__m256 c = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(g_CosCoefficients[0]), x2), _mm256_set1_ps(g_CosCoefficients[1]));
+		c = _mm256_add_ps(_mm256_mul_ps(c, x2), _mm256_set1_ps(g_CosCoefficients[2]));
+		c = _mm256_mul_ps(_mm256_mul_ps(c, x2), x2);
+		c = _mm256_add_ps(_mm256_sub_ps(c, _mm256_mul_ps(x2, _mm256_set1_ps(0.5f))), _mm256_set1_ps(1.0f));
+
+		// sine and cosine trade places in the odd quadrants, sine
+		// is negative in quadrants 2 and 3, and cosine in 1 and 2
+		__m256i quadrant = _mm256_cvtps_epi32(multiple);
+		__m128i quadrants[2] = { _mm256_castsi256_si128(quadrant), _mm256_extractf128_si256(quadrant, 1) };
+		__m128i swaps[2];
+		__m128i sineSigns[2];
+		__m128i cosineSigns[2];
+		for (int half = 0; half < 2; half++)
+		{
+			__m128i quarter = _mm_and_si128(quadrants[half], _mm_set1_epi32(3));
+			swaps[half] = _mm_cmpeq_epi32(_mm_and_si128(quarter, _mm_set1_epi32(1)), _mm_set1_epi32(1));
+			sineSigns[half] = _mm_slli_epi32(_mm_and_si128(quarter, _mm_set1_epi32(2)), 30);
+			cosineSigns[half] = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quarter, _mm_set1_epi32(1)), _mm_set1_epi32(2)), 30);
+		}
+		__m256 swap = _mm256_castsi256_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(swaps[0]), swaps[1], 1));
+		__m256 sineSign = _mm256_castsi256_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(sineSigns[0]), sineSigns[1], 1));
+		__m256 cosineSign = _mm256_castsi256_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(cosineSigns[0]), cosineSigns[1], 1));
+
+		sine = _mm256_or_ps(_mm256_and_ps(swap, c), _mm256_andnot_ps(swap, s));
+		cosine = _mm256_or_ps(_mm256_and_ps(swap, s), _mm256_andnot_ps(swap, c));
+		sine = _mm256_xor_ps(sine, sineSign);
+		cosine = _mm256_xor_ps(cosine, cosineSign);
+	}
+
+	/***********************************************************
+	 *  TransposeAVX()
+	 *
+	 *  This function is used for turning one register per
+	 *  component into one column per matrix.  The low half of
+	 *  each result holds the column of matrix 0 to 3, and the
+	 *  high half the column of matrix 4 to 7.
+	 ***********************************************************/
+	TRANSFORM_KERNELS_AVX_TARGET inline void TransposeAVX(__m256& x, __m256& y, __m256& z, __m256& w)
+	{
+		__m256 xyLow = _mm256_unpacklo_ps(x, y);
+		__m256 xyHigh = _mm256_unpackhi_ps(x, y);
+		__m256 zwLow = _mm256_unpacklo_ps(z, w);
+		__m256 zwHigh = _mm256_unpackhi_ps(z, w);
+
+		x = _mm256_shuffle_ps(xyLow, zwLow, 0x44);
+		y = _mm256_shuffle_ps(xyLow, zwLow, 0xEE);
+		z = _mm256_shuffle_ps(xyHigh, zwHigh, 0x44);
+		w = _mm256_shuffle_ps(xyHigh, zwHigh, 0xEE);
+	}
+
+	/***********************************************************
+	 *  BuildMatricesAVX()
+	 *
+	 *  This function is used for building the model matrices
+	 *  of a range of transforms eight at a time.
+	 ***********************************************************/
+	TRANSFORM_KERNELS_AVX_TARGET void BuildMatricesAVX(
+		const TransformKernels::TRANSFORM_ARRAYS& transforms,
+		size_t first,
+		size_t count,
+		glm::mat4* pMatrices)
+	{
+		const __m256 toRadians = _mm256_set1_ps(g_DegreesToRadians);
+		const __m256 zero = _mm256_setzero_ps();
+		size_t end = first + count;
+		size_t i = first;
+
+		for (; i + 8 <= end; i += 8)
+		{
+			__m256 sinX, cosX, sinY, cosY, sinZ, cosZ;
+			SinCosAVX(_mm256_mul_ps(_mm256_loadu_ps(transforms.rotationX + i), toRadians), sinX, cosX);
+			SinCosAVX(_mm256_mul_ps(_mm256_loadu_ps(transforms.rotationY + i), toRadians), sinY, cosY);
+			SinCosAVX(_mm256_mul_ps(_mm256_loadu_ps(transforms.rotationZ + i), toRadians), sinZ, cosZ);
+			__m256 scaleX = _mm256_loadu_ps(transforms.scaleX + i);
+			__m256 scaleY = _mm256_loadu_ps(transforms.scaleY + i);
+			__m256 scaleZ = _mm256_loadu_ps(transforms.scaleZ + i);
+
+			__m256 sinYcosZ = _mm256_mul_ps(sinY, cosZ);
+			__m256 sinYsinZ = _mm256_mul_ps(sinY, sinZ);
+
+			// columns[column][component] before the transpose, and
+			// columns[column][matrix] after it
+			__m256 columns[4][4];
+			columns[0][0] = _mm256_mul_ps(_mm256_mul_ps(cosY, cosZ), scaleX);
+			columns[0][1] = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(sinX, sinYcosZ), _mm256_mul_ps(cosX, sinZ)), scaleX);
+			columns[0][2] = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(sinX, sinZ), _mm256_mul_ps(cosX, sinYcosZ)), scaleX);
+			columns[0][3] = zero;
+			columns[1][0] = _mm256_mul_ps(_mm256_sub_ps(zero, _mm256_mul_ps(cosY, sinZ)), scaleY);
+			columns[1][1] = _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(cosX, cosZ), _mm256_mul_ps(sinX, sinYsinZ)), scaleY);
+			columns[1][2] = _mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(cosX, sinYsinZ), _mm256_mul_ps(sinX, cosZ)), scaleY);
+			columns[1][3] = zero;
+			columns[2][0] = _mm256_mul_ps(sinY, scaleZ);
+			columns[2][1] = _mm256_mul_ps(_mm256_sub_ps(zero, _mm256_mul_ps(sinX, cosY)), scaleZ);
+			columns[2][2] = _mm256_mul_ps(_mm256_mul_ps(cosX, cosY), scaleZ);
+			columns[2][3] = zero;
+			columns[3][0] = _mm256_loadu_ps(transforms.positionX + i);
+			columns[3][1] = _mm256_loadu_ps(transforms.positionY + i);
+			columns[3][2] = _mm256_loadu_ps(transforms.positionZ + i);
+			columns[3][3] = _mm256_set1_ps(1.0f);
+
+			for (int column = 0; column < 4; column++)
+			{
+				TransposeAVX(columns[column][0], columns[column][1], columns[column][2], columns[column][3]);
+			}
+
+			// each matrix is stored as two halves of two columns each
+			float* pOut = &pMatrices[i][0][0];
+			for (int matrix = 0; matrix < 4; matrix++)
+			{
+				_mm256_storeu_ps(pOut + matrix * 16, _mm256_permute2f128_ps(columns[0][matrix], columns[1][matrix], 0x20));
+				_mm256_storeu_ps(pOut + matrix * 16 + 8, _mm256_permute2f128_ps(columns[2][matrix], columns[3][matrix], 0x20));
+				_mm256_storeu_ps(pOut + (matrix + 4) * 16, _mm256_permute2f128_ps(columns[0][matrix], columns[1][matrix], 0x31));
+				_mm256_storeu_ps(pOut + (matrix + 4) * 16 + 8, _mm256_permute2f128_ps(columns[2][matrix], columns[3][matrix], 0x31));
+			}
+		}
+
+		BuildMatricesSSE(transforms, i, end - i, pMatrices);
+	}
+#endif
+}
+
+/***********************************************************
+ *  BuildMatrices()
+ *
+ *  This method is used for building the model matrices of
+ *  a range of transforms with the chosen kernel.
+ ***********************************************************/
+void TransformKernels::BuildMatrices(
+	const TRANSFORM_ARRAYS& transforms,
+	size_t first,
+	size_t count,
+	glm::mat4* pMatrices)
+{
+	switch (GetKernel())
+	{
+#ifdef TRANSFORM_KERNELS_X86
+	case KERNEL_AVX:
+		BuildMatricesAVX(transforms, first, count, pMatrices);
+		break;
+	case KERNEL_SSE:
+		BuildMatricesSSE(transforms, first, count, pMatrices);
+		break;
+#endif
+	default:
+		BuildMatricesScalar(transforms, first, count, pMatrices);
+		break;
+	}
+}
+
+/***********************************************************
+ *  GetKernel()
+ *
+ *  This method is used for getting the kernel that builds
+ *  the matrices.  The first time, the fastest kernel that
+ *  the processor supports is chosen.
+ ***********************************************************/
+TransformKernels::KERNEL_TYPE TransformKernels::GetKernel()
+{
+	int kernel = g_Kernel.load(std::memory_order_relaxed);
+
+	if (kernel < 0)
+	{
+		kernel = KERNEL_SCALAR;
+		if (IsKernelSupported(KERNEL_AVX))
+		{
+			kernel = KERNEL_AVX;
+		}
+		else if (IsKernelSupported(KERNEL_SSE))
+		{
+			kernel = KERNEL_SSE;
+		}
+		g_Kernel.store(kernel, std::memory_order_relaxed);
+	}
+
+	return((KERNEL_TYPE)kernel);
+}
+
+/***********************************************************
+ *  SetKernel()
+ *
+ *  This method is used for choosing the kernel that builds
+ *  the matrices.  A kernel the processor does not support
+ *  is not chosen, and false is returned.
+ ***********************************************************/
+bool TransformKernels::SetKernel(KERNEL_TYPE kernel)
+{
+	if (IsKernelSupported(kernel) == false)
+	{
+		return(false);
+	}
+
+	g_Kernel.store(kernel, std::memory_order_relaxed);
+	return(true);
+}
+
+/***********************************************************
+ *  IsKernelSupported()
+ *
+ *  This method is used for checking whether the processor,
+ *  and for AVX the operating system, supports a kernel.
+ ***********************************************************/
+bool TransformKernels::IsKernelSupported(KERNEL_TYPE kernel)
+{
+	switch (kernel)
+	{
+	case KERNEL_SCALAR:
+		return(true);
+#ifdef TRANSFORM_KERNELS_X86
+#ifdef _MSC_VER
+	case KERNEL_SSE:
+	case KERNEL_AVX:
+	{
+		int cpuInfo[4];
+		__cpuid(cpuInfo, 1);
+		if (kernel == KERNEL_SSE)
+		{
+			return((cpuInfo[3] & (1 << 26)) != 0);
+		}
+		// AVX needs the OS to save the 256-bit registers too
+		bool bAVX = ((cpuInfo[2] & (1 << 28)) != 0) && ((cpuInfo[2] & (1 << 27)) != 0);
+		return(bAVX && ((_xgetbv(0) & 6) == 6));
+	}
+#else
+	case KERNEL_SSE:
+		return(__builtin_cpu_supports("sse2") != 0);
+	case KERNEL_AVX:
+		return(__builtin_cpu_supports("avx") != 0);
+#endif
+#endif
+	default:
+		return(false);
+	}
+}
+
+/***********************************************************
+ *  GetKernelName()
+ *
+ *  This method is used for getting the name of a kernel.
+ ***********************************************************/
+const char* TransformKernels::GetKernelName(KERNEL_TYPE kernel)
+{
+	if ((kernel < 0) || (kernel >= KERNEL_TYPE_COUNT))
+	{
+		return("unknown");
+	}
+
+	return(g_KernelNames[kernel]);
+}
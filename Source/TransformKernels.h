@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformkernels.h
+// ============
+// build many model matrices at once from transforms kept in arrays
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+/***********************************************************
+ *  TransformKernels
+ *
+ *  This class builds the model matrices of a range of
+ *  transforms that are kept as separate arrays of scale,
+ *  rotation and position values.  Matrices are built four
+ *  at a time with SSE, or eight at a time with AVX, with a
+ *  scalar version for every other processor.  The fastest
+ *  version the processor supports is picked the first time
+ *  matrices are built, and can be changed for testing.
+ ***********************************************************/
+class TransformKernels
+{
+public:
+	enum KERNEL_TYPE
+	{
+		KERNEL_SCALAR = 0,
+		KERNEL_SSE,
+		KERNEL_AVX,
+		KERNEL_TYPE_COUNT
+	};
+
+	// the transform values, with one array per component
+	struct TRANSFORM_ARRAYS
+	{
+		const float* scaleX;
+		const float* scaleY;
+		const float* scaleZ;
+		const float* rotationX;
+		const float* rotationY;
+		const float* rotationZ;
+		const float* positionX;
+		const float* positionY;
+		const float* positionZ;
+	};
+
+	// build the model matrices of the transforms from first to
+	// first + count, into the matrices from the same index
+	static void BuildMatrices(
+		const TRANSFORM_ARRAYS& transforms,
+		size_t first,
+		size_t count,
+		glm::mat4* pMatrices);
+
+	// get the kernel that builds the matrices
+	static KERNEL_TYPE GetKernel();
+	// choose the kernel, if the processor supports it
+	static bool SetKernel(KERNEL_TYPE kernel);
+	// check whether the processor supports a kernel
+	static bool IsKernelSupported(KERNEL_TYPE kernel);
+	// get the name of a kernel
+	static const char* GetKernelName(KERNEL_TYPE kernel);
+};
@@ -0,0 +1,250 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformcache.cpp
+// ============
+// cache shader uniform locations and skip uniform writes that change nothing
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UniformCache.h"
+#include "RenderStats.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+
+/***********************************************************
+ *  UniformCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+UniformCache::UniformCache()
+{
+	m_programID = 0;
+	m_frameSet = 0;
+	m_frameSkipped = 0;
+	m_lastFrameSet = 0;
+	m_lastFrameSkipped = 0;
+}
+
+/***********************************************************
+ *  SetProgram()
+ *
+ *  This method is used for setting the shader program that
+ *  the uniforms belong to.  When the program changes, every
+ *  uniform location is looked up again the next time it is
+ *  used, and all of the shadow values are dropped.
+ ***********************************************************/
+void UniformCache::SetProgram(GLuint programID)
+{
+	if (programID == m_programID)
+	{
+		return;
+	}
+
+	m_programID = programID;
+	for (size_t i = 0; i < m_uniforms.size(); i++)
+	{
+		m_uniforms[i].location = LOCATION_UNRESOLVED;
+		m_uniforms[i].bHasValue = false;
+	}
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for dropping all of the shadow values,
+ *  so that the next write to each uniform always happens.
+ ***********************************************************/
+void UniformCache::Invalidate()
+{
+	for (size_t i = 0; i < m_uniforms.size(); i++)
+	{
+		m_uniforms[i].bHasValue = false;
+	}
+}
+
+/***********************************************************
+ *  GetUniform()
+ *
+ *  This method is used for getting the handle of the uniform
+ *  with the passed in name.  Handles stay valid for the life
+ *  of the cache, even when the shader program is changed.
+ ***********************************************************/
+int UniformCache::GetUniform(const std::string& name)
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_uniformHandles.find(name);
+
+	if (found != m_uniformHandles.end())
+	{
+		return(found->second);
+	}
+
+	UNIFORM_ENTRY entry;
+	entry.name = name;
+	entry.location = LOCATION_UNRESOLVED;
+	entry.bHasValue = false;
+	entry.valueCount = 0;
+
+	int uniform = (int)m_uniforms.size();
+	m_uniforms.push_back(entry);
+	m_uniformHandles[name] = uniform;
+
+	return(uniform);
+}
+
+/***********************************************************
+ *  PrepareWrite()
+ *
+ *  This method is used for checking whether a uniform write
+ *  is needed.  The location is looked up on the first write
+ *  in the current program.  When the new values match the
+ *  shadow values, the write is counted as skipped and NULL
+ *  is returned, otherwise the shadow values are updated.
+ ***********************************************************/
+UniformCache::UNIFORM_ENTRY* UniformCache::PrepareWrite(int uniform, const float* values, int valueCount)
+{
+	if ((uniform < 0) || (uniform >= (int)m_uniforms.size()) || (m_programID == 0))
+	{
+		return(NULL);
+	}
+
+	UNIFORM_ENTRY& entry = m_uniforms[uniform];
+
+	if (entry.location == LOCATION_UNRESOLVED)
+	{
+		entry.location = glGetUniformLocation(m_programID, entry.name.c_str());
+	}
+
+	// uniforms that are not in the program, or that were removed
+	// by the shader compiler, are never written
+	if ((entry.location < 0) ||
+		(entry.bHasValue && (entry.valueCount == valueCount) &&
+			(memcmp(entry.values, values, valueCount * sizeof(float)) == 0)))
+	{
+		m_frameSkipped++;
+		RenderStats::Add(RenderStats::UNIFORMS_SKIPPED);
+		return(NULL);
+	}
+
+	memcpy(entry.values, values, valueCount * sizeof(float));
+	entry.valueCount = valueCount;
+	entry.bHasValue = true;
+	m_frameSet++;
+	RenderStats::Add(RenderStats::UNIFORM_UPLOADS);
+
+	return(&entry);
+}
+
+/***********************************************************
+ *  SetBoolValue()
+ *
+ *  This method is used for setting a bool uniform value.
+ ***********************************************************/
+void UniformCache::SetBoolValue(int uniform, bool value)
+{
+	SetIntValue(uniform, value ? 1 : 0);
+}
+
+/***********************************************************
+ *  SetIntValue()
+ *
+ *  This method is used for setting an int uniform value.
+ ***********************************************************/
+void UniformCache::SetIntValue(int uniform, int value)
+{
+	// the integer bits are compared as they are
+	float shadow;
+	memcpy(&shadow, &value, sizeof(shadow));
+
+	UNIFORM_ENTRY* pEntry = PrepareWrite(uniform, &shadow, 1);
+	if (NULL != pEntry)
+	{
+		glUniform1i(pEntry->location, value);
+	}
+}
+
+/***********************************************************
+ *  SetFloatValue()
+ *
+ *  This method is used for setting a float uniform value.
+ ***********************************************************/
+void UniformCache::SetFloatValue(int uniform, float value)
+{
+	UNIFORM_ENTRY* pEntry = PrepareWrite(uniform, &value, 1);
+	if (NULL != pEntry)
+	{
+		glUniform1f(pEntry->location, value);
+	}
+}
+
+/***********************************************************
+ *  SetVec2Value()
+ *
+ *  This method is used for setting a vec2 uniform value.
+ ***********************************************************/
+void UniformCache::SetVec2Value(int uniform, const glm::vec2& value)
+{
+	UNIFORM_ENTRY* pEntry = PrepareWrite(uniform, glm::value_ptr(value), 2);
+	if (NULL != pEntry)
+	{
+		glUniform2fv(pEntry->location, 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetVec3Value()
+ *
+ *  This method is used for setting a vec3 uniform value.
+ ***********************************************************/
+void UniformCache::SetVec3Value(int uniform, const glm::vec3& value)
+{
+	UNIFORM_ENTRY* pEntry = PrepareWrite(uniform, glm::value_ptr(value), 3);
+	if (NULL != pEntry)
+	{
+		glUniform3fv(pEntry->location, 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetVec4Value()
+ *
+ *  This method is used for setting a vec4 uniform value.
+ ***********************************************************/
+void UniformCache::SetVec4Value(int uniform, const glm::vec4& value)
+{
+	UNIFORM_ENTRY* pEntry = PrepareWrite(uniform, glm::value_ptr(value), 4);
+	if (NULL != pEntry)
+	{
+		glUniform4fv(pEntry->location, 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetMat4Value()
+ *
+ *  This method is used for setting a mat4 uniform value.
+ ***********************************************************/
+void UniformCache::SetMat4Value(int uniform, const glm::mat4& value)
+{
+	UNIFORM_ENTRY* pEntry = PrepareWrite(uniform, glm::value_ptr(value), 16);
+	if (NULL != pEntry)
+	{
+		glUniformMatrix4fv(pEntry->location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting the uniform write counts
+ *  of a new frame.  The counts of the frame that just ended
+ *  are kept for reporting.
+ ***********************************************************/
+void UniformCache::BeginFrame()
+{
+	m_lastFrameSet = m_frameSet;
+	m_lastFrameSkipped = m_frameSkipped;
+	m_frameSet = 0;
+	m_frameSkipped = 0;
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformcache.h
+// ============
+// cache shader uniform locations and skip uniform writes that change nothing
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  UniformCache
+ *
+ *  This class sets the uniform values of the active shader
+ *  program.  Each uniform name is given a handle the first
+ *  time it is used, and its location is looked up only once
+ *  per shader program.  A shadow copy of the last value of
+ *  each uniform is kept, so that writes which would not
+ *  change anything never reach the OpenGL driver.  The number
+ *  of uniforms set and skipped is counted for every frame.
+ *
+ *  All uniform values of the program must be set through this
+ *  class, or Invalidate() must be called after setting them
+ *  some other way, for the shadow copies to stay correct.
+ ***********************************************************/
+class UniformCache
+{
+public:
+	// constructor
+	UniformCache();
+
+	// use the passed in shader program for all of the uniforms
+	void SetProgram(GLuint programID);
+	// forget the shadow values, so that the next writes all happen
+	void Invalidate();
+
+	// get the handle of the uniform with the passed in name
+	int GetUniform(const std::string& name);
+
+	// set uniform values by handle
+	void SetBoolValue(int uniform, bool value);
+	void SetIntValue(int uniform, int value);
+	void SetFloatValue(int uniform, float value);
+	void SetVec2Value(int uniform, const glm::vec2& value);
+	void SetVec3Value(int uniform, const glm::vec3& value);
+	void SetVec4Value(int uniform, const glm::vec4& value);
+	void SetMat4Value(int uniform, const glm::mat4& value);
+
+	// set uniform values by name
+	void SetBoolValue(const std::string& name, bool value) { SetBoolValue(GetUniform(name), value); }
+	void SetIntValue(const std::string& name, int value) { SetIntValue(GetUniform(name), value); }
+	void SetFloatValue(const std::string& name, float value) { SetFloatValue(GetUniform(name), value); }
+	void SetVec2Value(const std::string& name, const glm::vec2& value) { SetVec2Value(GetUniform(name), value); }
+	void SetVec3Value(const std::string& name, const glm::vec3& value) { SetVec3Value(GetUniform(name), value); }
+	void SetVec4Value(const std::string& name, const glm::vec4& value) { SetVec4Value(GetUniform(name), value); }
+	void SetMat4Value(const std::string& name, const glm::mat4& value) { SetMat4Value(GetUniform(name), value); }
+
+	// start counting the uniform writes of a new frame
+	void BeginFrame();
+	// get the uniform write counts of the last finished frame
+	unsigned int GetUniformsSet() const { return m_lastFrameSet; }
+	unsigned int GetUniformsSkipped() const { return m_lastFrameSkipped; }
+
+private:
+	// location has not been looked up in the current program yet
+	static const GLint LOCATION_UNRESOLVED = -2;
+
+	struct UNIFORM_ENTRY
+	{
+		std::string name;
+		GLint location;
+		bool bHasValue;
+		int valueCount;
+		float values[16];
+	};
+
+	// the shader program that the uniforms belong to
+	GLuint m_programID;
+	// uniforms indexed by handle
+	std::vector<UNIFORM_ENTRY> m_uniforms;
+	// uniform handles indexed by name
+	std::unordered_map<std::string, int> m_uniformHandles;
+
+	// uniform write counts of the current frame
+	unsigned int m_frameSet;
+	unsigned int m_frameSkipped;
+	// uniform write counts of the last finished frame
+	unsigned int m_lastFrameSet;
+	unsigned int m_lastFrameSkipped;
+
+	// get the uniform to write, or NULL when the write is not needed
+	UNIFORM_ENTRY* PrepareWrite(int uniform, const float* values, int valueCount);
+};
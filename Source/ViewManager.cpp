@@ -1,296 +1,661 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "ViewManager.h"
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-#include <GLFW/glfw3.h>
-
-// declaration of the global variables and defines
-namespace
-{
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1000;
-	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
-	// camera object used for viewing and interacting with
-	// the 3D scene
-	Camera* g_pCamera = nullptr;
-
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f;
-	float gLastFrame = 0.0f;
-
-	// if orthographic projection is on, this value will be
-	// true
-	bool bOrthographicProjection = false;
-}
-
-/***********************************************************
- *  ViewManager()
- *
- *  The constructor for the class
- ***********************************************************/
-ViewManager::ViewManager(
-	ShaderManager* pShaderManager)
-{
-	// initialize the member variables
-	m_pShaderManager = pShaderManager;
-	m_pWindow = NULL;
-	g_pCamera = new Camera();
-	// default camera view parameters
-	g_pCamera->Position = glm::vec3(0.5f, 5.5f, 10.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 80;
-
-}
-
-/***********************************************************
- *  ~ViewManager()
- *
- *  The destructor for the class
- ***********************************************************/
-ViewManager::~ViewManager()
-{
-	// free up allocated memory
-	m_pShaderManager = NULL;
-	m_pWindow = NULL;
-	if (NULL != g_pCamera)
-	{
-		delete g_pCamera;
-		g_pCamera = NULL;
-	}
-
-}
-
-/***********************************************************
- *  CreateDisplayWindow()
- *
- *  This method is used to create the main display window.
- ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
-{
-	GLFWwindow* window = nullptr;
-
-	// try to create the displayed OpenGL window
-	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
-		windowTitle,
-		NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return NULL;
-	}
-	glfwMakeContextCurrent(window);
-
-	// this callback is used to receive mouse moving events
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-
-	/////////
-
-		// tell GLFW to capture all mouse events
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-	// enable blending for supporting tranparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	m_pWindow = window;
-
-	return(window);
-}
-
-/***********************************************************
- *  Mouse_Position_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse is moved within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
-{
-	// when the first mouse move event is received, this needs to be recorded so that
-	// all subsequent mouse moves can correctly calculate the X position offset and Y
-	// position offset for proper operation
-	if (gFirstMouse)
-	{
-		gLastX = xMousePos;
-		gLastY = yMousePos;
-		gFirstMouse = false;
-	}
-
-	// calculate the X offset and Y offset values for moving the 3D camera accordingly
-	float xOffset = xMousePos - gLastX;
-	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
-
-	// set the current positions into the last position variables
-	gLastX = xMousePos;
-	gLastY = yMousePos;
-
-	// move the 3D camera according to the calculated offsets
-	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
-}
-
-void ViewManager::ProcessMouseScroll(double xOffset, double yOffset)
-{
-	// Check if the camera object exists
-	if (g_pCamera != nullptr)
-	{
-		// Log the original speed
-		std::cout << "Original Speed: " << g_pCamera->MovementSpeed << std::endl;
-
-		// Adjust the movement speed based on the scroll direction
-		if (yOffset > 0) // Scrolling up
-		{
-			g_pCamera->movementSpeedMultiplier *= 1.1; // Increase speed by 10%
-		}
-		if (yOffset < 0) // Scrolling down
-		{
-			g_pCamera->movementSpeedMultiplier *= 0.9; // Decrease speed by 10%
-		}
-
-
-		// Log the adjusted speed
-		std::cout << "Adjusted Speed: " << g_pCamera->MovementSpeed * g_pCamera->movementSpeedMultiplier << std::endl;
-	}
-}
-
-/***********************************************************
- *  ProcessKeyboardEvents()
- *
- *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
-{
-	// close the window if the escape key has been pressed
-	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(m_pWindow, true);
-	}
-
-	// if the camera object is null, then exit this method
-	if (NULL == g_pCamera)
-	{
-		return;
-	}
-
-	// Calculate the movement velocity
-	float velocity = g_pCamera->MovementSpeed * gDeltaTime * g_pCamera->movementSpeedMultiplier;
-
-	// process camera zooming in and out
-	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(FORWARD, velocity);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(BACKWARD, velocity);
-	}
-
-	// process camera panning left and right
-	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(LEFT, velocity);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(RIGHT, velocity);
-	}
-
-	// process camera movement up and down
-	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(UP, velocity);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(DOWN, velocity);
-	}
-
-	// Change between perspective and orthographic projections
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-	{
-		// Set perspective projection
-		m_pShaderManager->setMat4Value(g_ProjectionName, glm::perspective(glm::radians(g_pCamera->Zoom), (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT, 0.1f, 100.0f));
-
-		// Reset camera settings for perspective view
-		g_pCamera->Zoom = 80.0f;
-		g_pCamera->Position = glm::vec3(0.5f, 5.5f, 10.0f);
-		g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	}
-
-	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
-	{
-		// Set the viewport for the orthographic projection
-		glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
-
-		// Set orthographic projection
-		m_pShaderManager->setMat4Value(g_ProjectionName, glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 0.1f, 100.0f));
-
-		// Reset camera settings for orthographic view
-		g_pCamera->Zoom = 10.0f;
-		g_pCamera->Position = glm::vec3(0.0f, 0.0f, 80.0f);
-		g_pCamera->Front = glm::vec3(0.0f, 0.0f, -1.0f);
-		g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	}
-}
-
-/***********************************************************
- *  PrepareSceneView()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
- ***********************************************************/
-void ViewManager::PrepareSceneView()
-{
-	glm::mat4 view;
-	glm::mat4 projection;
-
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-	// define the current projection matrix
-	projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
-	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
-	}
-}
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewManager.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <GLFW/glfw3.h>
+
+// declaration of the global variables and defines
+namespace
+{
+	// Variables for window width and height
+	const int WINDOW_WIDTH = 1000;
+	const int WINDOW_HEIGHT = 800;
+	const char* g_ViewName = "view";
+	const char* g_ProjectionName = "projection";
+
+	// camera object used for viewing and interacting with
+	// the 3D scene
+	Camera* g_pCamera = nullptr;
+
+	// the camera is moved in steps of a fixed time, so it moves the
+	// same way at any frame rate, and falls behind by no more than
+	// the lag, after a long stall, rather than catching up on it
+	const double SIMULATION_TIMESTEP = 1.0 / 120.0;
+	const double MAX_SIMULATION_LAG = 0.25;
+
+	// if orthographic projection is on, this value will be
+	// true
+	bool bOrthographicProjection = false;
+}
+
+/***********************************************************
+ *  ViewManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewManager::ViewManager(
+	ShaderManager* pShaderManager,
+	UniformCache* pUniformCache)
+{
+	// initialize the member variables
+	m_pShaderManager = pShaderManager;
+	m_pUniformCache = pUniformCache;
+	m_viewUniform = -1;
+	m_projectionUniform = -1;
+	m_viewPositionUniform = -1;
+	if (NULL != m_pUniformCache)
+	{
+		m_viewUniform = m_pUniformCache->GetUniform(g_ViewName);
+		m_projectionUniform = m_pUniformCache->GetUniform(g_ProjectionName);
+		m_viewPositionUniform = m_pUniformCache->GetUniform("viewPosition");
+	}
+	m_pWindow = NULL;
+	m_viewMatrix = glm::mat4(1.0f);
+	m_projectionMatrix = glm::mat4(1.0f);
+	m_viewportWidth = WINDOW_WIDTH;
+	m_viewportHeight = WINDOW_HEIGHT;
+	m_lastMousePosition = glm::vec2(WINDOW_WIDTH / 2.0f, WINDOW_HEIGHT / 2.0f);
+	m_bFirstMouse = true;
+	m_unsentMouseOffset = glm::vec2(0.0f);
+	m_heldKeys = 0;
+	m_simulationTime = 0.0;
+	m_bSimulationStarted = false;
+	m_bRecording = false;
+	m_recordStartTime = 0.0;
+	m_pReplayPath = NULL;
+	m_replayTimestep = 0.0f;
+	m_replayFrame = 0;
+	g_pCamera = new Camera();
+	// default camera view parameters
+	g_pCamera->Position = glm::vec3(0.5f, 5.5f, 10.0f);
+	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+	m_previousCamera = GetCameraPose();
+	m_viewPosition = g_pCamera->Position;
+
+}
+
+/***********************************************************
+ *  ~ViewManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ViewManager::~ViewManager()
+{
+	// free up allocated memory
+	m_pShaderManager = NULL;
+	m_pUniformCache = NULL;
+	m_pWindow = NULL;
+	if (NULL != g_pCamera)
+	{
+		delete g_pCamera;
+		g_pCamera = NULL;
+	}
+
+}
+
+/***********************************************************
+ *  CreateDisplayWindow()
+ *
+ *  This method is used to create the main display window.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	// try to create the displayed OpenGL window
+	window = glfwCreateWindow(
+		WINDOW_WIDTH,
+		WINDOW_HEIGHT,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// the callbacks find the view manager through the window
+	glfwSetWindowUserPointer(window, this);
+
+	// this callback is used to receive mouse moving events
+	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+	// and this one to receive key presses and releases
+	glfwSetKeyCallback(window, &ViewManager::Key_Callback);
+
+	/////////
+
+		// tell GLFW to capture all mouse events
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+	// enable blending for supporting tranparent rendering
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  SetViewportSize()
+ *
+ *  This method is used for setting the size of the viewport
+ *  the scene is rendered into, which sets the aspect ratio
+ *  of the projection.  The display window keeps its own size.
+ ***********************************************************/
+void ViewManager::SetViewportSize(int width, int height)
+{
+	if ((width > 0) && (height > 0))
+	{
+		m_viewportWidth = width;
+		m_viewportHeight = height;
+	}
+}
+
+/***********************************************************
+ *  Mouse_Position_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse is moved within the active GLFW display window.
+ *  The movement is queued for the camera update.
+ ***********************************************************/
+void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
+{
+	ViewManager* pViewManager = (ViewManager*)glfwGetWindowUserPointer(window);
+	if (NULL == pViewManager)
+	{
+		return;
+	}
+
+	// when the first mouse move event is received, this needs to be recorded so that
+	// all subsequent mouse moves can correctly calculate the X position offset and Y
+	// position offset for proper operation
+	glm::vec2 mousePosition((float)xMousePos, (float)yMousePos);
+	if (pViewManager->m_bFirstMouse)
+	{
+		pViewManager->m_lastMousePosition = mousePosition;
+		pViewManager->m_bFirstMouse = false;
+	}
+
+	// calculate the X offset and Y offset values for moving the 3D camera accordingly,
+	// with Y reversed since y-coordinates go from bottom to top
+	pViewManager->m_unsentMouseOffset.x += mousePosition.x - pViewManager->m_lastMousePosition.x;
+	pViewManager->m_unsentMouseOffset.y += pViewManager->m_lastMousePosition.y - mousePosition.y;
+	pViewManager->m_lastMousePosition = mousePosition;
+
+	// movement that does not fit in a full queue is kept for the
+	// next event
+	InputQueue::INPUT_EVENT event = {};
+	event.type = InputQueue::MOUSE_MOVED;
+	event.mouseOffset = pViewManager->m_unsentMouseOffset;
+	pViewManager->PushInputEvent(event);
+}
+
+/***********************************************************
+ *  Key_Callback()
+ *
+ *  This method is automatically called from GLFW whenever a
+ *  key is pressed or released within the active GLFW display
+ *  window.  The camera keys going down and up, and the view
+ *  resets, are queued for the camera update.
+ ***********************************************************/
+void ViewManager::Key_Callback(GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/)
+{
+	ViewManager* pViewManager = (ViewManager*)glfwGetWindowUserPointer(window);
+	if ((NULL == pViewManager) || (GLFW_REPEAT == action))
+	{
+		return;
+	}
+
+	InputQueue::INPUT_EVENT event = {};
+	event.type = InputQueue::KEY_CHANGED;
+	event.bPressed = (GLFW_PRESS == action);
+
+	switch (key)
+	{
+	// close the window if the escape key has been pressed
+	case GLFW_KEY_ESCAPE:
+		if (event.bPressed)
+		{
+			glfwSetWindowShouldClose(window, true);
+		}
+		return;
+	// camera zooming in and out
+	case GLFW_KEY_W:
+		event.key = CameraPath::KEY_FORWARD;
+		break;
+	case GLFW_KEY_S:
+		event.key = CameraPath::KEY_BACKWARD;
+		break;
+	// camera panning left and right
+	case GLFW_KEY_A:
+		event.key = CameraPath::KEY_LEFT;
+		break;
+	case GLFW_KEY_D:
+		event.key = CameraPath::KEY_RIGHT;
+		break;
+	// camera movement up and down
+	case GLFW_KEY_Q:
+		event.key = CameraPath::KEY_UP;
+		break;
+	case GLFW_KEY_E:
+		event.key = CameraPath::KEY_DOWN;
+		break;
+	// change between perspective and orthographic projections
+	case GLFW_KEY_P:
+		event.type = InputQueue::PERSPECTIVE_VIEW;
+		break;
+	case GLFW_KEY_O:
+		event.type = InputQueue::ORTHOGRAPHIC_VIEW;
+		break;
+	default:
+		return;
+	}
+
+	// the view resets happen when the key goes down
+	if ((InputQueue::KEY_CHANGED != event.type) && !event.bPressed)
+	{
+		return;
+	}
+
+	pViewManager->PushInputEvent(event);
+}
+
+/***********************************************************
+ *  PushInputEvent()
+ *
+ *  This method is used for adding an input event to the
+ *  queue, with the time it happened.  Events are dropped
+ *  when the camera update falls far behind, except for the
+ *  mouse movement, which is added to the next event.
+ ***********************************************************/
+void ViewManager::PushInputEvent(InputQueue::INPUT_EVENT& event)
+{
+	event.time = glfwGetTime();
+
+	if (m_inputQueue.Push(event) && (InputQueue::MOUSE_MOVED == event.type))
+	{
+		m_unsentMouseOffset = glm::vec2(0.0f);
+	}
+}
+
+void ViewManager::ProcessMouseScroll(double xOffset, double yOffset)
+{
+	// Check if the camera object exists
+	if (g_pCamera != nullptr)
+	{
+		// Log the original speed
+		std::cout << "Original Speed: " << g_pCamera->MovementSpeed << std::endl;
+
+		// Adjust the movement speed based on the scroll direction
+		if (yOffset > 0) // Scrolling up
+		{
+			g_pCamera->movementSpeedMultiplier *= 1.1; // Increase speed by 10%
+		}
+		if (yOffset < 0) // Scrolling down
+		{
+			g_pCamera->movementSpeedMultiplier *= 0.9; // Decrease speed by 10%
+		}
+
+
+		// Log the adjusted speed
+		std::cout << "Adjusted Speed: " << g_pCamera->MovementSpeed * g_pCamera->movementSpeedMultiplier << std::endl;
+	}
+}
+
+/***********************************************************
+ *  ApplyInputEvents()
+ *
+ *  This method is used for taking the queued input events
+ *  that happened up to a time, in order.  The camera keys
+ *  are held down from their press to their release, the
+ *  mouse movement is added up, and the views are reset.
+ ***********************************************************/
+void ViewManager::ApplyInputEvents(double time, glm::vec2& mouseOffset)
+{
+	InputQueue::INPUT_EVENT event;
+
+	while (m_inputQueue.Peek(event) && (event.time <= time))
+	{
+		m_inputQueue.Pop();
+
+		switch (event.type)
+		{
+		case InputQueue::KEY_CHANGED:
+			if (event.bPressed)
+			{
+				m_heldKeys |= event.key;
+			}
+			else
+			{
+				m_heldKeys &= ~event.key;
+			}
+			break;
+		case InputQueue::MOUSE_MOVED:
+			mouseOffset += event.mouseOffset;
+			break;
+		case InputQueue::PERSPECTIVE_VIEW:
+			// Reset camera settings for perspective view
+			g_pCamera->Zoom = 80.0f;
+			g_pCamera->Position = glm::vec3(0.5f, 5.5f, 10.0f);
+			g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+			g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+			break;
+		case InputQueue::ORTHOGRAPHIC_VIEW:
+			// Reset camera settings for orthographic view
+			g_pCamera->Zoom = 10.0f;
+			g_pCamera->Position = glm::vec3(0.0f, 0.0f, 80.0f);
+			g_pCamera->Front = glm::vec3(0.0f, 0.0f, -1.0f);
+			g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+			break;
+		}
+	}
+}
+
+/***********************************************************
+ *  MoveCamera()
+ *
+ *  This method is used for moving the camera by the keys
+ *  held down, for one fixed time step, and by the mouse
+ *  movement.
+ ***********************************************************/
+void ViewManager::MoveCamera(float timestep, const glm::vec2& mouseOffset)
+{
+	// Calculate the movement velocity
+	float velocity = g_pCamera->MovementSpeed * timestep * g_pCamera->movementSpeedMultiplier;
+
+	if (m_heldKeys & CameraPath::KEY_FORWARD)
+	{
+		g_pCamera->ProcessKeyboard(FORWARD, velocity);
+	}
+	if (m_heldKeys & CameraPath::KEY_BACKWARD)
+	{
+		g_pCamera->ProcessKeyboard(BACKWARD, velocity);
+	}
+	if (m_heldKeys & CameraPath::KEY_LEFT)
+	{
+		g_pCamera->ProcessKeyboard(LEFT, velocity);
+	}
+	if (m_heldKeys & CameraPath::KEY_RIGHT)
+	{
+		g_pCamera->ProcessKeyboard(RIGHT, velocity);
+	}
+	if (m_heldKeys & CameraPath::KEY_UP)
+	{
+		g_pCamera->ProcessKeyboard(UP, velocity);
+	}
+	if (m_heldKeys & CameraPath::KEY_DOWN)
+	{
+		g_pCamera->ProcessKeyboard(DOWN, velocity);
+	}
+
+	// move the 3D camera according to the mouse offsets
+	if ((mouseOffset.x != 0.0f) || (mouseOffset.y != 0.0f))
+	{
+		g_pCamera->ProcessMouseMovement(mouseOffset.x, mouseOffset.y);
+	}
+}
+
+/***********************************************************
+ *  UpdateSimulation()
+ *
+ *  This method is used for moving the camera in fixed time
+ *  steps up to a time.  Each step applies the input events
+ *  that happened before its end, so the camera moves the
+ *  same way whatever the frame rate is.  The frame is drawn
+ *  from the camera blended between the last two steps, by
+ *  how far the time is into the next step, so that it moves
+ *  smoothly when frames and steps do not line up.
+ ***********************************************************/
+CameraPath::CAMERA_SAMPLE ViewManager::UpdateSimulation(double time)
+{
+	if (!m_bSimulationStarted)
+	{
+		m_simulationTime = time;
+		m_previousCamera = GetCameraPose();
+		m_bSimulationStarted = true;
+	}
+	if (time - m_simulationTime > MAX_SIMULATION_LAG)
+	{
+		m_simulationTime = time - MAX_SIMULATION_LAG;
+	}
+
+	while (m_simulationTime + SIMULATION_TIMESTEP <= time)
+	{
+		double stepEnd = m_simulationTime + SIMULATION_TIMESTEP;
+		glm::vec2 mouseOffset(0.0f);
+
+		m_previousCamera = GetCameraPose();
+		ApplyInputEvents(stepEnd, mouseOffset);
+		MoveCamera((float)SIMULATION_TIMESTEP, mouseOffset);
+		m_simulationTime = stepEnd;
+
+		if (m_bRecording)
+		{
+			RecordCamera(stepEnd, mouseOffset);
+		}
+	}
+
+	float amount = (float)((time - m_simulationTime) / SIMULATION_TIMESTEP);
+	return(CameraPath::BlendCamera(m_previousCamera, GetCameraPose(), amount));
+}
+
+/***********************************************************
+ *  GetCameraPose()
+ *
+ *  This method is used for getting the position, directions
+ *  and zoom of the camera.
+ ***********************************************************/
+CameraPath::CAMERA_SAMPLE ViewManager::GetCameraPose() const
+{
+	CameraPath::CAMERA_SAMPLE pose = {};
+	pose.position = g_pCamera->Position;
+	pose.front = g_pCamera->Front;
+	pose.up = g_pCamera->Up;
+	pose.zoom = g_pCamera->Zoom;
+
+	return(pose);
+}
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering
+ ***********************************************************/
+void ViewManager::PrepareSceneView()
+{
+	UpdateCamera();
+	SetViewUniforms(m_viewMatrix, m_projectionMatrix, m_viewPosition);
+}
+
+/***********************************************************
+ *  UpdateCamera()
+ *
+ *  This method is used for moving the camera for the next
+ *  frame and building its view and projection matrices.  It
+ *  makes no OpenGL or window calls, so it can run on another
+ *  thread than the display window, as long as it stays on
+ *  one thread.
+ ***********************************************************/
+void ViewManager::UpdateCamera()
+{
+	CameraPath::CAMERA_SAMPLE camera;
+
+	// a replayed path moves the camera by a fixed time step each
+	// frame, so it goes through the same poses at any frame rate,
+	// and the input is dropped
+	if (IsReplaying())
+	{
+		InputQueue::INPUT_EVENT event;
+		while (m_inputQueue.Peek(event))
+		{
+			m_inputQueue.Pop();
+		}
+
+		ReplayCamera();
+		camera = GetCameraPose();
+	}
+	// otherwise the camera is only moved from the keyboard and mouse
+	// of the display window, so without one it keeps its place
+	else if (NULL != m_pWindow)
+	{
+		camera = UpdateSimulation(glfwGetTime());
+	}
+	else
+	{
+		camera = GetCameraPose();
+	}
+
+	// get the current view matrix from the camera
+	m_viewMatrix = glm::lookAt(camera.position, camera.position + camera.front, camera.up);
+	m_viewPosition = camera.position;
+
+	// define the current projection matrix
+	m_projectionMatrix = glm::perspective(glm::radians(camera.zoom), (GLfloat)m_viewportWidth / (GLfloat)m_viewportHeight, 0.1f, 100.0f);
+}
+
+/***********************************************************
+ *  SetViewUniforms()
+ *
+ *  This method is used for setting the view and projection
+ *  matrices and the camera position into the shader.
+ ***********************************************************/
+void ViewManager::SetViewUniforms(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition)
+{
+	// if the uniform cache object is valid
+	if (NULL != m_pUniformCache)
+	{
+		// set the view matrix into the shader for proper rendering
+		m_pUniformCache->SetMat4Value(m_viewUniform, view);
+		// set the view matrix into the shader for proper rendering
+		m_pUniformCache->SetMat4Value(m_projectionUniform, projection);
+		// set the view position of the camera into the shader for proper rendering
+		m_pUniformCache->SetVec3Value(m_viewPositionUniform, viewPosition);
+	}
+}
+
+/***********************************************************
+ *  StartRecording()
+ *
+ *  This method is used for starting to record the camera of
+ *  each update step into a path, with the time since
+ *  recording started.
+ ***********************************************************/
+void ViewManager::StartRecording()
+{
+	m_recordedPath.Clear();
+	m_recordStartTime = glfwGetTime();
+	m_bRecording = true;
+}
+
+/***********************************************************
+ *  SaveRecording()
+ *
+ *  This method is used for saving the recorded path to a
+ *  file, which can be replayed later.
+ ***********************************************************/
+bool ViewManager::SaveRecording(const std::string& path) const
+{
+	if (m_recordedPath.GetSamples().empty())
+	{
+		std::cout << "ERROR: No camera path was recorded" << std::endl;
+		return(false);
+	}
+
+	return(m_recordedPath.Save(path));
+}
+
+/***********************************************************
+ *  RecordCamera()
+ *
+ *  This method is used for adding the camera of the last
+ *  update step to the recorded path, along with the keys and
+ *  the mouse movement that moved it there.
+ ***********************************************************/
+void ViewManager::RecordCamera(double time, const glm::vec2& mouseOffset)
+{
+	CameraPath::CAMERA_SAMPLE sample = GetCameraPose();
+	sample.time = (float)(time - m_recordStartTime);
+	sample.keys = m_heldKeys;
+	sample.mouseOffset = mouseOffset;
+	m_recordedPath.AddSample(sample);
+}
+
+/***********************************************************
+ *  StartReplay()
+ *
+ *  This method is used for replaying the camera from a path,
+ *  starting with its first sample on the next frame.  The
+ *  path must stay loaded until the replay finishes.
+ ***********************************************************/
+void ViewManager::StartReplay(const CameraPath* pPath, float timestep)
+{
+	if ((NULL == pPath) || (timestep <= 0.0f))
+	{
+		m_pReplayPath = NULL;
+		return;
+	}
+
+	m_pReplayPath = pPath;
+	m_replayTimestep = timestep;
+	m_replayFrame = 0;
+}
+
+/***********************************************************
+ *  IsReplayFinished()
+ *
+ *  This method is used for checking whether every frame of
+ *  the replayed path has been shown.
+ ***********************************************************/
+bool ViewManager::IsReplayFinished() const
+{
+	return(IsReplaying() && (m_replayFrame >= m_pReplayPath->GetFrameCount(m_replayTimestep)));
+}
+
+/***********************************************************
+ *  ReplayCamera()
+ *
+ *  This method is used for moving the camera to where the
+ *  replayed path has it on the next frame.  The frame's time
+ *  is counted in fixed steps from the start, rather than
+ *  taken from the clock, so each frame shows the same pose
+ *  on every run.
+ ***********************************************************/
+void ViewManager::ReplayCamera()
+{
+	SetCamera(m_pReplayPath->GetCamera(m_replayFrame * m_replayTimestep));
+
+	m_replayFrame++;
+}
+
+/***********************************************************
+ *  SetCamera()
+ *
+ *  This method is used for moving the camera to a pose.  The
+ *  camera keeps it until it is moved again, since it is not
+ *  moved at all without a display window.
+ ***********************************************************/
+void ViewManager::SetCamera(const CameraPath::CAMERA_SAMPLE& camera)
+{
+	g_pCamera->Position = camera.position;
+	g_pCamera->Front = camera.front;
+	g_pCamera->Up = camera.up;
+	g_pCamera->Zoom = camera.zoom;
+}
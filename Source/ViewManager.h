@@ -1,52 +1,138 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "camera.h"
-
-// GLFW library
-#include "GLFW/glfw3.h" 
-
-class ViewManager
-{
-public:
-	// constructor
-	ViewManager(
-		ShaderManager* pShaderManager);
-	// destructor
-	~ViewManager();
-
-	// mouse position callback for mouse interaction with the 3D scene
-	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
-
-	/***********************************************************
- *  ProcessMouseScroll()
- *
- *  This method is used for processing the mouse scroll
- *  events
- ***********************************************************/
-	void ProcessMouseScroll(double xOffset, double yOffset);
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
-	GLFWwindow* m_pWindow;
-
-	// process keyboard events for interaction with the 3D scene
-	void ProcessKeyboardEvents();
-
-public:
-	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
-
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "UniformCache.h"
+#include "CameraPath.h"
+#include "InputQueue.h"
+#include "camera.h"
+
+// GLFW library
+#include "GLFW/glfw3.h" 
+
+class ViewManager
+{
+public:
+	// constructor
+	ViewManager(
+		ShaderManager* pShaderManager,
+		UniformCache* pUniformCache);
+	// destructor
+	~ViewManager();
+
+	// mouse position callback for mouse interaction with the 3D scene
+	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
+	// key callback for keyboard interaction with the 3D scene
+	static void Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+
+	/***********************************************************
+ *  ProcessMouseScroll()
+ *
+ *  This method is used for processing the mouse scroll
+ *  events
+ ***********************************************************/
+	void ProcessMouseScroll(double xOffset, double yOffset);
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to the uniform cache that sets the shader values
+	UniformCache* m_pUniformCache;
+	// handles of the view uniforms
+	int m_viewUniform;
+	int m_projectionUniform;
+	int m_viewPositionUniform;
+	// active OpenGL display window
+	GLFWwindow* m_pWindow;
+	// view and projection matrices of the current frame
+	glm::mat4 m_viewMatrix;
+	glm::mat4 m_projectionMatrix;
+	// size of the viewport the scene is rendered into
+	int m_viewportWidth;
+	int m_viewportHeight;
+	// input events of the display window, pushed by the callbacks
+	// and taken by the camera update
+	InputQueue m_inputQueue;
+	// last mouse position, and mouse movement not yet pushed, which
+	// only the callbacks use
+	glm::vec2 m_lastMousePosition;
+	bool m_bFirstMouse;
+	glm::vec2 m_unsentMouseOffset;
+	// camera keys held down, as of the last update step
+	uint32_t m_heldKeys;
+	// time the camera has been updated up to, in fixed steps
+	double m_simulationTime;
+	bool m_bSimulationStarted;
+	// camera before the last update step, which the frames blend
+	// from toward the camera after it
+	CameraPath::CAMERA_SAMPLE m_previousCamera;
+	// camera position of the current frame
+	glm::vec3 m_viewPosition;
+	// path the camera is recorded into, and when recording started
+	CameraPath m_recordedPath;
+	bool m_bRecording;
+	double m_recordStartTime;
+	// path the camera is replayed from, the fixed time between
+	// its frames, and the next frame
+	const CameraPath* m_pReplayPath;
+	float m_replayTimestep;
+	int m_replayFrame;
+
+	// add an input event with the current time to the queue
+	void PushInputEvent(InputQueue::INPUT_EVENT& event);
+	// update the camera in fixed steps up to a time, and get the
+	// camera blended between the last two steps at that time
+	CameraPath::CAMERA_SAMPLE UpdateSimulation(double time);
+	// apply the queued input events up to a time, adding up the
+	// mouse movement
+	void ApplyInputEvents(double time, glm::vec2& mouseOffset);
+	// move the camera by the keys held down for one step, and by
+	// the mouse movement
+	void MoveCamera(float timestep, const glm::vec2& mouseOffset);
+	// get the pose of the camera
+	CameraPath::CAMERA_SAMPLE GetCameraPose() const;
+	// add the camera of the last update step to the recorded path
+	void RecordCamera(double time, const glm::vec2& mouseOffset);
+	// move the camera to the next frame of the replayed path
+	void ReplayCamera();
+
+public:
+	// create the initial OpenGL display window
+	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+	// set the size of the viewport, when rendering without the window
+	void SetViewportSize(int width, int height);
+
+	// record the camera into a path, from the next frame on
+	void StartRecording();
+	// save the recorded path to a file
+	bool SaveRecording(const std::string& path) const;
+	// replay the camera from a path, one fixed time step per frame,
+	// in place of the keyboard and mouse
+	void StartReplay(const CameraPath* pPath, float timestep);
+	// check whether a path is replaying, and whether it has finished
+	bool IsReplaying() const { return NULL != m_pReplayPath; }
+	bool IsReplayFinished() const;
+	// move the camera to a pose, such as a sample of a path
+	void SetCamera(const CameraPath::CAMERA_SAMPLE& camera);
+
+	// prepare the conversion from 3D object display to 2D scene display
+	void PrepareSceneView();
+	// move the camera by the queued input, or along the replayed
+	// path, and build the view and projection matrices, without
+	// OpenGL calls
+	void UpdateCamera();
+	// set the view and projection into the shader
+	void SetViewUniforms(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& viewPosition);
+	// get the position of the camera in the current frame
+	glm::vec3 GetViewPosition() const { return m_viewPosition; }
+	// get the view and projection matrices of the current frame
+	const glm::mat4& GetViewMatrix() const { return m_viewMatrix; }
+	const glm::mat4& GetProjectionMatrix() const { return m_projectionMatrix; }
 };
\ No newline at end of file
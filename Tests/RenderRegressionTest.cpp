@@ -0,0 +1,514 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderregressiontest.cpp
+// ============
+// check that the desk scene still renders the same, and fast enough
+//
+// The scene is rendered offscreen from the fixed camera poses in
+// Tests/RegressionPoses.campath, with every way of drawing it that the
+// OpenGL implementation supports.  Each image is compared to the stored
+// reference image of its pose, and the median frame time of each pose to
+// its stored budget.  It runs from the project folder, for example:
+//
+//   RenderRegressionTest [--update] [--output-dir <folder>]
+//
+// --update renders new reference images and budgets in place of the
+// stored ones.  With --output-dir, the image of every pose that does not
+// match is written there, to be compared by eye.  The budgets can be
+// scaled for slower machines with the RENDER_TEST_BUDGET_SCALE variable.
+//
+// The test returns 77, which CTest reports as skipped, when there are no
+// reference images or no OpenGL context can be created.
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include <GL/glew.h>
+
+#include "OffscreenContext.h"
+#include "FrameTimings.h"
+#include "CameraPath.h"
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ShaderManager.h"
+#include "UniformCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// exit code that CTest reports as a skipped test
+	const int EXIT_SKIPPED = 77;
+
+	// files the test reads and writes
+	const char* const g_PosesPath = "Tests/RegressionPoses.campath";
+	const char* const g_ReferenceFolder = "Tests/Reference/";
+	const char* const g_BudgetsPath = "Tests/Reference/budgets.txt";
+
+	// size of the rendered images
+	const int IMAGE_WIDTH = 256;
+	const int IMAGE_HEIGHT = 192;
+
+	// frames rendered at each pose before it is timed, so that the
+	// levels of detail settle, and frames that are timed
+	const int WARMUP_FRAMES = 3;
+	const int TIMED_FRAMES = 9;
+
+	// a color difference, in CIE76 delta E, that is easy to see,
+	// where 2.3 is about the smallest that can be seen at all
+	const float VISIBLE_DIFFERENCE = 6.0f;
+	// share of the pixels that may differ visibly, for edges that
+	// move a pixel between OpenGL implementations
+	const double ALLOWED_DIFFERENT_PIXELS = 0.002;
+	// budgets written by --update, as a multiple of the time measured
+	const double BUDGET_HEADROOM = 2.5;
+	// smallest budget written, for poses that draw next to nothing
+	const double MINIMUM_BUDGET = 5.0;
+
+	struct IMAGE
+	{
+		int width;
+		int height;
+		// rows of RGB bytes, from the top
+		std::vector<unsigned char> pixels;
+	};
+
+	struct COMPARISON
+	{
+		double differentShare;
+		double meanDifference;
+	};
+
+	/***********************************************************
+	 *  GetReferencePath()
+	 *
+	 *  This function is used for getting the file path of the
+	 *  reference image of a pose.
+	 ***********************************************************/
+	std::string GetReferencePath(size_t pose)
+	{
+		return(std::string(g_ReferenceFolder) + "pose" + std::to_string(pose) + ".ppm");
+	}
+
+	/***********************************************************
+	 *  ReadImage()
+	 *
+	 *  This function is used for reading a binary PPM image.
+	 ***********************************************************/
+	bool ReadImage(const std::string& path, IMAGE& image)
+	{
+		std::ifstream file(path, std::ios::binary);
+		std::string magic;
+		int maximum = 0;
+
+		if (!(file >> magic) || (magic != "P6") ||
+			!(file >> image.width >> image.height >> maximum) || (maximum != 255) ||
+			(image.width <= 0) || (image.height <= 0))
+		{
+			return(false);
+		}
+		file.get();
+
+		image.pixels.resize((size_t)image.width * image.height * 3);
+		file.read((char*)image.pixels.data(), image.pixels.size());
+
+		return(file.gcount() == (std::streamsize)image.pixels.size());
+	}
+
+	/***********************************************************
+	 *  WriteImage()
+	 *
+	 *  This function is used for writing a binary PPM image.
+	 ***********************************************************/
+	bool WriteImage(const std::string& path, const IMAGE& image)
+	{
+		std::ofstream file(path, std::ios::binary);
+		if (!file)
+		{
+			std::cout << "ERROR: The image could not be written to " << path << std::endl;
+			return(false);
+		}
+
+		file << "P6\n" << image.width << " " << image.height << "\n255\n";
+		file.write((const char*)image.pixels.data(), image.pixels.size());
+
+		return(file.good());
+	}
+
+	/***********************************************************
+	 *  ConvertToLab()
+	 *
+	 *  This function is used for converting an sRGB color to
+	 *  CIE L*a*b*, where the distance between two colors is
+	 *  close to how different they look.
+	 ***********************************************************/
+	glm::vec3 ConvertToLab(const unsigned char* rgb)
+	{
+		float linear[3];
+		for (int i = 0; i < 3; i++)
+		{
+			float value = rgb[i] / 255.0f;
+			linear[i] = (value <= 0.04045f) ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		// XYZ relative to the D65 white point
+		float xyz[3] =
+		{
+			(0.4124f * linear[0] + 0.3576f * linear[1] + 0.1805f * linear[2]) / 0.95047f,
+			(0.2126f * linear[0] + 0.7152f * linear[1] + 0.0722f * linear[2]),
+			(0.0193f * linear[0] + 0.1192f * linear[1] + 0.9505f * linear[2]) / 1.08883f
+		};
+		for (int i = 0; i < 3; i++)
+		{
+			xyz[i] = (xyz[i] > 0.008856f) ? std::cbrt(xyz[i]) : (7.787f * xyz[i] + 16.0f / 116.0f);
+		}
+
+		return(glm::vec3(116.0f * xyz[1] - 16.0f, 500.0f * (xyz[0] - xyz[1]), 200.0f * (xyz[1] - xyz[2])));
+	}
+
+	/***********************************************************
+	 *  CompareImages()
+	 *
+	 *  This function is used for comparing an image to its
+	 *  reference.  A pixel only counts as different when no
+	 *  reference pixel next to it is close in color either, so
+	 *  edges that move by a pixel are not counted.
+	 ***********************************************************/
+	COMPARISON CompareImages(const IMAGE& reference, const IMAGE& image)
+	{
+		COMPARISON comparison;
+		comparison.differentShare = 1.0;
+		comparison.meanDifference = 0.0;
+
+		if ((reference.width != image.width) || (reference.height != image.height))
+		{
+			return(comparison);
+		}
+
+		std::vector<glm::vec3> referenceLab((size_t)reference.width * reference.height);
+		for (size_t i = 0; i < referenceLab.size(); i++)
+		{
+			referenceLab[i] = ConvertToLab(&reference.pixels[i * 3]);
+		}
+
+		size_t differentCount = 0;
+		double totalDifference = 0.0;
+		for (int y = 0; y < image.height; y++)
+		{
+			for (int x = 0; x < image.width; x++)
+			{
+				size_t index = (size_t)y * image.width + x;
+				glm::vec3 lab = ConvertToLab(&image.pixels[index * 3]);
+				float difference = glm::length(lab - referenceLab[index]);
+				totalDifference += difference;
+
+				float nearestDifference = difference;
+				for (int nearY = std::max(y - 1, 0); nearY <= std::min(y + 1, image.height - 1); nearY++)
+				{
+					for (int nearX = std::max(x - 1, 0); nearX <= std::min(x + 1, image.width - 1); nearX++)
+					{
+						nearestDifference = std::min(nearestDifference,
+							glm::length(lab - referenceLab[(size_t)nearY * image.width + nearX]));
+					}
+				}
+				if (nearestDifference > VISIBLE_DIFFERENCE)
+				{
+					differentCount++;
+				}
+			}
+		}
+
+		comparison.differentShare = (double)differentCount / (double)referenceLab.size();
+		comparison.meanDifference = totalDifference / (double)referenceLab.size();
+		return(comparison);
+	}
+
+	/***********************************************************
+	 *  ReadBudgets()
+	 *
+	 *  This function is used for reading the frame time budget
+	 *  of each pose, in milliseconds, from lines of
+	 *  "budget <pose> <milliseconds>".
+	 ***********************************************************/
+	bool ReadBudgets(std::vector<double>& budgets)
+	{
+		std::ifstream file(g_BudgetsPath);
+		if (!file)
+		{
+			return(false);
+		}
+
+		std::string lineText;
+		while (std::getline(file, lineText))
+		{
+			size_t comment = lineText.find('#');
+			if (comment != std::string::npos)
+			{
+				lineText.erase(comment);
+			}
+
+			std::istringstream line(lineText);
+			std::string keyword;
+			size_t pose = 0;
+			double milliseconds = 0.0;
+			if ((line >> keyword) && (keyword == "budget") && (line >> pose >> milliseconds))
+			{
+				if (pose >= budgets.size())
+				{
+					budgets.resize(pose + 1, 0.0);
+				}
+				budgets[pose] = milliseconds;
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  WriteBudgets()
+	 *
+	 *  This function is used for writing the frame time budget
+	 *  of each pose.
+	 ***********************************************************/
+	bool WriteBudgets(const std::vector<double>& budgets)
+	{
+		std::ofstream file(g_BudgetsPath);
+		if (!file)
+		{
+			std::cout << "ERROR: The budgets could not be written to " << g_BudgetsPath << std::endl;
+			return(false);
+		}
+
+		file << "# median frame time budget of each regression pose, in milliseconds,\n"
+			<< "# written by RenderRegressionTest --update with the software renderer\n";
+		for (size_t i = 0; i < budgets.size(); i++)
+		{
+			char line[64];
+			snprintf(line, sizeof(line), "budget %zu %.1f\n", i, budgets[i]);
+			file << line;
+		}
+
+		return(file.good());
+	}
+
+	/***********************************************************
+	 *  RenderPose()
+	 *
+	 *  This function is used for rendering the scene from a
+	 *  pose a number of times, timing the frames that follow
+	 *  the warmup ones, and reading back the last image.
+	 ***********************************************************/
+	double RenderPose(
+		OffscreenContext& offscreenContext,
+		ViewManager& viewManager,
+		SceneManager& sceneManager,
+		UniformCache& uniformCache,
+		const CameraPath::CAMERA_SAMPLE& pose,
+		IMAGE& image)
+	{
+		FrameTimings frameTimings;
+
+		viewManager.SetCamera(pose);
+		for (int frame = 0; frame < WARMUP_FRAMES + TIMED_FRAMES; frame++)
+		{
+			std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+
+			uniformCache.BeginFrame();
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+			viewManager.PrepareSceneView();
+			sceneManager.SetViewPosition(viewManager.GetViewPosition());
+			sceneManager.SetViewProjection(viewManager.GetProjectionMatrix() * viewManager.GetViewMatrix());
+			sceneManager.RenderScene();
+			glFinish();
+
+			if (frame >= WARMUP_FRAMES)
+			{
+				frameTimings.AddFrame(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+			}
+		}
+
+		std::vector<unsigned char> rgba;
+		offscreenContext.ReadPixels(rgba);
+		image.width = offscreenContext.GetWidth();
+		image.height = offscreenContext.GetHeight();
+		image.pixels.resize((size_t)image.width * image.height * 3);
+		for (size_t i = 0; i < (size_t)image.width * image.height; i++)
+		{
+			memcpy(&image.pixels[i * 3], &rgba[i * 4], 3);
+		}
+
+		return(frameTimings.GetPercentile(50.0));
+	}
+}
+
+/***********************************************************
+ *  main()
+ *
+ *  This function is the entry point of the test.  It returns
+ *  zero when every pose matches its reference image and
+ *  budget, one when any does not, and 77 when the test could
+ *  not run.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	bool bUpdate = false;
+	const char* outputFolder = NULL;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--update") == 0)
+		{
+			bUpdate = true;
+		}
+		else if ((strcmp(argv[i], "--output-dir") == 0) && (i + 1 < argc))
+		{
+			outputFolder = argv[++i];
+		}
+	}
+
+	double budgetScale = 1.0;
+	if (NULL != getenv("RENDER_TEST_BUDGET_SCALE"))
+	{
+		budgetScale = std::max(atof(getenv("RENDER_TEST_BUDGET_SCALE")), 0.0);
+	}
+
+	CameraPath poses;
+	if (poses.Load(g_PosesPath) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	std::vector<double> budgets;
+	if (!bUpdate)
+	{
+		IMAGE reference;
+		if ((ReadImage(GetReferencePath(0), reference) == false) || (ReadBudgets(budgets) == false))
+		{
+			std::cout << "SKIPPED: There are no reference images, run with --update to make them" << std::endl;
+			return(EXIT_SKIPPED);
+		}
+	}
+
+	OffscreenContext offscreenContext;
+	if (offscreenContext.CreateContext() == false)
+	{
+		std::cout << "SKIPPED: No OpenGL context could be created" << std::endl;
+		return(EXIT_SKIPPED);
+	}
+	glewExperimental = GL_TRUE;
+	if ((glewContextInit() != GLEW_OK) || (offscreenContext.CreateFramebuffer(IMAGE_WIDTH, IMAGE_HEIGHT) == false))
+	{
+		return(EXIT_FAILURE);
+	}
+	std::cout << "OpenGL " << glGetString(GL_VERSION) << ", " << glGetString(GL_RENDERER) << std::endl;
+
+	// the render state the program sets once, before its first frame
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glEnable(GL_DEPTH_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+
+	ShaderManager shaderManager;
+	UniformCache uniformCache;
+	ViewManager viewManager(&shaderManager, &uniformCache);
+	viewManager.SetViewportSize(IMAGE_WIDTH, IMAGE_HEIGHT);
+
+	shaderManager.LoadShaders("Shaders/vertexShader.glsl", "Shaders/fragmentShader.glsl");
+	shaderManager.use();
+	GLint programID = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+	uniformCache.SetProgram(programID);
+
+	// the texture cache is left off, so that the test neither
+	// reads nor writes anything outside of its own files
+	SceneManager sceneManager(&shaderManager, &uniformCache);
+	sceneManager.SetTextureCacheOptions(false, false);
+	sceneManager.PrepareScene();
+
+	// every way of drawing the scene has to render the same image
+	std::vector<bool> drawingModes(1, false);
+	if (!bUpdate)
+	{
+		sceneManager.SetIndirectDrawing(true);
+		if (sceneManager.IsIndirectDrawing())
+		{
+			drawingModes.push_back(true);
+		}
+	}
+
+	const std::vector<CameraPath::CAMERA_SAMPLE>& samples = poses.GetSamples();
+	int failureCount = 0;
+	for (size_t mode = 0; mode < drawingModes.size(); mode++)
+	{
+		sceneManager.SetIndirectDrawing(drawingModes[mode]);
+		const char* modeName = drawingModes[mode] ? "indirect" : "instanced";
+
+		for (size_t pose = 0; pose < samples.size(); pose++)
+		{
+			IMAGE image;
+			double milliseconds = RenderPose(offscreenContext, viewManager, sceneManager, uniformCache, samples[pose], image);
+
+			GLenum error = glGetError();
+			if (GL_NO_ERROR != error)
+			{
+				std::cout << "FAILED: pose " << pose << " " << modeName << " made OpenGL error 0x" << std::hex << error << std::dec << std::endl;
+				failureCount++;
+			}
+
+			if (bUpdate)
+			{
+				if (WriteImage(GetReferencePath(pose), image) == false)
+				{
+					return(EXIT_FAILURE);
+				}
+				budgets.push_back(std::max(std::ceil(milliseconds * BUDGET_HEADROOM), MINIMUM_BUDGET));
+				printf("pose %zu: %.2f ms, budget %.1f ms\n", pose, milliseconds, budgets.back());
+				continue;
+			}
+
+			IMAGE reference;
+			COMPARISON comparison = { 1.0, 0.0 };
+			if (ReadImage(GetReferencePath(pose), reference))
+			{
+				comparison = CompareImages(reference, image);
+			}
+			double budget = (pose < budgets.size()) ? budgets[pose] * budgetScale : 0.0;
+
+			bool bImagePassed = comparison.differentShare <= ALLOWED_DIFFERENT_PIXELS;
+			bool bTimePassed = (budget <= 0.0) || (milliseconds <= budget);
+			printf("%s: pose %zu %-9s %6.2f%% of pixels differ, mean delta E %.2f, %.2f ms of %.1f ms\n",
+				(bImagePassed && bTimePassed) ? "passed" : "FAILED",
+				pose, modeName, comparison.differentShare * 100.0, comparison.meanDifference, milliseconds, budget);
+
+			if (!bImagePassed)
+			{
+				failureCount++;
+				if (NULL != outputFolder)
+				{
+					WriteImage(std::string(outputFolder) + "/pose" + std::to_string(pose) + "_" + modeName + ".ppm", image);
+				}
+			}
+			if (!bTimePassed)
+			{
+				failureCount++;
+			}
+		}
+	}
+
+	if (bUpdate)
+	{
+		return(WriteBudgets(budgets) ? EXIT_SUCCESS : EXIT_FAILURE);
+	}
+
+	return((failureCount == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
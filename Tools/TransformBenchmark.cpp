@@ -0,0 +1,264 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformbenchmark.cpp
+// ============
+// compare building model matrices one at a time against the batch kernels
+//
+// The benchmark only needs glm and the two transform source files, for
+// example:
+//
+//   g++ -O2 -std=c++17 -ISource Tools/TransformBenchmark.cpp
+//       Source/TransformKernels.cpp Source/TransformHierarchy.cpp
+//
+//   TransformBenchmark [object count ...]
+//
+// With no object counts, 1000, 100000 and 1000000 objects are measured.
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformHierarchy.h"
+#include "TransformKernels.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// each measurement is repeated until it has run this long
+	const double g_MinimumSeconds = 0.25;
+	// and at least this many times
+	const int g_MinimumRuns = 3;
+
+	// the transform values, one array per component
+	struct TRANSFORM_DATA
+	{
+		std::vector<float> values[9];
+	};
+
+	struct TIMING
+	{
+		double bestNanoseconds;
+		double meanNanoseconds;
+	};
+
+	/***********************************************************
+	 *  MakeTransforms()
+	 *
+	 *  This function is used for filling the transform arrays
+	 *  with random values, the same values for every run.
+	 ***********************************************************/
+	void MakeTransforms(size_t count, TRANSFORM_DATA& data)
+	{
+		std::mt19937 random(330);
+		std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+		std::uniform_real_distribution<float> rotation(-360.0f, 360.0f);
+		std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+
+		for (int component = 0; component < 9; component++)
+		{
+			data.values[component].resize(count);
+		}
+		for (size_t i = 0; i < count; i++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				data.values[axis][i] = scale(random);
+				data.values[3 + axis][i] = rotation(random);
+				data.values[6 + axis][i] = position(random);
+			}
+		}
+	}
+
+	/***********************************************************
+	 *  GetArrays()
+	 *
+	 *  This function is used for getting the kernel input for
+	 *  the transform arrays.
+	 ***********************************************************/
+	TransformKernels::TRANSFORM_ARRAYS GetArrays(const TRANSFORM_DATA& data)
+	{
+		TransformKernels::TRANSFORM_ARRAYS arrays;
+		arrays.scaleX = data.values[0].data();
+		arrays.scaleY = data.values[1].data();
+		arrays.scaleZ = data.values[2].data();
+		arrays.rotationX = data.values[3].data();
+		arrays.rotationY = data.values[4].data();
+		arrays.rotationZ = data.values[5].data();
+		arrays.positionX = data.values[6].data();
+		arrays.positionY = data.values[7].data();
+		arrays.positionZ = data.values[8].data();
+		return(arrays);
+	}
+
+	/***********************************************************
+	 *  Measure()
+	 *
+	 *  This function is used for timing a function that builds
+	 *  the matrices of every object, in nanoseconds per object.
+	 ***********************************************************/
+	template <typename FUNCTION>
+	TIMING Measure(size_t count, FUNCTION function)
+	{
+		TIMING timing;
+		double totalSeconds = 0.0;
+		double bestSeconds = 1.0e30;
+		int runs = 0;
+
+		// one run to warm up the caches and the page tables
+		function();
+
+		while ((runs < g_MinimumRuns) || (totalSeconds < g_MinimumSeconds))
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			function();
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			totalSeconds += seconds;
+			bestSeconds = std::min(bestSeconds, seconds);
+			runs++;
+		}
+
+		timing.bestNanoseconds = bestSeconds * 1.0e9 / (double)count;
+		timing.meanNanoseconds = totalSeconds * 1.0e9 / (double)(count * runs);
+		return(timing);
+	}
+
+	/***********************************************************
+	 *  GetLargestError()
+	 *
+	 *  This function is used for getting the largest difference
+	 *  between two sets of matrices.
+	 ***********************************************************/
+	float GetLargestError(const std::vector<glm::mat4>& expected, const std::vector<glm::mat4>& actual)
+	{
+		float largestError = 0.0f;
+
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				for (int row = 0; row < 4; row++)
+				{
+					largestError = std::max(largestError, std::fabs(expected[i][column][row] - actual[i][column][row]));
+				}
+			}
+		}
+		return(largestError);
+	}
+
+	/***********************************************************
+	 *  RunBenchmark()
+	 *
+	 *  This function is used for measuring every way of building
+	 *  the matrices for one object count.  The first is the way
+	 *  TransformHierarchy::ComputeMatrix() builds them, one glm
+	 *  matrix product per object, which the others are compared
+	 *  to.
+	 ***********************************************************/
+	bool RunBenchmark(size_t count)
+	{
+		TRANSFORM_DATA data;
+		MakeTransforms(count, data);
+		TransformKernels::TRANSFORM_ARRAYS arrays = GetArrays(data);
+
+		std::vector<glm::mat4> expected(count);
+		std::vector<glm::mat4> actual(count);
+		bool bPassed = true;
+
+		TIMING baseline = Measure(count, [&]()
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				expected[i] = TransformHierarchy::ComputeMatrix(
+					glm::vec3(arrays.scaleX[i], arrays.scaleY[i], arrays.scaleZ[i]),
+					glm::vec3(arrays.rotationX[i], arrays.rotationY[i], arrays.rotationZ[i]),
+					glm::vec3(arrays.positionX[i], arrays.positionY[i], arrays.positionZ[i]));
+			}
+		});
+
+		printf("%10zu  %-18s %9.2f %9.2f %8s %10s\n", count, "glm per object", baseline.bestNanoseconds, baseline.meanNanoseconds, "1.00x", "-");
+
+		for (int kernel = 0; kernel < TransformKernels::KERNEL_TYPE_COUNT; kernel++)
+		{
+			if (TransformKernels::SetKernel((TransformKernels::KERNEL_TYPE)kernel) == false)
+			{
+				printf("%10zu  batch %-12s %9s\n", count, TransformKernels::GetKernelName((TransformKernels::KERNEL_TYPE)kernel), "not supported");
+				continue;
+			}
+
+			std::fill(actual.begin(), actual.end(), glm::mat4(0.0f));
+			TIMING timing = Measure(count, [&]()
+			{
+				TransformKernels::BuildMatrices(arrays, 0, count, actual.data());
+			});
+
+			// the SIMD sine and cosine are a little less exact than the
+			// library ones, but far below anything that can be seen
+			float largestError = GetLargestError(expected, actual);
+			if (largestError > 1.0e-3f)
+			{
+				bPassed = false;
+			}
+
+			char speedup[32];
+			snprintf(speedup, sizeof(speedup), "%.2fx", baseline.bestNanoseconds / timing.bestNanoseconds);
+			printf("%10zu  batch %-12s %9.2f %9.2f %8s %10.2e\n",
+				count, TransformKernels::GetKernelName((TransformKernels::KERNEL_TYPE)kernel),
+				timing.bestNanoseconds, timing.meanNanoseconds, speedup, largestError);
+		}
+
+		return(bPassed);
+	}
+}
+
+/***********************************************************
+ *  main()
+ *
+ *  This function is the entry point of the benchmark.  It
+ *  returns an error code when a kernel builds different
+ *  matrices than glm does.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	std::vector<size_t> counts;
+	for (int i = 1; i < argc; i++)
+	{
+		long long count = atoll(argv[i]);
+		if (count > 0)
+		{
+			counts.push_back((size_t)count);
+		}
+	}
+	if (counts.empty())
+	{
+		counts.push_back(1000);
+		counts.push_back(100000);
+		counts.push_back(1000000);
+	}
+
+	TransformKernels::KERNEL_TYPE bestKernel = TransformKernels::GetKernel();
+	printf("best supported kernel: %s\n\n", TransformKernels::GetKernelName(bestKernel));
+	printf("%10s  %-18s %9s %9s %8s %10s\n", "objects", "method", "best ns", "mean ns", "speedup", "max error");
+
+	bool bPassed = true;
+	for (size_t i = 0; i < counts.size(); i++)
+	{
+		bPassed = RunBenchmark(counts[i]) && bPassed;
+	}
+
+	TransformKernels::SetKernel(bestKernel);
+
+	if (bPassed == false)
+	{
+		printf("\nA kernel built matrices that do not match glm\n");
+		return(1);
+	}
+
+	return(0);
+}